@@ -0,0 +1,249 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "location/location.h"
+
+/* Headless location batch processing class.
+ * Input file consists of floor plans:
+ *   plan <name>
+ *   polygon <points count>
+ *   <x> <y>
+ *   ...
+ * Lines starting with '#' are comments. Every polygon is placed through location editor
+ * functions (points snapping to existing points and walls), closed polygons are merged with
+ * walls, then walls are triangulated. Results and stages timings are written for each plan.
+ * Plans are independent, so they are processed concurrently by own locations, results are written in plans order.
+ */
+class location_batch
+{
+private:
+  /* Floor plan description. */
+  struct plan
+  {
+    std::string Name;                        // Plan name
+    std::vector<std::vector<vec2>> Polygons; // Polygons outlines
+  }; /* end of 'plan' struct */
+
+  /* Stages timings. */
+  struct timings
+  {
+    DBL Snap = 0, Merge = 0, Triangulate = 0; // Stages times in milliseconds
+  }; /* end of 'timings' struct */
+
+  /* Floor plan processing location class. */
+  class processor : private location
+  {
+  public:
+    /* Process one plan function.
+     * ARGUMENTS:
+     *   - plan to process:
+     *       const plan &Plan;
+     *   - stream to write results to:
+     *       std::ostream &Out;
+     *   - variable to set stages timings in:
+     *       timings *Time;
+     * RETURNS: None.
+     */
+    VOID Process( const plan &Plan, std::ostream &Out, timings *Time )
+    {
+      timings time;
+      std::vector<size_t> triangles;
+
+      for (const std::vector<vec2> &polly : Plan.Polygons)
+      {
+        if (polly.size() < 3)
+          continue;
+
+        // All but closing segments: points are snapped to existing points and walls
+        auto start = std::chrono::steady_clock::now();
+        BOOL is_closed = FALSE;
+        for (size_t i = 1; i < polly.size() && !is_closed; i++)
+          is_closed = CurrPolyPlaceSegment(polly[i], polly[i - 1]);
+        time.Snap += GetTime(start);
+
+        // Closing segment: polygon is merged with walls
+        start = std::chrono::steady_clock::now();
+        if (!is_closed)
+          CurrPolyPlaceSegment(polly[0], polly.back());
+        time.Merge += GetTime(start);
+
+        // Polygon was not closed by its first point, drop it
+        while (CurrPolyIsEditing())
+          CurrPolyDestroyLastSegment();
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      BOOL is_valid = TriangulateWalls(&triangles);
+      time.Triangulate = GetTime(start);
+
+      // Results
+      const points_pool &pool = GetPointsPool();
+      Out << "plan " << Plan.Name << "\n";
+      Out << "points " << pool.Size() << "\n";
+      for (size_t i = 0; i < pool.Size(); i++)
+        Out << pool[i][0] << " " << pool[i][1] << "\n";
+      Out << "walls " << Walls.size() << "\n";
+      for (const polygon &wall : Walls)
+      {
+        Out << "polygon " << wall.Lines.size() << "\n";
+        for (const segment &seg : wall.Lines)
+          Out << seg.St << " " << seg.End << "\n";
+      }
+      Out << "triangles " << triangles.size() / 3 << (is_valid ? "" : " crossing") << "\n";
+      for (size_t i = 0; i < triangles.size(); i += 3)
+        Out << triangles[i] << " " << triangles[i + 1] << " " << triangles[i + 2] << "\n";
+      Out << "timings snap " << time.Snap << " merge " << time.Merge << " triangulate " << time.Triangulate << "\n";
+
+      *Time = time;
+    } /* End of 'Process' function */
+  }; /* end of 'processor' class */
+
+  std::vector<plan> Plans; // Loaded plans
+
+  /* Get milliseconds since time point function.
+   * ARGUMENTS:
+   *   - time point:
+   *       const std::chrono::steady_clock::time_point &Start;
+   * RETURNS:
+   *   (DBL) milliseconds.
+   */
+  static DBL GetTime( const std::chrono::steady_clock::time_point &Start )
+  {
+    return std::chrono::duration<DBL, std::milli>(std::chrono::steady_clock::now() - Start).count();
+  } /* End of 'GetTime' function */
+
+  /* Load plans from file function.
+   * ARGUMENTS:
+   *   - file name:
+   *       const std::string &FileName;
+   * RETURNS:
+   *   (BOOL) whether file loaded.
+   */
+  BOOL Load( const std::string &FileName )
+  {
+    std::ifstream file(FileName);
+    if (!file)
+    {
+      std::cerr << "Can not open '" << FileName << "'\n";
+      return FALSE;
+    }
+
+    std::string line, word;
+    INT line_no = 0;
+    while (std::getline(file, line))
+    {
+      std::istringstream stream(line);
+
+      line_no++;
+      if (!(stream >> word) || word[0] == '#')
+        continue;
+
+      if (word == "plan")
+      {
+        Plans.push_back(plan());
+        stream >> Plans.back().Name;
+      }
+      else if (word == "polygon" && !Plans.empty())
+      {
+        INT cnt = 0;
+
+        stream >> cnt;
+        Plans.back().Polygons.push_back(std::vector<vec2>());
+
+        std::vector<vec2> &polly = Plans.back().Polygons.back();
+        for (INT i = 0; i < cnt && std::getline(file, line); i++)
+        {
+          FLT x, y;
+
+          line_no++;
+          if (!(std::istringstream(line) >> x >> y))
+          {
+            std::cerr << FileName << "(" << line_no << "): bad point\n";
+            return FALSE;
+          }
+          polly.push_back(vec2(x, y));
+        }
+      }
+      else
+      {
+        std::cerr << FileName << "(" << line_no << "): unexpected '" << word << "'\n";
+        return FALSE;
+      }
+    }
+    return TRUE;
+  } /* End of 'Load' function */
+
+public:
+  /* Run batch processing function.
+   * ARGUMENTS:
+   *   - console params:
+   *       INT argc, char *argv[];
+   * RETURNS:
+   *   (INT) programm end code.
+   */
+  INT Run( INT argc, char *argv[] )
+  {
+    if (argc < 2)
+    {
+      std::cerr << "Usage: " << argv[0] << " <input file> [<output file>]\n";
+      return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!Load(argv[1]))
+      return 1;
+    DBL load_time = GetTime(start);
+
+    std::ofstream file;
+    if (argc > 2)
+    {
+      file.open(argv[2]);
+      if (!file)
+      {
+        std::cerr << "Can not open '" << argv[2] << "'\n";
+        return 1;
+      }
+    }
+    std::ostream &out = argc > 2 ? file : std::cout;
+
+    std::vector<std::ostringstream> results(Plans.size());
+    std::vector<timings> times(Plans.size());
+    thread_pool threads;
+
+    threads.For(Plans.size(), [&]( size_t Index )
+      {
+        processor proc;
+
+        proc.Process(Plans[Index], results[Index], &times[Index]);
+      });
+
+    timings total;
+    for (size_t i = 0; i < Plans.size(); i++)
+    {
+      out << results[i].str();
+      total.Snap += times[i].Snap;
+      total.Merge += times[i].Merge;
+      total.Triangulate += times[i].Triangulate;
+    }
+
+    std::cerr << "plans " << Plans.size() << ", load " << load_time << " ms, snap " << total.Snap <<
+      " ms, merge " << total.Merge << " ms, triangulate " << total.Triangulate << " ms, total " << GetTime(start) << " ms\n";
+    return 0;
+  } /* End of 'Run' function */
+}; /* end of 'location_batch' class */
+
+/* Main programm function.
+ * ARGUMENTS:
+ *   - console params:
+ *       INT argc, char *argv[];
+ * RETURNS:
+ *   (INT) prgoramm end code.
+ */
+INT main( INT argc, char *argv[] )
+{
+  location_batch batch;
+
+  return batch.Run(argc, argv);
+} /* End of 'main' function. */
@@ -0,0 +1,263 @@
+#ifndef __bench_h_
+#define __bench_h_
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+#include "../def.h"
+
+// Heap allocations counter, global operator new of benchmarks executable (bench_alloc.cpp) increments it
+extern std::atomic<UINT64> BenchAllocations;
+
+/* Micro benchmarks runner class.
+ * Every benchmark is registered with set of sizes and setup function, which prepares
+ * data of given size (untimed) and returns operation to measure. Operation is repeated
+ * with doubling iterations count until minimal time is reached.
+ */
+class bench
+{
+public:
+  /* Measured operation. */
+  using operation = std::function<VOID ( VOID )>;
+
+  /* Benchmark setup function. Gets size, sets items processed by one operation call. */
+  using setup = std::function<operation ( size_t Size, size_t *Items )>;
+
+private:
+  /* Registered benchmark. */
+  struct entry
+  {
+    std::string Name;          // Benchmark name
+    std::vector<size_t> Sizes; // Sizes to run benchmark with
+    setup Setup;               // Setup function
+  }; /* end of 'entry' struct */
+
+  /* Benchmark result. */
+  struct result
+  {
+    std::string Name;      // Benchmark name with size
+    UINT64 Iterations;     // Operation calls count
+    DBL NsPerOp;           // Nanoseconds per operation call
+    DBL AllocsPerOp;       // Heap allocations per operation call
+    DBL ItemsPerSecond;    // Throughput
+  }; /* end of 'result' struct */
+
+  std::vector<entry> Entries; // Registered benchmarks
+
+  /* Run one benchmark function.
+   * ARGUMENTS:
+   *   - benchmark name:
+   *       const std::string &Name;
+   *   - operation to measure:
+   *       const operation &Op;
+   *   - items processed by one operation call:
+   *       size_t Items;
+   *   - minimal time to run in seconds:
+   *       DBL MinTime;
+   * RETURNS:
+   *   (result) benchmark result.
+   */
+  static result Measure( const std::string &Name, const operation &Op, size_t Items, DBL MinTime )
+  {
+    UINT64 iterations = 1;
+
+    while (TRUE)
+    {
+      UINT64 allocs = BenchAllocations.load();
+      auto start = std::chrono::steady_clock::now();
+      for (UINT64 i = 0; i < iterations; i++)
+        Op();
+      DBL time = std::chrono::duration<DBL>(std::chrono::steady_clock::now() - start).count();
+      allocs = BenchAllocations.load() - allocs;
+
+      if (time >= MinTime || iterations >= (1ull << 40))
+        return {Name, iterations, time * 1e9 / iterations, (DBL)allocs / iterations,
+                time > 0 ? Items * iterations / time : 0};
+
+      // Predict iterations count needed to reach minimal time
+      UINT64 predicted = time > 0 ? (UINT64)(iterations * MinTime * 1.4 / time) : iterations * 10;
+      iterations = mth::Max(iterations * 2, mth::Min(predicted, iterations * 100));
+    }
+  } /* End of 'Measure' function */
+
+  /* Save results to JSON file function.
+   * ARGUMENTS:
+   *   - file name:
+   *       const std::string &FileName;
+   *   - results:
+   *       const std::vector<result> &Results;
+   * RETURNS:
+   *   (BOOL) whether file saved.
+   */
+  static BOOL Save( const std::string &FileName, const std::vector<result> &Results )
+  {
+    std::ofstream file(FileName);
+    if (!file)
+      return FALSE;
+
+    file.precision(17);
+    file << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < Results.size(); i++)
+      file << "    {\"name\": \"" << Results[i].Name << "\", \"iterations\": " << Results[i].Iterations <<
+        ", \"ns_per_op\": " << Results[i].NsPerOp << ", \"allocs_per_op\": " << Results[i].AllocsPerOp <<
+        ", \"items_per_second\": " << Results[i].ItemsPerSecond << "}" << (i + 1 < Results.size() ? ",\n" : "\n");
+    file << "  ]\n}\n";
+    return TRUE;
+  } /* End of 'Save' function */
+
+  /* Load results from JSON file, saved by 'Save' function.
+   * ARGUMENTS:
+   *   - file name:
+   *       const std::string &FileName;
+   *   - results container:
+   *       std::vector<result> *Results;
+   * RETURNS:
+   *   (BOOL) whether file loaded.
+   */
+  static BOOL Load( const std::string &FileName, std::vector<result> *Results )
+  {
+    std::ifstream file(FileName);
+    if (!file)
+      return FALSE;
+
+    std::stringstream text;
+    text << file.rdbuf();
+    std::string json = text.str();
+
+    // Get number after key in object starting at position
+    const auto GetNumber = [&]( size_t Pos, size_t End, const char *Key ) -> DBL
+    {
+      size_t key = json.find(std::string("\"") + Key + "\"", Pos);
+      if (key == std::string::npos || key > End)
+        return 0;
+      return strtod(json.c_str() + json.find(':', key) + 1, nullptr);
+    };
+
+    for (size_t pos = json.find("\"name\""); pos != std::string::npos; pos = json.find("\"name\"", pos + 1))
+    {
+      size_t end = json.find('}', pos), st = json.find('"', json.find(':', pos)) + 1;
+      result res;
+
+      res.Name = json.substr(st, json.find('"', st) - st);
+      res.Iterations = (UINT64)GetNumber(pos, end, "iterations");
+      res.NsPerOp = GetNumber(pos, end, "ns_per_op");
+      res.AllocsPerOp = GetNumber(pos, end, "allocs_per_op");
+      res.ItemsPerSecond = GetNumber(pos, end, "items_per_second");
+      Results->push_back(res);
+    }
+    return TRUE;
+  } /* End of 'Load' function */
+
+public:
+  /* Register benchmark function.
+   * ARGUMENTS:
+   *   - benchmark name:
+   *       const std::string &Name;
+   *   - sizes to run benchmark with:
+   *       const std::vector<size_t> &Sizes;
+   *   - setup function:
+   *       const setup &Setup;
+   * RETURNS: None.
+   */
+  VOID Register( const std::string &Name, const std::vector<size_t> &Sizes, const setup &Setup )
+  {
+    Entries.push_back({Name, Sizes, Setup});
+  } /* End of 'Register' function */
+
+  /* Run benchmarks function.
+   * ARGUMENTS:
+   *   - console params:
+   *       INT argc, char *argv[];
+   * RETURNS:
+   *   (INT) programm end code: 1 if some benchmark regressed against baseline, 0 otherwise.
+   */
+  INT Run( INT argc, char *argv[] )
+  {
+    std::string filter, save_file, baseline_file;
+    size_t max_size = (size_t)-1;
+    DBL min_time = 0.2, tolerance = 0.2;
+
+    for (INT i = 1; i < argc; i++)
+    {
+      std::string arg = argv[i];
+      BOOL has_value = i + 1 < argc;
+
+      if (arg == "--filter" && has_value)
+        filter = argv[++i];
+      else if (arg == "--max-size" && has_value)
+        max_size = strtoull(argv[++i], nullptr, 10);
+      else if (arg == "--min-time" && has_value)
+        min_time = atof(argv[++i]);
+      else if (arg == "--save" && has_value)
+        save_file = argv[++i];
+      else if (arg == "--baseline" && has_value)
+        baseline_file = argv[++i];
+      else if (arg == "--tolerance" && has_value)
+        tolerance = atof(argv[++i]);
+      else
+      {
+        fprintf(stderr,
+          "Usage: %s [--filter <substring>] [--max-size <n>] [--min-time <seconds>]\n"
+          "          [--save <results.json>] [--baseline <results.json> [--tolerance <fraction>]]\n", argv[0]);
+        return 1;
+      }
+    }
+
+    std::vector<result> baseline;
+    if (!baseline_file.empty() && !Load(baseline_file, &baseline))
+    {
+      fprintf(stderr, "Can not load baseline '%s'\n", baseline_file.c_str());
+      return 1;
+    }
+
+    std::vector<result> results;
+    INT regressions = 0;
+
+    printf("%-48s %14s %12s %12s %14s\n", "Benchmark", "Iterations", "ns/op", "allocs/op", "items/s");
+    for (const entry &e : Entries)
+      for (size_t size : e.Sizes)
+      {
+        std::string name = e.Name + "/" + std::to_string(size);
+        if (size > max_size || name.find(filter) == std::string::npos)
+          continue;
+
+        size_t items = 1;
+        operation op = e.Setup(size, &items);
+        result res = Measure(name, op, items, min_time);
+        results.push_back(res);
+        printf("%-48s %14llu %12.1f %12.2f %14.4g", name.c_str(), (unsigned long long)res.Iterations,
+               res.NsPerOp, res.AllocsPerOp, res.ItemsPerSecond);
+
+        // Regression mode: compare with stored result
+        for (const result &base : baseline)
+          if (base.Name == name && base.NsPerOp > 0)
+          {
+            DBL ratio = res.NsPerOp / base.NsPerOp;
+            BOOL is_regressed = ratio > 1 + tolerance;
+
+            printf("   %+.1f%%%s", (ratio - 1) * 100, is_regressed ? " REGRESSION" : "");
+            regressions += is_regressed;
+            break;
+          }
+        printf("\n");
+        fflush(stdout);
+      }
+
+    if (!save_file.empty() && !Save(save_file, results))
+    {
+      fprintf(stderr, "Can not save results to '%s'\n", save_file.c_str());
+      return 1;
+    }
+    if (!baseline_file.empty())
+      printf("%d regression(s) against '%s'\n", regressions, baseline_file.c_str());
+    return regressions > 0;
+  } /* End of 'Run' function */
+}; /* end of 'bench' class */
+
+#endif /* __bench_h_ */
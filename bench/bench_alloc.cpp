@@ -0,0 +1,50 @@
+#include <cstdlib>
+#include <new>
+
+#include "bench.h"
+
+/* Global allocation functions replacement counting heap allocations of benchmarks.
+ * Functions are kept in own translation unit, so they are never inlined into new-expressions
+ * and allocation goes through malloc paired with free of delete.
+ */
+
+std::atomic<UINT64> BenchAllocations(0); // Heap allocations counter
+
+/* Counting allocation function.
+ * ARGUMENTS:
+ *   - size of memory block:
+ *       size_t Size;
+ * RETURNS:
+ *   (VOID *) allocated memory.
+ */
+VOID * operator new( size_t Size )
+{
+  BenchAllocations++;
+  if (VOID *mem = malloc(Size > 0 ? Size : 1))
+    return mem;
+  throw std::bad_alloc();
+} /* End of 'operator new' function */
+
+/* Free allocated memory function.
+ * ARGUMENTS:
+ *   - memory block:
+ *       VOID *Mem;
+ * RETURNS: None.
+ */
+VOID operator delete( VOID *Mem ) noexcept
+{
+  free(Mem);
+} /* End of 'operator delete' function */
+
+/* Free allocated memory of known size function.
+ * ARGUMENTS:
+ *   - memory block:
+ *       VOID *Mem;
+ *   - size of memory block (not used):
+ *       size_t;
+ * RETURNS: None.
+ */
+VOID operator delete( VOID *Mem, size_t ) noexcept
+{
+  free(Mem);
+} /* End of 'operator delete' function */
@@ -0,0 +1,888 @@
+#include <cstdio>
+#include <memory>
+
+#include "bench.h"
+#include "../location/location_delaunay.h"
+#include "../location/location_ear_clipping.h"
+#include "../location/location_import.h"
+#include "../location/location_prepared_polygon.h"
+#include "../location/location_simd.h"
+
+/* Location module benchmarks class. */
+class location_bench
+{
+private:
+  bench Runner; // Benchmarks runner
+
+  static points_pool Pool;            // Points pool of benchmarks without location
+  static thread_pool Threads;         // Threads of merging benchmarks
+  static const char *FileName;        // Location file used by save and load benchmarks
+  static const char *WallsFileName;   // Walls dataset imported to locations
+  static const char *ImportFormats[3]; // Import benchmarks dataset formats (used as files extensions)
+
+  // Benchmarks sizes
+  const std::vector<size_t>
+    AllSizes {10, 100, 1000, 10000, 100000, 1000000},
+    MediumSizes {10, 100, 1000, 10000, 100000},
+    SmallSizes {10, 100, 1000, 10000},
+    PointSizes {10, 1000, 100000, 1000000};
+
+  /* Get random number in [Min; Max] function.
+   * ARGUMENTS:
+   *   - range:
+   *       DBL Min, DBL Max;
+   * RETURNS:
+   *   (DBL) random number.
+   */
+  static DBL Rnd( DBL Min, DBL Max )
+  {
+    static UINT64 seed = 0x9E3779B97F4A7C15ull;
+
+    // xorshift64*, independent of platform rand()
+    seed ^= seed >> 12, seed ^= seed << 25, seed ^= seed >> 27;
+    return Min + (Max - Min) * ((seed * 0x2545F4914F6CDD1Dull) >> 11) * (1.0 / (1ull << 53));
+  } /* End of 'Rnd' function */
+
+  /* Add points to points pool without snapping function.
+   * ARGUMENTS:
+   *   - points:
+   *       const std::vector<vec2> &Points;
+   *   - points pool to add to:
+   *       points_pool &Dest;
+   * RETURNS:
+   *   (std::vector<size_t>) indexes of points in pool.
+   */
+  static std::vector<size_t> AddPoints( const std::vector<vec2> &Points, points_pool &Dest = Pool )
+  {
+    std::vector<size_t> indices;
+
+    indices.reserve(Points.size());
+    for (const vec2 &pnt : Points)
+      indices.push_back(Dest.Add(pnt, 0));
+    return indices;
+  } /* End of 'AddPoints' function */
+
+  /* Build polygon by closed chain of points function.
+   * ARGUMENTS:
+   *   - points:
+   *       const std::vector<vec2> &Points;
+   *   - points pool to add points to:
+   *       points_pool &Dest;
+   * RETURNS:
+   *   (polygon) built polygon.
+   */
+  static polygon MakePolygon( const std::vector<vec2> &Points, points_pool &Dest = Pool )
+  {
+    std::vector<size_t> indices = AddPoints(Points, Dest);
+    polygon polly;
+
+    for (size_t i = 0, cnt = indices.size(); i < cnt; i++)
+      polly.Lines.push_back(segment(indices[i], indices[(i + 1) % cnt]));
+    return polly;
+  } /* End of 'MakePolygon' function */
+
+  /* Generate random star-shaped simple polygon function.
+   * ARGUMENTS:
+   *   - vertices count:
+   *       size_t N;
+   *   - center and radius:
+   *       DBL Cx, DBL Cy, DBL R;
+   * RETURNS:
+   *   (std::vector<vec2>) polygon vertices.
+   */
+  static std::vector<vec2> RandomPolygon( size_t N, DBL Cx, DBL Cy, DBL R )
+  {
+    std::vector<vec2> pnts;
+
+    for (size_t i = 0; i < N; i++)
+    {
+      DBL angle = (i + Rnd(0, 0.8)) / N * 2 * mth::PI, r = R * Rnd(0.7, 1);
+      pnts.push_back(vec2((FLT)(Cx + r * cos(angle)), (FLT)(Cy + r * sin(angle))));
+    }
+    return pnts;
+  } /* End of 'RandomPolygon' function */
+
+  /* Generate grid rooms polygon function.
+   * Polygon is a corridor with rooms attached along it (comb-like rectilinear outline).
+   * ARGUMENTS:
+   *   - vertices count (rounded):
+   *       size_t N;
+   *   - shift of polygon:
+   *       DBL Dx, DBL Dy;
+   * RETURNS:
+   *   (std::vector<vec2>) polygon vertices.
+   */
+  static std::vector<vec2> GridRooms( size_t N, DBL Dx, DBL Dy )
+  {
+    size_t rooms = mth::Max<size_t>(N / 4, 1);
+    DBL step = 1.6 / rooms, x0 = -0.8 + Dx;
+    std::vector<vec2> pnts;
+
+    pnts.push_back(vec2((FLT)x0, (FLT)(-0.8 + Dy)));
+    pnts.push_back(vec2((FLT)(x0 + 1.6), (FLT)(-0.8 + Dy)));
+    for (size_t i = rooms; i > 0; i--)
+    {
+      DBL x = x0 + step * i;
+      pnts.push_back(vec2((FLT)x, (FLT)(0.8 + Dy)));
+      pnts.push_back(vec2((FLT)(x - step * 0.8), (FLT)(0.8 + Dy)));
+      pnts.push_back(vec2((FLT)(x - step * 0.8), (FLT)(-0.5 + Dy)));
+      pnts.push_back(vec2((FLT)(x - step), (FLT)(-0.5 + Dy)));
+    }
+    return pnts;
+  } /* End of 'GridRooms' function */
+
+  /* Generate star polygon with self-crossings function.
+   * Vertices on circle are connected through one, so every side crosses neighbour sides.
+   * ARGUMENTS:
+   *   - vertices count:
+   *       size_t N;
+   *   - center and radius:
+   *       DBL Cx, DBL Cy, DBL R;
+   * RETURNS:
+   *   (std::vector<vec2>) polygon vertices.
+   */
+  static std::vector<vec2> CrossingStar( size_t N, DBL Cx, DBL Cy, DBL R )
+  {
+    size_t n = N | 1; // Odd count gives one closed chain
+    std::vector<vec2> pnts;
+
+    for (size_t i = 0; i < n; i++)
+    {
+      DBL angle = (DBL)(i * 2 % n) / n * 2 * mth::PI, r = R * Rnd(0.9, 1);
+      pnts.push_back(vec2((FLT)(Cx + r * cos(angle)), (FLT)(Cy + r * sin(angle))));
+    }
+    return pnts;
+  } /* End of 'CrossingStar' function */
+
+  /* Generate stripes polygon function.
+   * Polygon is a serpentine of long horizontal sides going up with constant step, closed by side to the left
+   * of it, so x ranges of almost all sides overlap, while sides stay far from each other by y for any count.
+   * ARGUMENTS:
+   *   - vertices count (rounded):
+   *       size_t N;
+   *   - shift of polygon:
+   *       DBL Dx, DBL Dy;
+   * RETURNS:
+   *   (std::vector<vec2>) polygon vertices.
+   */
+  static std::vector<vec2> Stripes( size_t N, DBL Dx, DBL Dy )
+  {
+    size_t stripes = mth::Max<size_t>(N / 4 * 2, 2); // Even count, so serpentine ends on the left
+    DBL step = 0.01, x0 = -0.8 + Dx, x1 = 0.8 + Dx;
+    std::vector<vec2> pnts;
+
+    for (size_t i = 0; i < stripes; i++)
+    {
+      DBL y = -0.8 + Dy + step * i;
+
+      pnts.push_back(vec2((FLT)(i % 2 == 0 ? x0 : x1), (FLT)y));
+      pnts.push_back(vec2((FLT)(i % 2 == 0 ? x1 : x0), (FLT)y));
+    }
+    pnts.push_back(vec2((FLT)(x0 - 0.1), (FLT)(-0.8 + Dy + step * (stripes - 1))));
+    pnts.push_back(vec2((FLT)(x0 - 0.1), (FLT)(-0.8 + Dy)));
+    return pnts;
+  } /* End of 'Stripes' function */
+
+  /* Generate random points function.
+   * ARGUMENTS:
+   *   - points count:
+   *       size_t N;
+   * RETURNS:
+   *   (std::vector<vec2>) points.
+   */
+  static std::vector<vec2> RandomPoints( size_t N )
+  {
+    std::vector<vec2> pnts;
+
+    for (size_t i = 0; i < N; i++)
+      pnts.push_back(vec2((FLT)Rnd(-1, 1), (FLT)Rnd(-1, 1)));
+    return pnts;
+  } /* End of 'RandomPoints' function */
+
+  /* Generate grid of overlapping square rooms function.
+   * Rooms go row by row, so neighbour rooms of list are neighbours on plan.
+   * ARGUMENTS:
+   *   - rooms count (rounded):
+   *       size_t N;
+   * RETURNS:
+   *   (std::vector<polygon>) rooms polygons.
+   */
+  static std::vector<polygon> OverlappingRooms( size_t N )
+  {
+    size_t side = mth::Max<size_t>((size_t)sqrt((DBL)N), 1);
+    DBL step = 1.6 / side, size = step * 1.1;
+    std::vector<polygon> rooms;
+
+    for (size_t i = 0; i < side * side; i++)
+    {
+      DBL x0 = -0.8 + step * (i % side), y0 = -0.8 + step * (i / side);
+
+      rooms.push_back(MakePolygon({vec2((FLT)x0, (FLT)y0), vec2((FLT)(x0 + size), (FLT)y0),
+                                   vec2((FLT)(x0 + size), (FLT)(y0 + size)), vec2((FLT)x0, (FLT)(y0 + size))}));
+    }
+    return rooms;
+  } /* End of 'OverlappingRooms' function */
+
+  /* Write grid of square footprints dataset function.
+   * Neighbour footprints share vertices, as building blocks of real datasets do.
+   * ARGUMENTS:
+   *   - dataset format ("wkt", "geojson" or "csv"):
+   *       const std::string &Format;
+   *   - footprints count (rounded):
+   *       size_t N;
+   *   - file name:
+   *       const std::string &FileName;
+   * RETURNS: None.
+   */
+  static VOID WriteFootprints( const std::string &Format, size_t N, const std::string &FileName )
+  {
+    size_t side = mth::Max<size_t>((size_t)sqrt((DBL)N), 1);
+    DBL step = 1.6 / side;
+    FILE *file = fopen(FileName.c_str(), "wb");
+
+    if (file == nullptr)
+      return;
+    if (Format == "geojson")
+      fprintf(file, "{\"type\": \"FeatureCollection\", \"features\": [\n");
+    for (size_t i = 0; i < side * side; i++)
+    {
+      DBL x0 = -0.8 + step * (i % side), y0 = -0.8 + step * (i / side), x1 = x0 + step, y1 = y0 + step;
+
+      if (Format == "wkt")
+        fprintf(file, "POLYGON ((%.9g %.9g, %.9g %.9g, %.9g %.9g, %.9g %.9g, %.9g %.9g))\n",
+                x0, y0, x1, y0, x1, y1, x0, y1, x0, y0);
+      else if (Format == "geojson")
+        fprintf(file, "%s{\"type\": \"Feature\", \"properties\": {\"id\": %zu}, \"geometry\": {\"type\": \"Polygon\", "
+                "\"coordinates\": [[[%.9g, %.9g], [%.9g, %.9g], [%.9g, %.9g], [%.9g, %.9g], [%.9g, %.9g]]]}}\n",
+                i == 0 ? "" : ",", i, x0, y0, x1, y0, x1, y1, x0, y1, x0, y0);
+      else
+        fprintf(file, "%zu,%.9g,%.9g\n%zu,%.9g,%.9g\n%zu,%.9g,%.9g\n%zu,%.9g,%.9g\n",
+                i, x0, y0, i, x1, y0, i, x1, y1, i, x0, y1);
+    }
+    if (Format == "geojson")
+      fprintf(file, "]}\n");
+    fclose(file);
+  } /* End of 'WriteFootprints' function */
+
+  /* Write walls dataset function.
+   * Walls are written as WKT polygons, so locations are filled by import as by user.
+   * ARGUMENTS:
+   *   - walls rings:
+   *       const std::vector<std::vector<vec2>> &Rings;
+   *   - file name:
+   *       const std::string &FileName;
+   * RETURNS: None.
+   */
+  static VOID WriteWalls( const std::vector<std::vector<vec2>> &Rings, const std::string &FileName )
+  {
+    FILE *file = fopen(FileName.c_str(), "wb");
+
+    if (file == nullptr)
+      return;
+    for (const std::vector<vec2> &ring : Rings)
+    {
+      fprintf(file, "POLYGON ((");
+      for (size_t i = 0; i <= ring.size(); i++)
+        fprintf(file, "%s%.9g %.9g", i == 0 ? "" : ", ", ring[i % ring.size()][0], ring[i % ring.size()][1]);
+      fprintf(file, "))\n");
+    }
+    fclose(file);
+  } /* End of 'WriteWalls' function */
+
+  /* Make location with imported walls function.
+   * ARGUMENTS:
+   *   - walls rings:
+   *       const std::vector<std::vector<vec2>> &Rings;
+   * RETURNS:
+   *   (std::shared_ptr<location>) location.
+   */
+  static std::shared_ptr<location> MakeLocation( const std::vector<std::vector<vec2>> &Rings )
+  {
+    auto loc = std::make_shared<location>();
+
+    WriteWalls(Rings, WallsFileName);
+    loc->Import(WallsFileName);
+    return loc;
+  } /* End of 'MakeLocation' function */
+
+  /* Generate polygon of given kind function.
+   * ARGUMENTS:
+   *   - kind: "random", "grid" or "star":
+   *       const std::string &Kind;
+   *   - vertices count:
+   *       size_t N;
+   *   - shift of polygon:
+   *       DBL Dx, DBL Dy;
+   * RETURNS:
+   *   (std::vector<vec2>) polygon vertices.
+   */
+  static std::vector<vec2> Generate( const std::string &Kind, size_t N, DBL Dx, DBL Dy )
+  {
+    if (Kind == "grid")
+      return GridRooms(N, Dx, Dy);
+    if (Kind == "star")
+      return CrossingStar(N, Dx, Dy, 0.8);
+    return RandomPolygon(N, Dx, Dy, 0.8);
+  } /* End of 'Generate' function */
+
+  /* Register points pool benchmarks function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID RegisterPointsPool( VOID )
+  {
+    Runner.Register("points_pool::Add", PointSizes, []( size_t Size, size_t *Items ) -> bench::operation
+      {
+        auto pnts = std::make_shared<std::vector<vec2>>(RandomPoints(Size));
+
+        *Items = Size;
+        return [pnts]( VOID )
+          {
+            Pool.Clear();
+            for (const vec2 &pnt : *pnts)
+              Pool.Add(pnt);
+          };
+      });
+
+    Runner.Register("points_pool::Get", PointSizes, []( size_t Size, size_t * ) -> bench::operation
+      {
+        Pool.Clear();
+        AddPoints(RandomPoints(Size));
+        auto queries = std::make_shared<std::vector<vec2>>(RandomPoints(4096));
+        auto index = std::make_shared<size_t>(0);
+
+        return [queries, index]( VOID )
+          {
+            size_t res;
+            Pool.Get((*queries)[(*index)++ & 4095], &res, location::PlaceingRadius);
+          };
+      });
+
+    Runner.Register("points_pool::GetBatch", PointSizes, []( size_t Size, size_t *Items ) -> bench::operation
+      {
+        Pool.Clear();
+        AddPoints(RandomPoints(Size));
+        auto queries = std::make_shared<std::vector<vec2>>(RandomPoints(4096));
+        auto results = std::make_shared<std::vector<size_t>>();
+
+        *Items = queries->size();
+        return [queries, results]( VOID )
+          {
+            Pool.Get(*queries, results.get(), location::PlaceingRadius);
+          };
+      });
+  } /* End of 'RegisterPointsPool' function */
+
+  /* Register segment benchmarks function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID RegisterSegment( VOID )
+  {
+    // Random short segments, pairs cycle over all of them
+    const auto MakeSegments = []( size_t Size )
+    {
+      Pool.Clear();
+      std::vector<vec2> pnts;
+      for (size_t i = 0; i < Size; i++)
+      {
+        vec2 pnt((FLT)Rnd(-1, 1), (FLT)Rnd(-1, 1));
+        pnts.push_back(pnt);
+        pnts.push_back(pnt + vec2((FLT)Rnd(-0.2, 0.2), (FLT)Rnd(-0.2, 0.2)));
+      }
+      std::vector<size_t> indices = AddPoints(pnts);
+      auto segs = std::make_shared<std::vector<segment>>();
+      for (size_t i = 0; i < indices.size(); i += 2)
+        segs->push_back(segment(indices[i], indices[i + 1]));
+      return segs;
+    };
+
+    Runner.Register("segment::Intersect", PointSizes, [MakeSegments]( size_t Size, size_t * ) -> bench::operation
+      {
+        auto segs = MakeSegments(Size);
+        auto index = std::make_shared<size_t>(0);
+
+        return [segs, index]( VOID )
+          {
+            size_t cnt = segs->size(), i = (*index)++ % cnt;
+            const segment &other = (*segs)[(i * 7 + 1) % cnt];
+            vec2 res;
+            (*segs)[i].Intersect(Pool, Pool[other.St], Pool[other.End], &res);
+          };
+      });
+
+    Runner.Register("simd::IntersectSegments", PointSizes, [MakeSegments]( size_t Size, size_t *Items ) -> bench::operation
+      {
+        auto segs = MakeSegments(Size);
+        auto soa = std::make_shared<std::vector<FLT>>(segs->size() * 6);
+        auto hits = std::make_shared<std::vector<UINT32>>((segs->size() + 31) / 32);
+        auto index = std::make_shared<size_t>(0);
+
+        // Segments points as structure of arrays (X0, Y0, X1, Y1), then intersection points (Rx, Ry)
+        for (size_t i = 0, cnt = segs->size(); i < cnt; i++)
+        {
+          vec2 st = Pool[(*segs)[i].St], end = Pool[(*segs)[i].End];
+          (*soa)[i] = st[0], (*soa)[cnt + i] = st[1], (*soa)[cnt * 2 + i] = end[0], (*soa)[cnt * 3 + i] = end[1];
+        }
+
+        *Items = segs->size();
+        return [segs, soa, hits, index]( VOID )
+          {
+            size_t cnt = segs->size();
+            const segment &query = (*segs)[(*index)++ % cnt];
+            vec2 st = Pool[query.St], end = Pool[query.End];
+            FLT *data = soa->data();
+
+            simd::IntersectSegments(st[0], st[1], end[0], end[1], TRUE, data, data + cnt, data + cnt * 2, data + cnt * 3, cnt,
+                                    hits->data(), data + cnt * 4, data + cnt * 5);
+          };
+      });
+
+    Runner.Register("segment::GetPointDistance", PointSizes, [MakeSegments]( size_t Size, size_t * ) -> bench::operation
+      {
+        auto segs = MakeSegments(Size);
+        auto index = std::make_shared<size_t>(0);
+
+        return [segs, index]( VOID )
+          {
+            size_t i = (*index)++ % segs->size();
+            (*segs)[i].GetPointDistance(Pool, Pool[(*segs)[segs->size() - 1 - i].St]);
+          };
+      });
+
+    Runner.Register("segment::GetPointHalfPlaneLocation", PointSizes, [MakeSegments]( size_t Size, size_t * ) -> bench::operation
+      {
+        auto segs = MakeSegments(Size);
+        auto index = std::make_shared<size_t>(0);
+
+        return [segs, index]( VOID )
+          {
+            size_t i = (*index)++ % segs->size();
+            (*segs)[i].GetPointHalfPlaneLocation(Pool, Pool[(*segs)[segs->size() - 1 - i].St]);
+          };
+      });
+  } /* End of 'RegisterSegment' function */
+
+  /* Register polygon benchmarks function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID RegisterPolygon( VOID )
+  {
+    for (const std::string kind : {"random", "grid", "star"})
+    {
+      Runner.Register("polygon::IsPointInside/" + kind, AllSizes, [kind]( size_t Size, size_t * ) -> bench::operation
+        {
+          Pool.Clear();
+          auto polly = std::make_shared<polygon>(MakePolygon(Generate(kind, Size, 0, 0)));
+          auto queries = std::make_shared<std::vector<vec2>>(RandomPoints(4096));
+          auto index = std::make_shared<size_t>(0);
+
+          return [polly, queries, index]( VOID )
+            {
+              polly->IsPointInside(Pool, (*queries)[(*index)++ & 4095]);
+            };
+        });
+
+      Runner.Register("prepared_polygon::IsPointInside/" + kind, AllSizes, [kind]( size_t Size, size_t * ) -> bench::operation
+        {
+          Pool.Clear();
+          auto prepared = std::make_shared<prepared_polygon>(Pool);
+          auto queries = std::make_shared<std::vector<vec2>>(RandomPoints(4096));
+          auto index = std::make_shared<size_t>(0);
+
+          prepared->Build(MakePolygon(Generate(kind, Size, 0, 0)));
+          return [prepared, queries, index]( VOID )
+            {
+              prepared->IsPointInside((*queries)[(*index)++ & 4095]);
+            };
+        });
+
+      Runner.Register("prepared_polygon::IsPointInside/batch/" + kind, AllSizes, [kind]( size_t Size, size_t *Items ) -> bench::operation
+        {
+          Pool.Clear();
+          auto prepared = std::make_shared<prepared_polygon>(Pool);
+          auto queries = std::make_shared<std::vector<vec2>>(RandomPoints(4096));
+          auto is_inside = std::make_shared<std::vector<BYTE>>(queries->size());
+
+          prepared->Build(MakePolygon(Generate(kind, Size, 0, 0)));
+          *Items = queries->size();
+          return [prepared, queries, is_inside]( VOID )
+            {
+              prepared->IsPointInside(queries->data(), queries->size(), is_inside->data());
+            };
+        });
+
+      Runner.Register("prepared_polygon::Build/" + kind, AllSizes, [kind]( size_t Size, size_t *Items ) -> bench::operation
+        {
+          Pool.Clear();
+          auto polly = std::make_shared<polygon>(MakePolygon(Generate(kind, Size, 0, 0)));
+          auto prepared = std::make_shared<prepared_polygon>(Pool);
+
+          *Items = Size;
+          return [polly, prepared]( VOID )
+            {
+              prepared->Build(*polly);
+            };
+        });
+
+      // Overlapping random and star polygons give long sweep active lists, keep them small
+      Runner.Register("polygon::Merge/" + kind, kind == "grid" ? AllSizes : SmallSizes, [kind]( size_t Size, size_t *Items ) -> bench::operation
+        {
+          Pool.Clear();
+          auto first = std::make_shared<polygon>(MakePolygon(Generate(kind, Size, 0, 0)));
+          auto second = std::make_shared<polygon>(MakePolygon(Generate(kind, Size, 0.3, 0.2)));
+
+          *Items = Size * 2;
+          return [first, second]( VOID )
+            {
+              polygon merged;
+              first->Merge(Pool, *second, &merged);
+            };
+        });
+    }
+
+    // Stripes shifted by half of step: all sides x ranges overlap, but only connecting sides cross other polygon,
+    // so time should grow almost linearly with size
+    Runner.Register("polygon::Merge/stripes", MediumSizes, []( size_t Size, size_t *Items ) -> bench::operation
+      {
+        Pool.Clear();
+        auto first = std::make_shared<polygon>(MakePolygon(Stripes(Size, 0, 0)));
+        auto second = std::make_shared<polygon>(MakePolygon(Stripes(Size, 0.05, 0.005)));
+
+        *Items = first->Lines.size() + second->Lines.size();
+        return [first, second]( VOID )
+          {
+            polygon merged;
+            first->Merge(Pool, *second, &merged);
+          };
+      });
+
+    // Building of rooms merged one by one (as editor closes them) and by reduction tree
+    Runner.Register("polygon::Merge/rooms", SmallSizes, []( size_t Size, size_t *Items ) -> bench::operation
+      {
+        Pool.Clear();
+        auto rooms = std::make_shared<std::vector<polygon>>(OverlappingRooms(Size));
+
+        *Items = rooms->size();
+        return [rooms]( VOID )
+          {
+            polygon merged = (*rooms)[0];
+            for (size_t i = 1; i < rooms->size(); i++)
+              (*rooms)[i].Merge(Pool, merged, &merged);
+          };
+      });
+
+    Runner.Register("polygon::MergeAll/rooms", MediumSizes, []( size_t Size, size_t *Items ) -> bench::operation
+      {
+        Pool.Clear();
+        auto rooms = std::make_shared<std::vector<polygon>>(OverlappingRooms(Size));
+
+        *Items = rooms->size();
+        return [rooms]( VOID )
+          {
+            polygon merged;
+            polygon::MergeAll(Pool, *rooms, Threads, &merged);
+          };
+      });
+
+    const std::vector<std::pair<std::string, polygon_boolean::operation>> operations =
+    {
+      {"union", polygon_boolean::OPERATION_UNION},
+      {"intersection", polygon_boolean::OPERATION_INTERSECTION},
+      {"difference", polygon_boolean::OPERATION_DIFFERENCE},
+      {"xor", polygon_boolean::OPERATION_XOR},
+    };
+    for (const auto &operation : operations)
+    {
+      polygon_boolean::operation op = operation.second;
+
+      // Random polygons spikes cross each other, so intersections count grows faster than size
+      Runner.Register("polygon_boolean::Compute/" + operation.first, SmallSizes, [op]( size_t Size, size_t *Items ) -> bench::operation
+        {
+          Pool.Clear();
+          auto subject = std::make_shared<std::vector<polygon>>(1, MakePolygon(RandomPolygon(Size, 0, 0, 0.8)));
+          auto clip = std::make_shared<std::vector<polygon>>(1, MakePolygon(RandomPolygon(Size, 0.3, 0.2, 0.8)));
+          auto boolean = std::make_shared<polygon_boolean>(Pool);
+
+          *Items = Size * 2;
+          return [subject, clip, boolean, op]( VOID )
+            {
+              std::vector<polygon> result;
+              boolean->Compute(*subject, *clip, op, &result);
+            };
+        });
+    }
+
+    // Rooms are joined at once by nonzero winding rule
+    Runner.Register("polygon_boolean::Compute/rooms", MediumSizes, []( size_t Size, size_t *Items ) -> bench::operation
+      {
+        Pool.Clear();
+        auto rooms = std::make_shared<std::vector<polygon>>(OverlappingRooms(Size));
+        auto boolean = std::make_shared<polygon_boolean>(Pool);
+
+        *Items = rooms->size();
+        return [rooms, boolean]( VOID )
+          {
+            std::vector<polygon> result;
+            boolean->Compute(*rooms, {}, polygon_boolean::OPERATION_UNION, &result);
+          };
+      });
+  } /* End of 'RegisterPolygon' function */
+
+  /* Register location and triangulation benchmarks function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID RegisterLocation( VOID )
+  {
+    // Location with one random wall
+    const auto MakeWallLocation = []( size_t Size )
+    {
+      return MakeLocation({RandomPolygon(Size, 0, 0, 0.8)});
+    };
+
+    Runner.Register("location::FindPoint", AllSizes, [MakeWallLocation]( size_t Size, size_t * ) -> bench::operation
+      {
+        auto loc = MakeWallLocation(Size);
+        auto queries = std::make_shared<std::vector<vec2>>(RandomPoints(4096));
+        auto index = std::make_shared<size_t>(0);
+
+        return [loc, queries, index]( VOID )
+          {
+            vec2 res;
+            loc->FindPoint((*queries)[(*index)++ & 4095], TRUE, &res);
+          };
+      });
+
+    Runner.Register("location::FindPolygon", AllSizes, [MakeWallLocation]( size_t Size, size_t * ) -> bench::operation
+      {
+        auto loc = MakeWallLocation(Size);
+        auto queries = std::make_shared<std::vector<vec2>>(RandomPoints(4096));
+        auto index = std::make_shared<size_t>(0);
+
+        return [loc, queries, index]( VOID )
+          {
+            size_t res;
+            loc->FindPolygon((*queries)[(*index)++ & 4095], &res);
+          };
+      });
+
+    Runner.Register("location::CurrPolyPlaceSegment", AllSizes, [MakeWallLocation]( size_t Size, size_t * ) -> bench::operation
+      {
+        auto loc = MakeWallLocation(Size);
+        auto queries = std::make_shared<std::vector<vec2>>(RandomPoints(4096));
+        auto index = std::make_shared<size_t>(0);
+
+        // Segment is placed and undone, so location stays the same
+        return [loc, queries, index]( VOID )
+          {
+            size_t i = (*index)++;
+            loc->CurrPolyPlaceSegment((*queries)[i & 4095], (*queries)[(i + 1) & 4095]);
+            loc->CurrPolyDestroyLastSegment();
+          };
+      });
+
+    Runner.Register("location::MovePoint", AllSizes, [MakeWallLocation]( size_t Size, size_t * ) -> bench::operation
+      {
+        auto loc = MakeWallLocation(Size);
+        auto is_back = std::make_shared<BOOL>(FALSE);
+        vec2 pnt = loc->GetPointsPool()[loc->Walls[0].Lines[0].St];
+
+        // Point is moved there and back
+        return [loc, is_back, pnt]( VOID )
+          {
+            vec2 shifted = pnt + vec2(0.01f, 0.01f);
+            loc->MovePoint(*is_back ? shifted : pnt);
+            loc->MovePoint(*is_back ? pnt : shifted);
+            loc->MovePoint(*is_back ? pnt : shifted, TRUE);
+            *is_back = !*is_back;
+          };
+      });
+
+    Runner.Register("location::TriangulateWalls", AllSizes, [MakeWallLocation]( size_t Size, size_t *Items ) -> bench::operation
+      {
+        auto loc = MakeWallLocation(Size);
+
+        // Kept triangulation is dropped, so it is built from scratch
+        *Items = Size;
+        return [loc]( VOID )
+          {
+            std::vector<size_t> triangles;
+            loc->ResetTriangulation();
+            loc->TriangulateWalls(&triangles);
+          };
+      });
+
+    Runner.Register("location::TriangulateWalls/drag", MediumSizes, [MakeWallLocation]( size_t Size, size_t * ) -> bench::operation
+      {
+        auto loc = MakeWallLocation(Size);
+        auto is_back = std::make_shared<BOOL>(FALSE);
+        auto triangles = std::make_shared<std::vector<size_t>>();
+        vec2 pnt = loc->GetPointsPool()[loc->Walls[0].Lines[0].St];
+
+        // Point is dragged less than neighbours distance, so walls do not cross, triangles buffer is reused as by renderer
+        loc->TriangulateWalls(triangles.get());
+        return [loc, is_back, triangles, pnt, Size]( VOID )
+          {
+            vec2 shifted = pnt + vec2(0.5f / Size, 0.5f / Size);
+
+            loc->MovePoint(*is_back ? shifted : pnt);
+            loc->MovePoint(*is_back ? pnt : shifted);
+            loc->MovePoint(*is_back ? pnt : shifted, TRUE);
+            triangles->clear();
+            loc->TriangulateWalls(triangles.get());
+            *is_back = !*is_back;
+          };
+      });
+
+    Runner.Register("location::GetWallsInfo/rooms", MediumSizes, []( size_t Size, size_t *Items ) -> bench::operation
+      {
+        auto infos = std::make_shared<std::vector<location::wall_info>>();
+        size_t side = mth::Max<size_t>((size_t)sqrt((DBL)Size / 2), 1);
+        DBL step = 1.6 / side;
+        std::vector<std::vector<vec2>> rings;
+
+        // Every room has column inside, so containment is found for half of walls
+        for (size_t i = 0; i < side * side; i++)
+        {
+          DBL cx = -0.8 + step * (i % side + 0.5), cy = -0.8 + step * (i / side + 0.5);
+
+          rings.push_back(RandomPolygon(16, cx, cy, step * 0.45));
+          rings.push_back(RandomPolygon(8, cx, cy, step * 0.1));
+        }
+        auto loc = MakeLocation(rings);
+
+        *Items = loc->Walls.size();
+        return [loc, infos]( VOID )
+          {
+            loc->GetWallsInfo(infos.get());
+          };
+      });
+
+    Runner.Register("location::Save", AllSizes, [MakeWallLocation]( size_t Size, size_t *Items ) -> bench::operation
+      {
+        auto loc = MakeWallLocation(Size);
+
+        *Items = Size;
+        return [loc]( VOID )
+          {
+            loc->Save(FileName);
+          };
+      });
+
+    Runner.Register("location::Load", AllSizes, [MakeWallLocation]( size_t Size, size_t *Items ) -> bench::operation
+      {
+        auto loc = MakeWallLocation(Size);
+
+        // Location is loaded from file it was saved to, so it stays the same
+        loc->Save(FileName);
+        *Items = Size;
+        return [loc]( VOID )
+          {
+            loc->Load(FileName);
+          };
+      });
+
+    for (const std::string format : ImportFormats)
+      Runner.Register("location_import::Import/" + format, AllSizes, [format]( size_t Size, size_t *Items ) -> bench::operation
+        {
+          std::string file_name = std::string("location_bench.") + format;
+          auto pool = std::make_shared<points_pool>();
+          auto pollys = std::make_shared<std::vector<polygon>>();
+
+          WriteFootprints(format, Size, file_name);
+          *Items = Size;
+          return [pool, pollys, file_name]( VOID )
+            {
+              location_import importer(*pool);
+
+              pool->Clear();
+              pollys->clear();
+              importer.Import(file_name, pollys.get());
+            };
+        });
+
+    for (const std::string kind : {"random", "grid"})
+    {
+      Runner.Register("ear_clipping::Triangulate/" + kind, AllSizes, [kind]( size_t Size, size_t *Items ) -> bench::operation
+        {
+          Pool.Clear();
+          auto polly = std::make_shared<polygon>(MakePolygon(Generate(kind, Size, 0, 0)));
+          auto triangulator = std::make_shared<ear_clipping>(Pool);
+
+          *Items = Size;
+          return [polly, triangulator]( VOID )
+            {
+              std::vector<size_t> triangles;
+              triangulator->Triangulate(*polly, &triangles);
+            };
+        });
+
+      Runner.Register("delaunay::Triangulate/" + kind, AllSizes, [kind]( size_t Size, size_t *Items ) -> bench::operation
+        {
+          Pool.Clear();
+          auto pollys = std::make_shared<std::vector<polygon>>(1, MakePolygon(Generate(kind, Size, 0, 0)));
+          auto triangulator = std::make_shared<delaunay>(Pool);
+
+          *Items = Size;
+          return [pollys, triangulator]( VOID )
+            {
+              std::vector<size_t> triangles;
+              triangulator->Triangulate(*pollys, &triangles);
+            };
+        });
+    }
+  } /* End of 'RegisterLocation' function */
+
+public:
+  /* Location benchmarks constructor. */
+  location_bench( VOID )
+  {
+    RegisterPointsPool();
+    RegisterSegment();
+    RegisterPolygon();
+    RegisterLocation();
+  } /* End of 'location_bench' constructor */
+
+  /* Location benchmarks destructor. */
+  ~location_bench( VOID )
+  {
+    std::remove(FileName);
+    std::remove(WallsFileName);
+    for (const char *format : ImportFormats)
+      std::remove((std::string("location_bench.") + format).c_str());
+  } /* End of 'location_bench' destructor */
+
+  /* Run benchmarks function.
+   * ARGUMENTS:
+   *   - console params:
+   *       INT argc, char *argv[];
+   * RETURNS:
+   *   (INT) programm end code.
+   */
+  INT Run( INT argc, char *argv[] )
+  {
+    return Runner.Run(argc, argv);
+  } /* End of 'Run' function */
+}; /* end of 'location_bench' class */
+
+points_pool location_bench::Pool(location::PlaceingRadius);                     // Points pool of benchmarks without location
+thread_pool location_bench::Threads;                                             // Threads of merging benchmarks
+const char *location_bench::FileName = "location_bench.bin";                    // Location file used by save and load benchmarks
+const char *location_bench::WallsFileName = "location_bench_walls.wkt";         // Walls dataset imported to locations
+const char *location_bench::ImportFormats[3] = {"wkt", "geojson", "csv"};        // Import benchmarks dataset formats
+
+/* Main programm function.
+ * ARGUMENTS:
+ *   - console params:
+ *       INT argc, char *argv[];
+ * RETURNS:
+ *   (INT) prgoramm end code.
+ */
+INT main( INT argc, char *argv[] )
+{
+  location_bench benchmarks;
+
+  return benchmarks.Run(argc, argv);
+} /* End of 'main' function. */
@@ -1,8 +1,13 @@
 #ifndef __def_h_
 #define __def_h_
 
+// Headless builds (batch tools) do not use OpenGL
+#ifndef TRIANGULATION_HEADLESS
 #include <freeglut.h>
+#endif /* TRIANGULATION_HEADLESS */
+#ifdef _WIN32
 #include <windows.h>
+#endif /* _WIN32 */
 
 #include <string>
 #include <vector>
@@ -2,9 +2,13 @@
 #include <map>
 #include <algorithm>
 
-#include "location.h"
+#include "location_file.h"
+#include "location_import.h"
+#include "location_ear_clipping.h"
 
-points_pool location::PointsPool = points_pool();
+const DBL location::PlaceingRadius = 0.03;                     // Points  for segments placment radius
+const size_t location::WallsBlockSize = 64;                    // Walls count processed by one task of walls stages
+thread_pool location::SharedThreads;                           // Threads for parallel processing of locations without own pool
 
 /* Find point function.
  * ARGUMENTS:
@@ -25,7 +29,7 @@ BOOL location::FindPoint( const vec2 &Pnt, BOOL FindOnLines, vec2 *Result ) cons
   if (is_found)
   {
     if (Result != nullptr)
-      *Result = PointsPool[index];
+      *Result = PointsPool.At(index);
     return TRUE;
   }
 
@@ -38,34 +42,32 @@ BOOL location::FindPoint( const vec2 &Pnt, BOOL FindOnLines, vec2 *Result ) cons
   BOOL is_inter = FALSE;
   DBL min_dist = PlaceingRadius;
 
-  // Check if point lies on one of polygon's segments function.
-  const auto PointOnPollyogn = [&]( const polygon &Polly )
-  {
-    for (size_t i = 0, cnt = Polly.Lines.size(); i < cnt; i++)
+  // Check only segments which bounding boxes are near the point
+  SegmentsTree.Query(Pnt - vec2((FLT)PlaceingRadius), Pnt + vec2((FLT)PlaceingRadius),
+    [&]( INT, const segment_ref &Ref ) -> BOOL
     {
-      if (Polly.Lines[i].End == CurrPolyLastLineEndIndex())
-        continue;
+      const segment &seg = Ref.Seg;
+      if (seg.End == CurrPolyLastLineEndIndex())
+        return TRUE;
 
-      vec2 L1 = PointsPool[Polly.Lines[i].St], L2 = PointsPool[Polly.Lines[i].End];
+      vec2 L1 = PointsPool.At(seg.St), L2 = PointsPool.At(seg.End);
       vec2 Line = L2 - L1;
+      DBL len = Line.Length();
+      if (len == 0)
+        return TRUE;
 
-      // Calculate cormal to the segment
-      vec2 N = -vec2(Line[1], -Line[0]).Normalize() * (SHORT)Polly.Lines[i].GetPointHalfPlaneLocation(Pnt);
-      DBL dist = N & (Pnt - L1);
+      // Distance from point to segment line
+      DBL dist = fabs(Line[0] * (Pnt[1] - L1[1]) - Line[1] * (Pnt[0] - L1[0])) / len;
 
       // Check if point line in placing radius to the segment
       if (dist < min_dist)
       {
-        DBL x = Line & (L2 - Pnt) / Line.Length();
-        if (x > 0 && x < Line.Length())
-          min_dist = dist, is_inter = TRUE, inter = L2 - Line.Normalize() * x;
+        DBL x = (Line & (L2 - Pnt)) / len;
+        if (x > 0 && x < len)
+          min_dist = dist, is_inter = TRUE, inter = L2 - Line * (FLT)(x / len);
       }
-    }
-  };
-
-  for (const auto &polly: Walls)
-    PointOnPollyogn(polly);
-  PointOnPollyogn(CurrPoly);
+      return TRUE;
+    });
 
   if (!is_inter)
     return FALSE;
@@ -86,7 +88,7 @@ BOOL location::FindPoint( const vec2 &Pnt, BOOL FindOnLines, vec2 *Result ) cons
  * RETURNS:
  *   (BOOL) wheather point found or not.
  */
-BOOL location::FindPoint( const vec2 &Pnt, BOOL FindOnLines, size_t *Result ) const
+BOOL location::FindPoint( const vec2 &Pnt, BOOL FindOnLines, size_t *Result )
 {
   vec2 found_pnt;
   if (FindPoint(Pnt, FindOnLines, &found_pnt))
@@ -141,20 +143,48 @@ BOOL location::CurrPolyPlaceSegment( const vec2 &PntEnd, const vec2 &PntSt )
     if (PointsPool.Get(PntEnd, &SegmentEnd, PlaceingRadius))
     {
       CurrPoly.Lines.push_back(segment(SegmentStart, SegmentEnd));
+      SegmentsTreeAdd(CurrPolyIndex, CurrPoly.Lines.size() - 1);
 
       // If segment ends on its start point closing them.
       if (SegmentEnd == CurrPoly.Start)
       {
         // Mergin current polygon with existing
         if (Walls.size() == 0)
+        {
           Walls.push_back(CurrPoly);
+          SegmentsTreeUpdate(Walls.size() - 1, CurrPolyProxies);
+        }
         else if (CurrPoly.ShouldMerge)
-          CurrPoly.Merge(Walls[0], &Walls[0]);
+        {
+          polygon merged;
+
+          if (CurrPoly.Merge(PointsPool, Walls[0], &merged))
+          {
+            std::vector<INT> old_proxies = GetPolygonProxies(0);
+
+            // Unchanged segments of both polygons keep their proxies
+            old_proxies.insert(old_proxies.end(), CurrPolyProxies.begin(), CurrPolyProxies.end());
+            CurrPolyProxies.clear();
+            Walls[0] = std::move(merged);
+            SegmentsTreeUpdate(0, old_proxies);
+          }
+          else
+          {
+            // Merged outline is not closed (see 'polygon::MergeBuild'), current polygon is kept as separate wall
+            Walls.push_back(CurrPoly);
+            SegmentsTreeUpdate(Walls.size() - 1, CurrPolyProxies);
+          }
+        }
+        else
+          for (INT proxy : CurrPolyProxies)
+            SegmentsTree.Remove(proxy);
 
         // Reseting current polygon, but save close mode.
         BOOL should_merge = CurrPoly.ShouldMerge;
         CurrPoly = current_polygon();
         CurrPoly.ShouldMerge = should_merge;
+        CurrPolyProxies.clear();
+        ChangePolygon(CurrPolyIndex);
         return TRUE;
       }
     }
@@ -163,6 +193,7 @@ BOOL location::CurrPolyPlaceSegment( const vec2 &PntEnd, const vec2 &PntSt )
     {
       SegmentEnd = PlacePoint(PntEnd, TRUE);
       CurrPoly.Lines.push_back(segment(SegmentStart, SegmentEnd));
+      SegmentsTreeAdd(CurrPolyIndex, CurrPoly.Lines.size() - 1);
     }
   }
   // Adding first segment to polygon
@@ -175,6 +206,7 @@ BOOL location::CurrPolyPlaceSegment( const vec2 &PntEnd, const vec2 &PntSt )
     CurrPoly.Start = SegmentStart;
 
     CurrPoly.Lines.push_back(segment(SegmentStart, SegmentEnd));
+    SegmentsTreeAdd(CurrPolyIndex, CurrPoly.Lines.size() - 1);
   }
 
   return FALSE;
@@ -191,58 +223,626 @@ VOID location::CurrPolySetCloseMode( BOOL ShouldMerge )
   CurrPoly.ShouldMerge = ShouldMerge;
 } /* End of 'location::SetCurrPolygonCloseMode' function */
 
-/* Draw circle function.
- * ARGUMETNS:
- *  - possition:
- *      GLfloat X, GLfloat Y;
- *  - radius:
- *      GLfloat Radius;
+/* Add polygon segment to segments tree function.
+ * ARGUMENTS:
+ *   - polygon index (CurrPolyIndex for current polygon):
+ *       size_t Polygon;
+ *   - segment index in polygon:
+ *       size_t Line;
+ * RETURNS: None.
+ */
+VOID location::SegmentsTreeAdd( size_t Polygon, size_t Line )
+{
+  const segment &seg = GetPolygon(Polygon).Lines[Line];
+  vec2 st = PointsPool.At(seg.St), end = PointsPool.At(seg.End);
+
+  ChangePolygon(Polygon);
+  GetPolygonProxies(Polygon).push_back(SegmentsTree.Insert(vec2::Min(st, end), vec2(mth::Max(st[0], end[0]), mth::Max(st[1], end[1])),
+                                                           {seg, Polygon, Line}));
+} /* End of 'location::SegmentsTreeAdd' function */
+
+/* Add walls segments to segments tree at once function.
+ * ARGUMENTS:
+ *   - first wall to add (walls from it should not have segments in tree yet):
+ *       size_t FirstWall;
+ * RETURNS: None.
+ */
+VOID location::SegmentsTreeBuild( size_t FirstWall )
+{
+  size_t segments_cnt = 0, wall = FirstWall, first = 0;
+  std::vector<INT> proxies;
+
+  for (size_t i = FirstWall; i < Walls.size(); i++)
+    segments_cnt += Walls[i].Lines.size();
+  proxies.reserve(segments_cnt);
+
+  // Segments are taken wall by wall in order
+  SegmentsTree.Insert(segments_cnt, [&]( size_t Index, vec2 *Min, vec2 *Max, segment_ref *Ref )
+    {
+      while (Index - first >= Walls[wall].Lines.size())
+        first += Walls[wall++].Lines.size();
+
+      const segment &seg = Walls[wall].Lines[Index - first];
+      vec2 st = PointsPool.At(seg.St), end = PointsPool.At(seg.End);
+
+      *Min = vec2::Min(st, end);
+      *Max = vec2(mth::Max(st[0], end[0]), mth::Max(st[1], end[1]));
+      *Ref = {seg, wall, Index - first};
+    }, &proxies);
+
+  WallsProxies.resize(Walls.size());
+  first = 0;
+  for (wall = FirstWall; wall < Walls.size(); wall++)
+  {
+    WallsProxies[wall].assign(proxies.begin() + first, proxies.begin() + first + Walls[wall].Lines.size());
+    first += Walls[wall].Lines.size();
+    ChangePolygon(wall);
+  }
+} /* End of 'location::SegmentsTreeBuild' function */
+
+/* Synchronize segments tree with polygon lines function.
+ * Proxies of segments which are still present in polygon are reused,
+ * so only really changed lines touch the tree.
+ * ARGUMENTS:
+ *   - polygon index (CurrPolyIndex for current polygon):
+ *       size_t Polygon;
+ *   - proxies, which could be reused (will be emptied):
+ *       std::vector<INT> &OldProxies;
+ * RETURNS: None.
+ */
+VOID location::SegmentsTreeUpdate( size_t Polygon, std::vector<INT> &OldProxies )
+{
+  const polygon &polly = GetPolygon(Polygon);
+  std::multimap<std::pair<size_t, size_t>, INT> old_segments;
+
+  ChangePolygon(Polygon);
+
+  // Collect old proxies by its segments points
+  for (INT proxy : OldProxies)
+  {
+    const segment &seg = SegmentsTree.GetData(proxy).Seg;
+    old_segments.emplace(std::make_pair(seg.St, seg.End), proxy);
+  }
+  OldProxies.clear();
+
+  // Reuse proxies of unchanged segments, add new ones
+  std::vector<INT> &proxies = GetPolygonProxies(Polygon);
+  proxies.clear();
+  for (size_t i = 0, cnt = polly.Lines.size(); i < cnt; i++)
+  {
+    auto old = old_segments.find(std::make_pair(polly.Lines[i].St, polly.Lines[i].End));
+    if (old == old_segments.end())
+    {
+      SegmentsTreeAdd(Polygon, i);
+      continue;
+    }
+    SegmentsTree.GetData(old->second) = {polly.Lines[i], Polygon, i};
+    proxies.push_back(old->second);
+    old_segments.erase(old);
+  }
+
+  // Remove segments which are not in polygon any more
+  for (const auto &old : old_segments)
+    SegmentsTree.Remove(old.second);
+} /* End of 'location::SegmentsTreeUpdate' function */
+
+/* Update bounding boxes of segments with moved point function.
+ * ARGUMENTS:
+ *   - moved point index:
+ *       size_t Index;
+ *   - point possition before moving:
+ *       const vec2 &OldPnt;
+ * RETURNS: None.
+ */
+VOID location::SegmentsTreeMovePoint( size_t Index, const vec2 &OldPnt )
+{
+  std::vector<INT> moved;
+
+  // Segments with moved point have old point possition in its boxes
+  SegmentsTree.Query(OldPnt, OldPnt,
+    [&]( INT Proxy, const segment_ref &Ref ) -> BOOL
+    {
+      if (Ref.Seg.St == Index || Ref.Seg.End == Index)
+        moved.push_back(Proxy);
+      return TRUE;
+    });
+
+  for (INT proxy : moved)
+  {
+    const segment &seg = SegmentsTree.GetData(proxy).Seg;
+    ChangePolygon(SegmentsTree.GetData(proxy).Polygon, FALSE);
+
+    vec2 st = PointsPool.At(seg.St), end = PointsPool.At(seg.End);
+
+    SegmentsTree.Move(proxy, vec2::Min(st, end), vec2(mth::Max(st[0], end[0]), mth::Max(st[1], end[1])));
+  }
+} /* End of 'location::SegmentsTreeMovePoint' function */
+
+/* Mark item as changed function.
+ * ARGUMENTS:
+ *   - item index:
+ *       size_t Index;
+ *   - change generation:
+ *       UINT64 Generation;
+ * RETURNS: None.
+ */
+VOID location::changes::Change( size_t Index, UINT64 Generation )
+{
+  if (Generations.size() <= Index)
+    Generations.resize(Index + 1, 0);
+  if (Generations[Index] == Generation)
+    return;
+  Generations[Index] = Generation;
+  Log.push_back({Generation, Index});
+
+  // Log keeps only last changes, when items are changed many times it is rebuilt by generations
+  if (Log.size() > Generations.size() * 2 + 64)
+  {
+    Log.clear();
+    for (size_t i = 0, cnt = Generations.size(); i < cnt; i++)
+      if (Generations[i] != 0)
+        Log.push_back({Generations[i], i});
+    std::sort(Log.begin(), Log.end());
+  }
+} /* End of 'location::changes::Change' function */
+
+/* Mark added or removed items as changed function.
+ * ARGUMENTS:
+ *   - new items count:
+ *       size_t NewCount;
+ *   - change generation:
+ *       UINT64 Generation;
+ * RETURNS: None.
+ */
+VOID location::changes::Sync( size_t NewCount, UINT64 Generation )
+{
+  for (size_t i = mth::Min(Count, NewCount), end = mth::Max(Count, NewCount); i < end; i++)
+    Change(i, Generation);
+  Count = NewCount;
+} /* End of 'location::changes::Sync' function */
+
+/* Get items changed after generation function.
+ * ARGUMENTS:
+ *   - generation to get changes after:
+ *       UINT64 Since;
+ *   - changed items indexes container:
+ *       std::vector<size_t> *Changed;
+ * RETURNS: None.
+ */
+VOID location::changes::Get( UINT64 Since, std::vector<size_t> *Changed ) const
+{
+  Changed->clear();
+
+  // Only last change of every item is reported
+  for (auto it = std::upper_bound(Log.begin(), Log.end(), std::make_pair(Since, (size_t)-1)); it != Log.end(); ++it)
+    if (Generations[it->second] == it->first)
+      Changed->push_back(it->second);
+} /* End of 'location::changes::Get' function */
+
+/* Clear changes function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location::changes::Clear( VOID )
+{
+  Generations.clear();
+  Log.clear();
+  Count = 0;
+} /* End of 'location::changes::Clear' function */
+
+/* Close current changes generation function.
+ * Points and walls added or removed directly are marked as changed here.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location::ChangesSync( VOID ) const
+{
+  if (PointsChanges.Count != PointsPool.Size())
+    PointsChanges.Sync(PointsPool.Size(), Generation + 1), IsChanged = TRUE;
+  if (WallsChanges.Count != Walls.size())
+  {
+    WallsChanges.Sync(Walls.size(), Generation + 1);
+    WallsEditGeneration = Generation + 1;
+    IsChanged = TRUE;
+  }
+
+  if (IsChanged)
+    Generation++, IsChanged = FALSE;
+} /* End of 'location::ChangesSync' function */
+
+/* Get points changed after generation function.
+ * Indexes not less than points count are removed points.
+ * ARGUMENTS:
+ *   - generation to get changes after:
+ *       UINT64 Since;
+ *   - changed points indexes container:
+ *       std::vector<size_t> *Points;
+ * RETURNS:
+ *   (BOOL) FALSE if location was cleared after generation (everything should be rebuilt), TRUE otherwise.
+ */
+BOOL location::GetChangedPoints( UINT64 Since, std::vector<size_t> *Points ) const
+{
+  ChangesSync();
+  PointsChanges.Get(Since, Points);
+  return ResetGeneration <= Since;
+} /* End of 'location::GetChangedPoints' function */
+
+/* Get walls changed after generation function.
+ * Indexes not less than walls count are removed walls.
+ * ARGUMENTS:
+ *   - generation to get changes after:
+ *       UINT64 Since;
+ *   - changed walls indexes container:
+ *       std::vector<size_t> *Walls;
+ * RETURNS:
+ *   (BOOL) FALSE if location was cleared after generation (everything should be rebuilt), TRUE otherwise.
+ */
+BOOL location::GetChangedWalls( UINT64 Since, std::vector<size_t> *Walls ) const
+{
+  ChangesSync();
+  WallsChanges.Get(Since, Walls);
+  return ResetGeneration <= Since;
+} /* End of 'location::GetChangedWalls' function */
+
+/* Prepare changed walls in point location index function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location::WallsIndexUpdate( VOID ) const
+{
+  task_graph graph;
+
+  if (WallsIndexAddTasks(&graph) != (size_t)-1)
+    Threads->Run(graph);
+} /* End of 'location::WallsIndexUpdate' function */
+
+/* Add point location index updating tasks to graph function.
+ * Changed walls are prepared by blocks concurrently, then bounding boxes tree is updated,
+ * index is treated as updated at once, so graph should be run before index is used.
+ * ARGUMENTS:
+ *   - graph to add tasks to:
+ *       task_graph *Graph;
+ * RETURNS:
+ *   (size_t) index of last task (index is updated after it), -1 if index is up to date.
+ */
+size_t location::WallsIndexAddTasks( task_graph *Graph ) const
+{
+  UINT64 generation = GetGeneration();
+  if (generation == WallsIndexGeneration)
+    return -1;
+
+  // After clear index is built from scratch
+  std::vector<size_t> changed;
+  if (!GetChangedWalls(WallsIndexGeneration, &changed))
+  {
+    WallsPrepared.clear();
+    WallsBoxesProxies.clear();
+    WallsBoxesTree.Clear();
+  }
+  WallsIndexGeneration = generation;
+
+  // Added walls are in changed ones, so they are prepared below
+  while (WallsPrepared.size() > Walls.size())
+  {
+    if (WallsBoxesProxies.back() != -1)
+      WallsBoxesTree.Remove(WallsBoxesProxies.back());
+    WallsPrepared.pop_back();
+    WallsBoxesProxies.pop_back();
+  }
+  while (WallsPrepared.size() < Walls.size())
+  {
+    WallsPrepared.emplace_back(PointsPool);
+    WallsBoxesProxies.push_back(-1);
+  }
+  changed.erase(std::remove_if(changed.begin(), changed.end(), [&]( size_t Wall ){ return Wall >= Walls.size(); }), changed.end());
+
+  // Walls are prepared independently, tree is updated after all of them
+  auto list = std::make_shared<std::vector<size_t>>(std::move(changed));
+  std::vector<size_t> prepares;
+
+  for (size_t i = 0; i < list->size(); i += WallsBlockSize)
+    prepares.push_back(Graph->Add([this, list, i]( VOID )
+      {
+        for (size_t j = i, end = mth::Min(i + WallsBlockSize, list->size()); j < end; j++)
+          WallsPrepared[(*list)[j]].Build(Walls[(*list)[j]]);
+      }));
+
+  return Graph->Add([this, list]( VOID )
+    {
+      for (size_t i : *list)
+      {
+        const prepared_polygon &prepared = WallsPrepared[i];
+        INT &proxy = WallsBoxesProxies[i];
+
+        if (Walls[i].Lines.empty())
+        {
+          if (proxy != -1)
+            WallsBoxesTree.Remove(proxy), proxy = -1;
+        }
+        else if (proxy == -1)
+          proxy = WallsBoxesTree.Insert(prepared.GetMin(), prepared.GetMax(), i);
+        else
+          WallsBoxesTree.Move(proxy, prepared.GetMin(), prepared.GetMax());
+      }
+    }, prepares);
+} /* End of 'location::WallsIndexAddTasks' function */
+
+/* Find wall containing point function.
+ * Walls are checked only if their bounding boxes contain point, if point is inside
+ * several nested walls, one with smallest bounding box is chosen.
+ * ARGUMENTS:
+ *   - point to find wall of:
+ *       const vec2 &Pnt;
+ *   - variable to set index of found wall in:
+ *       size_t *Result;
+ * RETURNS:
+ *   (BOOL) wheather wall found or not.
+ */
+BOOL location::FindPolygon( const vec2 &Pnt, size_t *Result ) const
+{
+  WallsIndexUpdate();
+
+  size_t found = CurrPolyIndex;
+  FLT min_area = INFINITY;
+
+  WallsBoxesTree.Query(Pnt, Pnt,
+    [&]( INT, const size_t &Wall ) -> BOOL
+    {
+      const prepared_polygon &prepared = WallsPrepared[Wall];
+      vec2 size = prepared.GetMax() - prepared.GetMin();
+      FLT area = size[0] * size[1];
+
+      if (area < min_area && prepared.IsPointInside(Pnt))
+        min_area = area, found = Wall;
+      return TRUE;
+    });
+
+  if (found == CurrPolyIndex)
+    return FALSE;
+  if (Result != nullptr)
+    *Result = found;
+  return TRUE;
+} /* End of 'location::FindPolygon' function */
+
+/* Triangulate location walls function.
+ * Builds constrained Delaunay triangulation, where every wall segment is an edge
+ * and polygons enclosed by other polygons are holes. Triangulation is kept,
+ * so if only points were moved after previous call it is updated locally.
+ * ARGUMENTS:
+ *   - index buffer to add triangles (three points pool indexes per triangle) to:
+ *       std::vector<size_t> *Triangles;
+ * RETURNS:
+ *   (BOOL) FALSE if some walls cross each other, TRUE otherwise.
+ */
+BOOL location::TriangulateWalls( std::vector<size_t> *Triangles ) const
+{
+  UINT64 generation = GetGeneration();
+  std::vector<size_t> moved;
+
+  // Triangulation with crossing walls misses some segments, so it is always built again
+  BOOL is_updated =
+    IsWallsTriangulated && !IsWallsEdited(WallsTriangulationGeneration) &&
+    GetChangedPoints(WallsTriangulationGeneration, &moved);
+  for (size_t i = 0; i < moved.size() && is_updated; i++)
+    is_updated = WallsTriangulator.MovePoint(moved[i]);
+  WallsTriangulationGeneration = generation;
+
+  if (is_updated)
+  {
+    WallsTriangulator.GetTriangles(Triangles);
+    return TRUE;
+  }
+  IsWallsTriangulated = WallsTriangulator.Triangulate(Walls, Triangles);
+  return IsWallsTriangulated;
+} /* End of 'location::TriangulateWalls' function */
+
+/* Get properties of every wall function.
+ * Walls stages run as tasks graph by blocks of walls: triangulation (with validation)
+ * and area with centroid are independent, containment of wall is found by point of its
+ * first triangle after its triangulation and point location index update.
+ * ARGUMENTS:
+ *   - walls properties container (one per wall):
+ *       std::vector<wall_info> *Infos;
  * RETURNS: None.
  */
-VOID DrawCircle( GLfloat X, GLfloat Y, GLfloat Radius )
+VOID location::GetWallsInfo( std::vector<wall_info> *Infos ) const
+{
+  task_graph graph;
+  size_t index_task = WallsIndexAddTasks(&graph);
+
+  Infos->assign(Walls.size(), wall_info());
+  for (size_t i = 0; i < Walls.size(); i += WallsBlockSize)
+  {
+    size_t end = mth::Min(i + WallsBlockSize, Walls.size());
+
+    // Area and centroid by signed areas of triangles with origin
+    graph.Add([this, Infos, i, end]( VOID )
+      {
+        for (size_t j = i; j < end; j++)
+        {
+          wall_info &info = (*Infos)[j];
+          DBL area = 0, cx = 0, cy = 0;
+
+          for (const segment &seg : Walls[j].Lines)
+          {
+            DBL
+              x0 = PointsPool[seg.St][0], y0 = PointsPool[seg.St][1],
+              x1 = PointsPool[seg.End][0], y1 = PointsPool[seg.End][1],
+              cross = x0 * y1 - x1 * y0;
+
+            area += cross;
+            cx += (x0 + x1) * cross;
+            cy += (y0 + y1) * cross;
+          }
+          info.Area = area / 2;
+          if (area != 0)
+            info.Centroid = vec2((FLT)(cx / (3 * area)), (FLT)(cy / (3 * area)));
+        }
+      });
+
+    // Triangulation, then containment by point inside first triangle
+    size_t triangulate_task = graph.Add([this, Infos, i, end]( VOID )
+      {
+        ear_clipping triangulator(PointsPool);
+
+        for (size_t j = i; j < end; j++)
+          (*Infos)[j].IsSimple = triangulator.Triangulate(Walls[j], &(*Infos)[j].Triangles);
+      });
+
+    std::vector<size_t> deps {triangulate_task};
+    if (index_task != (size_t)-1)
+      deps.push_back(index_task);
+    graph.Add([this, Infos, i, end]( VOID )
+      {
+        for (size_t j = i; j < end; j++)
+        {
+          wall_info &info = (*Infos)[j];
+          if (info.Triangles.empty())
+            continue;
+
+          vec2
+            pnt = (PointsPool[info.Triangles[0]] + PointsPool[info.Triangles[1]] + PointsPool[info.Triangles[2]]) / (FLT)3,
+            size = WallsPrepared[j].GetMax() - WallsPrepared[j].GetMin();
+          FLT min_area = INFINITY, wall_area = size[0] * size[1];
+
+          WallsBoxesTree.Query(pnt, pnt,
+            [&]( INT, const size_t &Wall ) -> BOOL
+            {
+              const prepared_polygon &prepared = WallsPrepared[Wall];
+              vec2 size = prepared.GetMax() - prepared.GetMin();
+              FLT area = size[0] * size[1];
+
+              if (Wall != j && area >= wall_area && area < min_area && prepared.IsPointInside(pnt))
+                min_area = area, info.Parent = Wall;
+              return TRUE;
+            });
+        }
+      }, deps);
+  }
+
+  Threads->Run(graph);
+} /* End of 'location::GetWallsInfo' function */
+
+/* Save location to binary file function.
+ * Points pool and walls are stored, current polygon is not.
+ * ARGUMENTS:
+ *   - file name:
+ *       const std::string &FileName;
+ * RETURNS:
+ *   (BOOL) whether location saved.
+ */
+BOOL location::Save( const std::string &FileName ) const
+{
+  return location_file::Save(FileName, PointsPool, Walls);
+} /* End of 'location::Save' function */
+
+/* Load location from binary file function.
+ * Loading is bulk copy plus indexes build, location does not keep viewing the mapping:
+ * points and walls lines are copied from mapped file with no parsing, then points pool grid index
+ * and walls segments tree (they are not stored in file) are built at once and file is closed.
+ * Points pool and walls own their arrays, because location is edited after loading.
+ * ARGUMENTS:
+ *   - file name:
+ *       const std::string &FileName;
+ * RETURNS:
+ *   (BOOL) FALSE if file is not valid location file (location is not changed then), TRUE otherwise.
+ */
+BOOL location::Load( const std::string &FileName )
 {
-  INT i;
-  INT lineAmount = 15;
+  location_file file;
+  if (!file.Open(FileName))
+    return FALSE;
+
+  Clear();
+  PointsPool.Assign(file.GetX(), file.GetY(), file.GetPointsCount());
+  Walls.resize(file.GetPolygonsCount());
+  for (size_t i = 0; i < Walls.size(); i++)
+  {
+    size_t lines_cnt;
+    const segment *lines = file.GetPolygon(i, &lines_cnt);
 
-  FLT twicePi = 2.0f * (FLT)mth::PI;
+    Walls[i].Lines.assign(lines, lines + lines_cnt);
+  }
+  SegmentsTreeBuild(0);
+  return TRUE;
+} /* End of 'location::Load' function */
+
+/* Import polygons dataset (WKT, GeoJSON or CSV) to walls function.
+ * Every polygon ring becomes wall as is, without merging with other walls,
+ * equal points of rings are merged.
+ * ARGUMENTS:
+ *   - file name:
+ *       const std::string &FileName;
+ * RETURNS:
+ *   (BOOL) FALSE if file can not be read, TRUE otherwise.
+ */
+BOOL location::Import( const std::string &FileName )
+{
+  location_import importer(PointsPool);
+  size_t first_wall = Walls.size();
 
-  glBegin(GL_LINE_LOOP);
-  for(i = 0; i <= lineAmount; i++)
-    glVertex2f(X + (Radius * cos(i * twicePi / lineAmount)), Y + (Radius * sin(i * twicePi / lineAmount)));
-  glEnd();
-} /* End of 'DrawCircle' function */
+  BOOL is_ok = importer.Import(FileName, &Walls);
+  SegmentsTreeBuild(first_wall);
+  return is_ok;
+} /* End of 'location::Import' function */
 
-/* Draw wall sections function.
+/* Merge all walls to one function.
+ * Walls are merged concurrently by pairs (see 'polygon::MergeAll'),
+ * so neighbour walls should go one after another (as rooms of imported plans do).
  * ARGUMENTS: None.
+ * RETURNS:
+ *   (BOOL) TRUE if merged outline is closed, FALSE if it may miss some walls parts (see 'polygon::MergeBuild').
+ */
+BOOL location::MergeWalls( VOID )
+{
+  if (Walls.size() <= 1)
+    return TRUE;
+
+  polygon merged;
+  BOOL is_closed = polygon::MergeAll(PointsPool, std::move(Walls), *Threads, &merged);
+  for (const std::vector<INT> &proxies : WallsProxies)
+    for (INT proxy : proxies)
+      SegmentsTree.Remove(proxy);
+  WallsProxies.clear();
+  Walls.clear();
+  Walls.push_back(std::move(merged));
+  SegmentsTreeBuild(0);
+  return is_closed;
+} /* End of 'location::MergeWalls' function */
+
+/* Apply boolean operation to walls and shapes function.
+ * Walls are subject and shapes are clip of operation (see 'polygon_boolean').
+ * ARGUMENTS:
+ *   - shapes (closed rings of points):
+ *       const std::vector<std::vector<vec2>> &Shapes;
+ *   - operation:
+ *       polygon_boolean::operation Op;
  * RETURNS: None.
  */
-VOID location::Draw( VOID ) const
+VOID location::WallsBoolean( const std::vector<std::vector<vec2>> &Shapes, polygon_boolean::operation Op )
 {
-  const auto DrawPolly = [&]( const polygon &Wall, BOOL IsCurrent )
+  std::vector<polygon> shapes, result;
+
+  for (const std::vector<vec2> &shape : Shapes)
   {
-    size_t cnt = Wall.Lines.size();
-    size_t i;
-    for (i = 0; i < cnt; i++)
+    polygon polly;
+
+    for (size_t i = 0; i < shape.size(); i++)
     {
-      glBegin(GL_LINES);
-      glColor3f(!IsCurrent * 0.4f, !IsCurrent * 0.8f, !IsCurrent * 0.3f);
-      glVertex2d(PointsPool[Wall.Lines[i].St][0], PointsPool[Wall.Lines[i].St][1]);
-      glVertex2d(PointsPool[Wall.Lines[i].End][0], PointsPool[Wall.Lines[i].End][1]);
-      DrawCircle(PointsPool[Wall.Lines[i].St][0], PointsPool[Wall.Lines[i].St][1], (FLT)PlaceingRadius);
-      DrawCircle(PointsPool[Wall.Lines[i].End][0], PointsPool[Wall.Lines[i].End][1], (FLT)PlaceingRadius);
-      glEnd();
-
-      std::string index;
-      index = std::to_string(Wall.Lines[i].St);
-      glRasterPos2d(PointsPool[Wall.Lines[i].St][0], PointsPool[Wall.Lines[i].St][1] + 0.03);
-      glutBitmapString(GLUT_BITMAP_HELVETICA_18, (const unsigned char *)index.c_str());
-      index = std::to_string(Wall.Lines[i].End);
-      glRasterPos2d(PointsPool[Wall.Lines[i].End][0], PointsPool[Wall.Lines[i].End][1] + 0.03);
-      glutBitmapString(GLUT_BITMAP_HELVETICA_18, (const unsigned char *)index.c_str());
+      size_t st = PointsPool.Add(shape[i]), end = PointsPool.Add(shape[(i + 1) % shape.size()]);
+
+      if (st != end)
+        polly.Lines.push_back(segment(st, end));
     }
-  };
+    if (!polly.Lines.empty())
+      shapes.push_back(std::move(polly));
+  }
 
-  for (const auto &wall: Walls)
-    DrawPolly(wall, FALSE);
-  DrawPolly(CurrPoly, TRUE);
-} /* End pf 'location::Draw' function */
\ No newline at end of file
+  polygon_boolean(PointsPool).Compute(Walls, shapes, Op, &result);
+  for (const std::vector<INT> &proxies : WallsProxies)
+    for (INT proxy : proxies)
+      SegmentsTree.Remove(proxy);
+  WallsProxies.clear();
+  Walls = std::move(result);
+  SegmentsTreeBuild(0);
+} /* End of 'location::WallsBoolean' function */
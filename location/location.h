@@ -2,13 +2,19 @@
 #define __location_h_
 
 #include "location_points_pool.h"
+#include "location_arena.h"
+#include "location_aabb_tree.h"
+#include "location_prepared_polygon.h"
+#include "location_delaunay.h"
+#include "location_thread_pool.h"
+#include "location_boolean.h"
 
 /* Polygon segment class. */
 class segment
 {
 public:
-  // Indexes of segment start and end points in location points pool.
-  size_t St, End;
+  // Indexes of segment start and end points in location points pool (32-bit to keep segment 8 bytes).
+  UINT32 St, End;
 
   /* Section default constructor. */
   segment( VOID ) = default;
@@ -26,15 +32,19 @@ public:
 
   /* Get Point-Line distance function.
    * ARGUMENTS:
+   *   - points pool of segment points:
+   *       const points_pool &Pool;
    *   - point:
    *       const vec2 &Pnt;
    * RETURNS:
    *   (FLT) distance between point and line.
    */
-  FLT GetPointDistance( const vec2 &Pnt ) const;
+  FLT GetPointDistance( const points_pool &Pool, const vec2 &Pnt ) const;
 
   /* Get location of a point in a plane relative to a straight line function.
    * ARGUMENTS:
+   *   - points pool of segment points:
+   *       const points_pool &Pool;
    *   - point:
    *       const vec2 &Pnt;
    * RETURNS:
@@ -42,10 +52,14 @@ public:
    *          0 - point is on the line,
    *          1 - point in on the left half-plane.
    */
-  INT GetPointHalfPlaneLocation( const vec2 &Pnt ) const;
+  INT GetPointHalfPlaneLocation( const points_pool &Pool, const vec2 &Pnt ) const;
 
   /* Intersect two lines function.
+   * Segments intersect if they cross or touch (decided by exact predicates),
+   * collinear ones only if segment start matches one of line points.
    * ARGUMENTS:
+   *   - points pool of segment points:
+   *       const points_pool &Pool;
    *   - two points, setting line to intersect with:
    *       const vec2 &P0, const vec2 &P1;
    *   - variable to set result in:
@@ -53,42 +67,157 @@ public:
    * RETURNS:
    *   (BOOL) Whether lines intersected or not.
    */
-  BOOL Intersect( const vec2 &P0, const vec2 &P1, vec2 *Result = nullptr ) const;
+  BOOL Intersect( const points_pool &Pool, const vec2 &P0, const vec2 &P1, vec2 *Result = nullptr ) const;
 }; /* end of 'segment' class */
 
 /* Polygon class. */
 class polygon
 {
+private:
+  /* Polygons merging intermediate data.
+   * Merge is split to stages and only points adding one changes points pool,
+   * so other stages of different merges could run concurrently.
+   * All merge data and stages scratch memory are taken from own arena and released at once,
+   * prepared polygon keeps its buffers between merges (it is made again only for another points pool
+   * or after memory of merge data is limited).
+   */
+  struct merge_data
+  {
+    static const size_t KeptMemory = 1 << 20;  // Arena memory kept by merge data between single merges
+    arena Arena;                                // Merge memory arena
+    arena_vector<size_t> Sides {&Arena};        // Side of every intersection point (lines of first polygon, then of second one)
+    arena_vector<FLT> X {&Arena}, Y {&Arena};   // Intersection points coordinates
+    arena_vector<size_t> Points {&Arena};       // Intersection points indexes in pool
+    BOOL IsIntersection = FALSE;                // Whether any segments in polygons intersected
+    std::unique_ptr<prepared_polygon> Prepared; // Polygon for containment checks of not intersecting polygons
+
+    /* Clear data for next merge function.
+     * ARGUMENTS:
+     *   - maximal size of kept arena memory in bytes (prepared polygon is dropped too if it is limited):
+     *       size_t MaxKept;
+     * RETURNS: None.
+     */
+    VOID Clear( size_t MaxKept = (size_t)-1 )
+    {
+      // Vectors drop arena memory before it is released
+      Sides = arena_vector<size_t>(&Arena);
+      X = arena_vector<FLT>(&Arena), Y = arena_vector<FLT>(&Arena);
+      Points = arena_vector<size_t>(&Arena);
+      IsIntersection = FALSE;
+      Arena.Release(MaxKept);
+      if (MaxKept != (size_t)-1)
+        Prepared.reset();
+    } /* End of 'Clear' function */
+  }; /* end of 'merge_data' struct */
+
+  /* Find intersection points of polygons sides function (merge stage, points pool is not changed).
+   * ARGUMENTS:
+   *   - points pool of polygons points:
+   *       const points_pool &Pool;
+   *   - polygon to merge with:
+   *       const polygon &Polly;
+   *   - merge data to fill:
+   *       merge_data *Data;
+   * RETURNS: None.
+   */
+  VOID MergeIntersect( const points_pool &Pool, const polygon &Polly, merge_data *Data ) const;
+
+  /* Add intersection points to points pool function (merge stage).
+   * ARGUMENTS:
+   *   - points pool to add points to:
+   *       points_pool &Pool;
+   *   - merge data:
+   *       merge_data *Data;
+   * RETURNS: None.
+   */
+  static VOID MergeAddPoints( points_pool &Pool, merge_data *Data );
+
+  /* Build merged polygon by intersection points function (merge stage, points pool is not changed).
+   * ARGUMENTS:
+   *   - points pool of polygons points:
+   *       const points_pool &Pool;
+   *   - polygon to merge with:
+   *       const polygon &Polly;
+   *   - merge data (its arena is used for scratch memory):
+   *       merge_data *Data;
+   *   - polygon to set merged one in:
+   *       polygon *Merged;
+   * RETURNS:
+   *   (BOOL) TRUE if merged outline is closed, FALSE if some its walk did not come back to start point.
+   */
+  BOOL MergeBuild( const points_pool &Pool, const polygon &Polly, merge_data *Data, polygon *Merged ) const;
+
 public:
   std::vector<segment> Lines; // Polygon side lines container
 
   /* Merge polygons function.
    * ARGUMENTS:
+   *   - points pool of polygons points (intersection points are added to it):
+   *       points_pool &Pool;
    *   - polygon to merge with:
    *       const polygon &Polly1, const polygon &Polly2;
    *   - polygon to set merged one in:
    *       polygon *Merged;
+   * RETURNS:
+   *   (BOOL) TRUE if merged outline is closed, FALSE if some its walk did not come back to start point (see 'MergeBuild').
+   */
+  BOOL Merge( points_pool &Pool, const polygon &Polly, polygon *Merged ) const;
+
+  /* Merge many polygons function.
+   * Polygons are merged by pairs in rounds of balanced reduction tree, merges of every round
+   * run concurrently (except adding intersection points to pool, done in polygons order).
+   * ARGUMENTS:
+   *   - points pool of polygons points (intersection points are added to it):
+   *       points_pool &Pool;
+   *   - polygons to merge:
+   *       std::vector<polygon> Pollys;
+   *   - threads pool to run merges in:
+   *       thread_pool &Threads;
+   *   - polygon to set merged one in:
+   *       polygon *Merged;
+   * RETURNS:
+   *   (BOOL) TRUE if all merged outlines are closed, FALSE if some walk did not come back to start point (see 'MergeBuild').
+   */
+  static BOOL MergeAll( points_pool &Pool, std::vector<polygon> Pollys, thread_pool &Threads, polygon *Merged );
+
+  /* Find segments pairs of two polygons with overlapping bounding boxes by sweep line function.
+   * Sweep line goes by x, segments crossed by it are kept ordered by y (unless there are only a few of them),
+   * so every query visits only y-overlapping segments: O((n + k) log n) for n segments and k pairs,
+   * even if all x ranges overlap.
+   * ARGUMENTS:
+   *   - points pool of polygons points:
+   *       const points_pool &Pool;
+   *   - polygon to find overlapping segments with:
+   *       const polygon &Polly;
+   *   - pairs of segments indexes (this polygon segment, another polygon segment) container,
+   *     sorted by first index, then by second (its arena is used for scratch memory):
+   *       arena_vector<std::pair<size_t, size_t>> *Pairs;
    * RETURNS: None.
    */
-  VOID Merge( const polygon &Polly, polygon *Merged ) const;
+  VOID GetOverlappingSegments( const points_pool &Pool, const polygon &Polly, arena_vector<std::pair<size_t, size_t>> *Pairs ) const;
 
   /* Check if point inside polygon.
    * ARGUMENTS:
+   *   - points pool of polygon points:
+   *       const points_pool &Pool;
    *   - point to check:
    *       const vec3 &Pnt;
    * RETURNS:
    *   (BOOL) whether point in polygon or not.
    */
-  BOOL IsPointInside( const vec2 &Pnt ) const;
+  BOOL IsPointInside( const points_pool &Pool, const vec2 &Pnt ) const;
 }; /* end of 'polygon' struct */
 
-/* Location representation class. */
+class location_render;
+
+/* Location representation class.
+ * Location is not thread safe: const queries ('FindPolygon', 'TriangulateWalls', 'GetWallsInfo', 'Draw')
+ * update lazily built caches without locks, so one location should be used by one thread at a time
+ * (its stages run in parallel by threads pool). Different locations may be used concurrently.
+ */
 class location
 {
 private:
-  friend class segment;
-  friend class polygon;
-
   /* Currently editing polygon structure. */
   struct current_polygon : polygon
   {
@@ -97,18 +226,333 @@ private:
     BOOL ShouldMerge = 1; // Displays should polygon be merged after closing
   }; /* end of 'current_polygon' struct */
 
-  static points_pool PointsPool;   // All location points pool
-  const DBL PlaceingRadius = 0.03; // Points  for segments placment radius
-  current_polygon CurrPoly {};    // Currently editing polygon
+  /* Reference to segment stored in segments tree. */
+  struct segment_ref
+  {
+    segment Seg;    // Referenced segment
+    size_t Polygon; // Index of polygon in walls (CurrPolyIndex for current polygon)
+    size_t Line;    // Index of segment in polygon lines
+  }; /* end of 'segment_ref' struct */
+
+  static const size_t CurrPolyIndex = -1; // Current polygon index in segments references
+
+  /* Changes of indexed items (points or walls) structure.
+   * Every item keeps generation of its last change, log keeps (generation, item) pairs
+   * sorted by generation, so items changed after some generation are found without scanning all items.
+   */
+  struct changes
+  {
+    std::vector<UINT64> Generations;            // Last change generation of every item (0 - not changed)
+    std::vector<std::pair<UINT64, size_t>> Log; // Changes log
+    size_t Count = 0;                           // Items count at last synchronization
+
+    /* Mark item as changed function.
+     * ARGUMENTS:
+     *   - item index:
+     *       size_t Index;
+     *   - change generation:
+     *       UINT64 Generation;
+     * RETURNS: None.
+     */
+    VOID Change( size_t Index, UINT64 Generation );
+
+    /* Mark added or removed items as changed function.
+     * ARGUMENTS:
+     *   - new items count:
+     *       size_t NewCount;
+     *   - change generation:
+     *       UINT64 Generation;
+     * RETURNS: None.
+     */
+    VOID Sync( size_t NewCount, UINT64 Generation );
+
+    /* Get items changed after generation function.
+     * ARGUMENTS:
+     *   - generation to get changes after:
+     *       UINT64 Since;
+     *   - changed items indexes container:
+     *       std::vector<size_t> *Changed;
+     * RETURNS: None.
+     */
+    VOID Get( UINT64 Since, std::vector<size_t> *Changed ) const;
+
+    /* Clear changes function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Clear( VOID );
+  }; /* end of 'changes' struct */
+
+  static const size_t WallsBlockSize;      // Walls count processed by one task of walls stages
+  static thread_pool SharedThreads;        // Threads for parallel processing of locations without own pool
+  thread_pool *Threads = &SharedThreads;   // Threads for parallel processing
+  points_pool PointsPool {PlaceingRadius}; // Location points pool, grid cell matches placing radius
+  current_polygon CurrPoly {};             // Currently editing polygon
+  size_t MovingPoint = -1;                 // Index of point moved by 'MovePoint' (-1 if not found)
+  BOOL IsMoveStarted = FALSE;              // Whether point moving is started
+
+  aabb_tree<segment_ref> SegmentsTree {(FLT)PlaceingRadius}; // All location segments bounding boxes tree
+  std::vector<std::vector<INT>> WallsProxies;                // Segments tree proxies of every wall lines
+  std::vector<INT> CurrPolyProxies;                          // Segments tree proxies of current polygon lines
+
+  // Changes tracking, changes of every generation are closed when somebody asks for them
+  mutable UINT64 Generation = 0;         // Last closed changes generation
+  mutable UINT64 ResetGeneration = 0;    // Generation of last location clear
+  mutable UINT64 CurrPolyGeneration = 0; // Generation of last current polygon change
+  mutable UINT64 WallsEditGeneration = 0; // Generation of last walls segments change (not points moving)
+  mutable BOOL IsChanged = FALSE;        // Are there changes in not closed generation
+  mutable changes PointsChanges;         // Points changes
+  mutable changes WallsChanges;          // Walls changes
+
+  // Walls point location index, walls are prepared again lazily only if changed
+  mutable std::vector<prepared_polygon> WallsPrepared; // Prepared polygon of every wall
+  mutable UINT64 WallsIndexGeneration = 0;             // Changes generation index is built for
+  mutable std::vector<INT> WallsBoxesProxies;          // Walls bounding boxes tree proxies (-1 for empty wall)
+  mutable aabb_tree<size_t> WallsBoxesTree;            // Walls bounding boxes tree
+
+  // Walls triangulation, while walls are not edited it is updated by moved points only
+  mutable delaunay WallsTriangulator {PointsPool};   // Walls triangulation
+  mutable UINT64 WallsTriangulationGeneration = 0; // Changes generation triangulation is built for
+  mutable BOOL IsWallsTriangulated = FALSE;        // Is triangulation built without crossing walls
+
+  // Location renderer, made by first drawing (only GUI project has it), keeps location geometry between frames
+  mutable std::shared_ptr<location_render> Renderer;
+
+  /* Get polygon by segments reference index function.
+   * ARGUMENTS:
+   *   - polygon index (CurrPolyIndex for current polygon):
+   *       size_t Index;
+   * RETURNS:
+   *   (const polygon &) polygon.
+   */
+  const polygon &GetPolygon( size_t Index ) const
+  {
+    return Index == CurrPolyIndex ? CurrPoly : Walls[Index];
+  } /* End of 'GetPolygon' function */
+
+  /* Get proxies of polygon lines function.
+   * ARGUMENTS:
+   *   - polygon index (CurrPolyIndex for current polygon):
+   *       size_t Index;
+   * RETURNS:
+   *   (std::vector<INT> &) polygon lines proxies.
+   */
+  std::vector<INT> &GetPolygonProxies( size_t Index )
+  {
+    if (Index == CurrPolyIndex)
+      return CurrPolyProxies;
+    if (WallsProxies.size() <= Index)
+      WallsProxies.resize(Index + 1);
+    return WallsProxies[Index];
+  } /* End of 'GetPolygonProxies' function */
+
+  /* Add polygon segment to segments tree function.
+   * ARGUMENTS:
+   *   - polygon index (CurrPolyIndex for current polygon):
+   *       size_t Polygon;
+   *   - segment index in polygon:
+   *       size_t Line;
+   * RETURNS: None.
+   */
+  VOID SegmentsTreeAdd( size_t Polygon, size_t Line );
+
+  /* Add walls segments to segments tree at once function.
+   * ARGUMENTS:
+   *   - first wall to add (walls from it should not have segments in tree yet):
+   *       size_t FirstWall;
+   * RETURNS: None.
+   */
+  VOID SegmentsTreeBuild( size_t FirstWall );
+
+  /* Synchronize segments tree with polygon lines function.
+   * Proxies of segments which are still present in polygon are reused,
+   * so only really changed lines touch the tree.
+   * ARGUMENTS:
+   *   - polygon index (CurrPolyIndex for current polygon):
+   *       size_t Polygon;
+   *   - proxies, which could be reused (will be emptied):
+   *       std::vector<INT> &OldProxies;
+   * RETURNS: None.
+   */
+  VOID SegmentsTreeUpdate( size_t Polygon, std::vector<INT> &OldProxies );
+
+  /* Update bounding boxes of segments with moved point function.
+   * ARGUMENTS:
+   *   - moved point index:
+   *       size_t Index;
+   *   - point possition before moving:
+   *       const vec2 &OldPnt;
+   * RETURNS: None.
+   */
+  VOID SegmentsTreeMovePoint( size_t Index, const vec2 &OldPnt );
+
+  /* Mark point as changed function.
+   * ARGUMENTS:
+   *   - point index:
+   *       size_t Index;
+   * RETURNS: None.
+   */
+  VOID ChangePoint( size_t Index )
+  {
+    PointsChanges.Change(Index, Generation + 1);
+    IsChanged = TRUE;
+  } /* End of 'ChangePoint' function */
+
+  /* Mark polygon as changed function.
+   * ARGUMENTS:
+   *   - polygon index (CurrPolyIndex for current polygon):
+   *       size_t Polygon;
+   *   - are polygon segments changed (FALSE if only its points moved):
+   *       BOOL IsEdited;
+   * RETURNS: None.
+   */
+  VOID ChangePolygon( size_t Polygon, BOOL IsEdited = TRUE )
+  {
+    if (Polygon == CurrPolyIndex)
+      CurrPolyGeneration = Generation + 1;
+    else
+    {
+      WallsChanges.Change(Polygon, Generation + 1);
+      if (IsEdited)
+        WallsEditGeneration = Generation + 1;
+    }
+    IsChanged = TRUE;
+  } /* End of 'ChangePolygon' function */
+
+  /* Close current changes generation function.
+   * Points and walls added or removed directly are marked as changed here.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID ChangesSync( VOID ) const;
+
+  /* Prepare changed walls in point location index function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID WallsIndexUpdate( VOID ) const;
+
+  /* Add point location index updating tasks to graph function.
+   * Changed walls are prepared by blocks concurrently, then bounding boxes tree is updated,
+   * index is treated as updated at once, so graph should be run before index is used.
+   * ARGUMENTS:
+   *   - graph to add tasks to:
+   *       task_graph *Graph;
+   * RETURNS:
+   *   (size_t) index of last task (index is updated after it), -1 if index is up to date.
+   */
+  size_t WallsIndexAddTasks( task_graph *Graph ) const;
 
 public:
+  /* Wall properties structure. */
+  struct wall_info
+  {
+    DBL Area = 0;                  // Wall area (rings areas are summed with signs of their orientation)
+    vec2 Centroid {0};             // Wall area centroid
+    size_t Parent = -1;            // Index of wall containing this one (smallest by bounding box, -1 if none)
+    BOOL IsSimple = FALSE;         // Whether wall rings are simple (triangulated without crossings)
+    std::vector<size_t> Triangles; // Wall rings ear clipping triangles (three points pool indexes per triangle)
+  }; /* end of 'wall_info' struct */
+
+  static const DBL PlaceingRadius; // Points  for segments placment radius
+
   // For test public, remove later
   std::vector<polygon> Walls; // Location walls
 
+  /* Location default constructor (threads pool is shared by such locations). */
+  location( VOID ) = default;
+
+  /* Location constructor.
+   * ARGUMENTS:
+   *   - threads pool for parallel processing (should live longer than location):
+   *       thread_pool &Threads;
+   */
+  location( thread_pool &Threads ) : Threads(&Threads)
+  {
+  } /* End of 'location' function */
+
+  /* Location copying is not allowed (triangulators and prepared polygons refer to its points pool). */
+  location( const location & ) = delete;
+  location &operator=( const location & ) = delete;
+
   //
   // Points pool functions
   //
 
+  /* Get location changes generation function.
+   * Generation grows after every change, derived data remembers generation it
+   * was built for and asks for changes after it.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (UINT64) current generation.
+   */
+  UINT64 GetGeneration( VOID ) const
+  {
+    ChangesSync();
+    return Generation;
+  } /* End of 'GetGeneration' function */
+
+  /* Get points changed after generation function.
+   * Indexes not less than points count are removed points.
+   * ARGUMENTS:
+   *   - generation to get changes after:
+   *       UINT64 Since;
+   *   - changed points indexes container:
+   *       std::vector<size_t> *Points;
+   * RETURNS:
+   *   (BOOL) FALSE if location was cleared after generation (everything should be rebuilt), TRUE otherwise.
+   */
+  BOOL GetChangedPoints( UINT64 Since, std::vector<size_t> *Points ) const;
+
+  /* Get walls changed after generation function.
+   * Indexes not less than walls count are removed walls.
+   * ARGUMENTS:
+   *   - generation to get changes after:
+   *       UINT64 Since;
+   *   - changed walls indexes container:
+   *       std::vector<size_t> *Walls;
+   * RETURNS:
+   *   (BOOL) FALSE if location was cleared after generation (everything should be rebuilt), TRUE otherwise.
+   */
+  BOOL GetChangedWalls( UINT64 Since, std::vector<size_t> *Walls ) const;
+
+  /* Check if current polygon changed after generation function.
+   * ARGUMENTS:
+   *   - generation to check changes after:
+   *       UINT64 Since;
+   * RETURNS:
+   *   (BOOL) whether current polygon changed or not.
+   */
+  BOOL IsCurrPolyChanged( UINT64 Since ) const
+  {
+    ChangesSync();
+    return CurrPolyGeneration > Since || ResetGeneration > Since;
+  } /* End of 'IsCurrPolyChanged' function */
+
+  /* Check if walls segments changed after generation function.
+   * Walls with only moved points are not counted as edited.
+   * ARGUMENTS:
+   *   - generation to check changes after:
+   *       UINT64 Since;
+   * RETURNS:
+   *   (BOOL) whether walls edited or not.
+   */
+  BOOL IsWallsEdited( UINT64 Since ) const
+  {
+    ChangesSync();
+    return WallsEditGeneration > Since || ResetGeneration > Since;
+  } /* End of 'IsWallsEdited' function */
+
+  /* Get location points pool function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (const points_pool &) points pool.
+   */
+  const points_pool &GetPointsPool( VOID ) const
+  {
+    return PointsPool;
+  } /* End of 'GetPointsPool' function */
+
   /* Find point function.
    * ARGUMENTS:
    *   - point to find:
@@ -133,7 +577,20 @@ public:
    * RETURNS:
    *   (BOOL) wheather point found or not.
    */
-  BOOL FindPoint( const vec2 &Pnt, BOOL FindOnLines, size_t *Result ) const;
+  BOOL FindPoint( const vec2 &Pnt, BOOL FindOnLines, size_t *Result );
+
+  /* Find wall containing point function.
+   * Walls are checked only if their bounding boxes contain point, if point is inside
+   * several nested walls, one with smallest bounding box is chosen.
+   * ARGUMENTS:
+   *   - point to find wall of:
+   *       const vec2 &Pnt;
+   *   - variable to set index of found wall in:
+   *       size_t *Result;
+   * RETURNS:
+   *   (BOOL) wheather wall found or not.
+   */
+  BOOL FindPolygon( const vec2 &Pnt, size_t *Result = nullptr ) const;
 
   /* Add point to the pool or return existing.
    * ARGUMENTS:
@@ -155,25 +612,28 @@ public:
    */
   VOID MovePoint( const vec2 &Point, BOOL IsEnd = FALSE)
   {
-    static size_t Index;
-    static BOOL IsMoveStarted;
-
     if (IsEnd)
     {
       IsMoveStarted = FALSE;
-      Index = -1;
+      MovingPoint = -1;
       return;
     }
 
     if (!IsMoveStarted)
     {
-      if (!FindPoint(Point, FALSE, &Index))
+      if (!FindPoint(Point, FALSE, &MovingPoint))
         return;
       IsMoveStarted = TRUE;
     }
 
-    if (Index != -1)
-      PointsPool[Index] = Point;
+    if (MovingPoint != (size_t)-1)
+    {
+      vec2 old_pnt = PointsPool[MovingPoint];
+
+      PointsPool.Set(MovingPoint, Point);
+      ChangePoint(MovingPoint);
+      SegmentsTreeMovePoint(MovingPoint, old_pnt);
+    }
   } /* End of 'MovePoint' function */
 
   //
@@ -258,7 +718,7 @@ public:
                        PointsPool[last_seg.End][1] - PointsPool[last_seg.St][1]);
 
     // Build normal by rotating segment to 90 or 270 degrees
-    if (last_seg.GetPointHalfPlaneLocation(Point) == 1)
+    if (last_seg.GetPointHalfPlaneLocation(PointsPool, Point) == 1)
       norm = vec2(-last_line[1], last_line[0]);
     else
       norm = vec2(last_line[1], -last_line[0]);
@@ -271,22 +731,38 @@ public:
     return norm;
   } /* End of 'CurrPolyGetPerpPoint' function */
 
+  /* Check if current polygon has placed segments function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (BOOL) whether current polygon editing started.
+   */
+  BOOL CurrPolyIsEditing( VOID ) const
+  {
+    return CurrPoly.IsEditing;
+  } /* End of 'CurrPolyIsEditing' function */
+
   /* Destroy last segment in current polygon function.
    * ARGUMENTS: None.
    * RETURNS: None.
    */
   VOID CurrPolyDestroyLastSegment( VOID )
   {
-    size_t l = CurrPoly.Lines.size(), p = PointsPool.Points.size();
+    size_t l = CurrPoly.Lines.size(), p = PointsPool.Size();
 
     // If end point of last segment is used only in last line delete it point
     if (p > 2 && p > l + 2 && CurrPolyLastLineEndIndex() == p - 1)
-      PointsPool.Points.pop_back();
+    {
+      ChangePoint(p - 1);
+      PointsPool.PopBack();
+    }
 
     if (l > 0)
     {
       // Delete segment
       CurrPoly.Lines.pop_back();
+      SegmentsTree.Remove(CurrPolyProxies.back());
+      CurrPolyProxies.pop_back();
+      ChangePolygon(CurrPolyIndex);
 
       // If last existing segment deleted checnge editing mode
       if (CurrPoly.Lines.size() == 0)
@@ -312,15 +788,109 @@ public:
    */
   VOID OptimizePointsPool( VOID );
 
+  /* Triangulate location walls function.
+   * Builds constrained Delaunay triangulation, where every wall segment is an edge
+   * and polygons enclosed by other polygons are holes. Triangulation is kept,
+   * so if only points were moved after previous call it is updated locally.
+   * ARGUMENTS:
+   *   - index buffer to add triangles (three points pool indexes per triangle) to:
+   *       std::vector<size_t> *Triangles;
+   * RETURNS:
+   *   (BOOL) FALSE if some walls cross each other, TRUE otherwise.
+   */
+  BOOL TriangulateWalls( std::vector<size_t> *Triangles ) const;
+
+  /* Drop kept walls triangulation function.
+   * Next 'TriangulateWalls' call builds triangulation from scratch.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID ResetTriangulation( VOID )
+  {
+    IsWallsTriangulated = FALSE;
+  } /* End of 'ResetTriangulation' function */
+
+  /* Get properties of every wall function.
+   * Walls stages run as tasks graph by blocks of walls: triangulation (with validation)
+   * and area with centroid are independent, containment of wall is found by point of its
+   * first triangle after its triangulation and point location index update.
+   * ARGUMENTS:
+   *   - walls properties container (one per wall):
+   *       std::vector<wall_info> *Infos;
+   * RETURNS: None.
+   */
+  VOID GetWallsInfo( std::vector<wall_info> *Infos ) const;
+
+  /* Save location to binary file function.
+   * Points pool and walls are stored, current polygon is not.
+   * ARGUMENTS:
+   *   - file name:
+   *       const std::string &FileName;
+   * RETURNS:
+   *   (BOOL) whether location saved.
+   */
+  BOOL Save( const std::string &FileName ) const;
+
+  /* Load location from binary file function.
+   * Loading is bulk copy plus indexes build, location does not keep viewing the mapping:
+   * points and walls lines are copied from mapped file with no parsing, then points pool grid index
+   * and walls segments tree (they are not stored in file) are built at once and file is closed.
+   * Points pool and walls own their arrays, because location is edited after loading.
+   * ARGUMENTS:
+   *   - file name:
+   *       const std::string &FileName;
+   * RETURNS:
+   *   (BOOL) FALSE if file is not valid location file (location is not changed then), TRUE otherwise.
+   */
+  BOOL Load( const std::string &FileName );
+
+  /* Import polygons dataset (WKT, GeoJSON or CSV) to walls function.
+   * Every polygon ring becomes wall as is, without merging with other walls,
+   * equal points of rings are merged.
+   * ARGUMENTS:
+   *   - file name:
+   *       const std::string &FileName;
+   * RETURNS:
+   *   (BOOL) FALSE if file can not be read, TRUE otherwise.
+   */
+  BOOL Import( const std::string &FileName );
+
+  /* Merge all walls to one function.
+   * Walls are merged concurrently by pairs (see 'polygon::MergeAll'),
+   * so neighbour walls should go one after another (as rooms of imported plans do).
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (BOOL) TRUE if merged outline is closed, FALSE if it may miss some walls parts (see 'polygon::MergeBuild').
+   */
+  BOOL MergeWalls( VOID );
+
+  /* Apply boolean operation to walls and shapes function.
+   * Walls are subject and shapes are clip of operation (see 'polygon_boolean').
+   * ARGUMENTS:
+   *   - shapes (closed rings of points):
+   *       const std::vector<std::vector<vec2>> &Shapes;
+   *   - operation:
+   *       polygon_boolean::operation Op;
+   * RETURNS: None.
+   */
+  VOID WallsBoolean( const std::vector<std::vector<vec2>> &Shapes, polygon_boolean::operation Op );
+
   /* Clear location function.
    * ARGUMENTS: None.
    * RETURNS: None.
    */
   VOID Clear(VOID)
   {
-    PointsPool.Points.clear();
+    PointsPool.Clear();
     Walls.clear();
     CurrPoly.Lines.clear();
+    SegmentsTree.Clear();
+    WallsProxies.clear();
+    CurrPolyProxies.clear();
+    PointsChanges.Clear();
+    WallsChanges.Clear();
+    ResetGeneration = CurrPolyGeneration = Generation + 1;
+    IsChanged = TRUE;
     CurrPoly.Start = 0;
     CurrPoly.IsEditing = 0;
     CurrPoly.ShouldMerge = 1;
@@ -331,6 +901,14 @@ public:
    * RETURNS: None.
    */
   VOID Draw( VOID ) const;
+
+  /* Set points labels density function.
+   * ARGUMENTS:
+   *   - minimal distance between labels in pixels (0 to show all labels):
+   *       FLT Pixels;
+   * RETURNS: None.
+   */
+  VOID SetLabelsSpacing( FLT Pixels );
 }; /* end of 'location' class */
 
 #endif /* __location_h_ */
\ No newline at end of file
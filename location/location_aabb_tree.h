@@ -0,0 +1,556 @@
+#ifndef __location_aabb_tree_h_
+#define __location_aabb_tree_h_
+
+#include <algorithm>
+
+#include "../def.h"
+
+/* Dynamic axis aligned bounding boxes tree class.
+ * Leaves store enlarged ('fat') boxes, so small movements of objects
+ * do not require tree restructuring. Tree is kept balanced by rotations.
+ */
+template<class Type>
+  class aabb_tree
+  {
+  private:
+    /* Tree node structure. */
+    struct node
+    {
+      vec2 Min, Max;     // Node bounding box
+      INT Parent = -1;   // Parent node index (next free node index for free nodes)
+      INT Left = -1;     // Left child index (-1 for leaves)
+      INT Right = -1;    // Right child index (-1 for leaves)
+      INT Height = -1;   // Node height in tree (0 for leaves, -1 for free nodes)
+      Type Data {};      // User data stored in leaf
+    }; /* end of 'node' struct */
+
+    std::vector<node> Nodes; // Tree nodes storage
+    INT Root = -1;           // Root node index
+    INT FreeList = -1;       // First free node index
+    FLT Margin;              // Leaves boxes enlargement
+
+    /* Get box perimeter function (cost of box in tree).
+     * ARGUMENTS:
+     *   - box:
+     *       const vec2 &Min, const vec2 &Max;
+     * RETURNS:
+     *   (FLT) box perimeter.
+     */
+    static FLT GetPerimeter( const vec2 &Min, const vec2 &Max )
+    {
+      return 2 * (Max[0] - Min[0] + Max[1] - Min[1]);
+    } /* End of 'GetPerimeter' function */
+
+    /* Get union of two boxes perimeter function.
+     * ARGUMENTS:
+     *   - nodes to unite boxes of:
+     *       const node &A, const node &B;
+     * RETURNS:
+     *   (FLT) union box perimeter.
+     */
+    static FLT GetUnionPerimeter( const node &A, const node &B )
+    {
+      return GetPerimeter(vec2::Min(A.Min, B.Min), vec2(mth::Max(A.Max[0], B.Max[0]), mth::Max(A.Max[1], B.Max[1])));
+    } /* End of 'GetUnionPerimeter' function */
+
+    /* Check if first box contains second function.
+     * ARGUMENTS:
+     *   - boxes:
+     *       const vec2 &MinA, const vec2 &MaxA, const vec2 &MinB, const vec2 &MaxB;
+     * RETURNS:
+     *   (BOOL) whether first box contains second.
+     */
+    static BOOL IsContains( const vec2 &MinA, const vec2 &MaxA, const vec2 &MinB, const vec2 &MaxB )
+    {
+      return MinA[0] <= MinB[0] && MinA[1] <= MinB[1] && MaxA[0] >= MaxB[0] && MaxA[1] >= MaxB[1];
+    } /* End of 'IsContains' function */
+
+    /* Check if boxes overlap function.
+     * ARGUMENTS:
+     *   - boxes:
+     *       const vec2 &MinA, const vec2 &MaxA, const vec2 &MinB, const vec2 &MaxB;
+     * RETURNS:
+     *   (BOOL) whether boxes overlap.
+     */
+    static BOOL IsOverlap( const vec2 &MinA, const vec2 &MaxA, const vec2 &MinB, const vec2 &MaxB )
+    {
+      return MinA[0] <= MaxB[0] && MinA[1] <= MaxB[1] && MaxA[0] >= MinB[0] && MaxA[1] >= MinB[1];
+    } /* End of 'IsOverlap' function */
+
+    /* Recalculate node box and height by its children function.
+     * ARGUMENTS:
+     *   - node index:
+     *       INT Index;
+     * RETURNS: None.
+     */
+    VOID Refit( INT Index )
+    {
+      node &n = Nodes[Index];
+      const node &l = Nodes[n.Left], &r = Nodes[n.Right];
+
+      n.Min = vec2::Min(l.Min, r.Min);
+      n.Max = vec2(mth::Max(l.Max[0], r.Max[0]), mth::Max(l.Max[1], r.Max[1]));
+      n.Height = 1 + mth::Max(l.Height, r.Height);
+    } /* End of 'Refit' function */
+
+    /* Allocate new node function.
+     * ARGUMENTS: None.
+     * RETURNS:
+     *   (INT) new node index.
+     */
+    INT AllocNode( VOID )
+    {
+      if (FreeList == -1)
+      {
+        Nodes.push_back(node());
+        Nodes.back().Height = 0;
+        return (INT)Nodes.size() - 1;
+      }
+
+      INT index = FreeList;
+      FreeList = Nodes[index].Parent;
+      Nodes[index] = node();
+      Nodes[index].Height = 0;
+      return index;
+    } /* End of 'AllocNode' function */
+
+    /* Free node function.
+     * ARGUMENTS:
+     *   - node index:
+     *       INT Index;
+     * RETURNS: None.
+     */
+    VOID FreeNode( INT Index )
+    {
+      Nodes[Index].Parent = FreeList;
+      Nodes[Index].Height = -1;
+      FreeList = Index;
+    } /* End of 'FreeNode' function */
+
+    /* Balance subtree by rotation function.
+     * ARGUMENTS:
+     *   - subtree root index:
+     *       INT A;
+     * RETURNS:
+     *   (INT) new subtree root index.
+     */
+    INT Balance( INT A )
+    {
+      node &a = Nodes[A];
+      if (a.Left == -1 || a.Height < 2)
+        return A;
+
+      INT B = a.Left, C = a.Right;
+      INT balance = Nodes[C].Height - Nodes[B].Height;
+
+      // Rotate right child up
+      if (balance > 1)
+        return Rotate(A, C);
+      // Rotate left child up
+      if (balance < -1)
+        return Rotate(A, B);
+      return A;
+    } /* End of 'Balance' function */
+
+    /* Rotate higher child up function.
+     * ARGUMENTS:
+     *   - subtree root index:
+     *       INT A;
+     *   - higher child index, which goes up:
+     *       INT Up;
+     * RETURNS:
+     *   (INT) new subtree root index.
+     */
+    INT Rotate( INT A, INT Up )
+    {
+      INT F = Nodes[Up].Left, G = Nodes[Up].Right;
+
+      // Swap A and Up
+      Nodes[Up].Left = A;
+      Nodes[Up].Parent = Nodes[A].Parent;
+      Nodes[A].Parent = Up;
+
+      if (Nodes[Up].Parent != -1)
+      {
+        if (Nodes[Nodes[Up].Parent].Left == A)
+          Nodes[Nodes[Up].Parent].Left = Up;
+        else
+          Nodes[Nodes[Up].Parent].Right = Up;
+      }
+      else
+        Root = Up;
+
+      // Keep higher grandchild under Up, lower one goes to A
+      INT keep = F, give = G;
+      if (Nodes[F].Height < Nodes[G].Height)
+        keep = G, give = F;
+
+      Nodes[Up].Right = keep;
+      if (Nodes[A].Left == Up)
+        Nodes[A].Left = give;
+      else
+        Nodes[A].Right = give;
+      Nodes[give].Parent = A;
+
+      Refit(A);
+      Refit(Up);
+      return Up;
+    } /* End of 'Rotate' function */
+
+    /* Insert leaf to tree function.
+     * ARGUMENTS:
+     *   - leaf index:
+     *       INT Leaf;
+     * RETURNS: None.
+     */
+    VOID InsertLeaf( INT Leaf )
+    {
+      if (Root == -1)
+      {
+        Root = Leaf;
+        Nodes[Root].Parent = -1;
+        return;
+      }
+
+      // Find best sibling by perimeter heuristic
+      INT index = Root;
+      while (Nodes[index].Left != -1)
+      {
+        const node &n = Nodes[index];
+        FLT
+          perimeter = GetPerimeter(n.Min, n.Max),
+          combined = GetUnionPerimeter(n, Nodes[Leaf]),
+          cost = 2 * combined,                      // Cost of creating new parent for this node and leaf
+          inheritance = 2 * (combined - perimeter); // Minimum cost of pushing leaf further down
+
+        const auto GetChildCost = [&]( INT Child )
+        {
+          FLT cost = GetUnionPerimeter(Nodes[Child], Nodes[Leaf]);
+          if (Nodes[Child].Left != -1)
+            cost -= GetPerimeter(Nodes[Child].Min, Nodes[Child].Max);
+          return cost + inheritance;
+        };
+        FLT cost_left = GetChildCost(n.Left), cost_right = GetChildCost(n.Right);
+
+        if (cost < cost_left && cost < cost_right)
+          break;
+        index = cost_left < cost_right ? n.Left : n.Right;
+      }
+
+      // Create new parent for sibling and leaf
+      INT sibling = index, old_parent = Nodes[sibling].Parent;
+      INT new_parent = AllocNode();
+
+      Nodes[new_parent].Parent = old_parent;
+      Nodes[new_parent].Left = sibling;
+      Nodes[new_parent].Right = Leaf;
+      Nodes[sibling].Parent = new_parent;
+      Nodes[Leaf].Parent = new_parent;
+      Refit(new_parent);
+
+      if (old_parent == -1)
+        Root = new_parent;
+      else if (Nodes[old_parent].Left == sibling)
+        Nodes[old_parent].Left = new_parent;
+      else
+        Nodes[old_parent].Right = new_parent;
+
+      // Fix heights and boxes up to the root
+      for (index = Nodes[Leaf].Parent; index != -1; index = Nodes[index].Parent)
+      {
+        index = Balance(index);
+        Refit(index);
+      }
+    } /* End of 'InsertLeaf' function */
+
+    /* Remove leaf from tree function (leaf node is not freed).
+     * ARGUMENTS:
+     *   - leaf index:
+     *       INT Leaf;
+     * RETURNS: None.
+     */
+    VOID RemoveLeaf( INT Leaf )
+    {
+      if (Leaf == Root)
+      {
+        Root = -1;
+        return;
+      }
+
+      INT
+        parent = Nodes[Leaf].Parent,
+        grand_parent = Nodes[parent].Parent,
+        sibling = Nodes[parent].Left == Leaf ? Nodes[parent].Right : Nodes[parent].Left;
+
+      // Replace parent with sibling
+      if (grand_parent == -1)
+      {
+        Root = sibling;
+        Nodes[sibling].Parent = -1;
+      }
+      else
+      {
+        if (Nodes[grand_parent].Left == parent)
+          Nodes[grand_parent].Left = sibling;
+        else
+          Nodes[grand_parent].Right = sibling;
+        Nodes[sibling].Parent = grand_parent;
+
+        for (INT index = grand_parent; index != -1; index = Nodes[index].Parent)
+        {
+          index = Balance(index);
+          Refit(index);
+        }
+      }
+      FreeNode(parent);
+    } /* End of 'RemoveLeaf' function */
+
+    /* Leaf with Morton code of its box center for bulk building. */
+    struct build_leaf
+    {
+      UINT32 Code; // Morton code of box center
+      INT Index;   // Leaf node index
+    }; /* end of 'build_leaf' struct */
+
+    /* Spread 16 bits of value to even bits function.
+     * ARGUMENTS:
+     *   - value:
+     *       UINT32 Value;
+     * RETURNS:
+     *   (UINT32) spread value.
+     */
+    static UINT32 SpreadBits( UINT32 Value )
+    {
+      Value &= 0xFFFF;
+      Value = (Value | (Value << 8)) & 0x00FF00FF;
+      Value = (Value | (Value << 4)) & 0x0F0F0F0F;
+      Value = (Value | (Value << 2)) & 0x33333333;
+      Value = (Value | (Value << 1)) & 0x55555555;
+      return Value;
+    } /* End of 'SpreadBits' function */
+
+    /* Build subtree of leaves sorted along Morton curve function.
+     * Leaves are split in halves, so subtree is balanced and near leaves go together.
+     * ARGUMENTS:
+     *   - leaves range:
+     *       const build_leaf *First, const build_leaf *Last;
+     * RETURNS:
+     *   (INT) subtree root index.
+     */
+    INT BuildSubtree( const build_leaf *First, const build_leaf *Last )
+    {
+      if (Last - First == 1)
+        return First->Index;
+
+      const build_leaf *middle = First + (Last - First) / 2;
+      INT left = BuildSubtree(First, middle), right = BuildSubtree(middle, Last), index = AllocNode();
+
+      Nodes[index].Left = left;
+      Nodes[index].Right = right;
+      Nodes[left].Parent = Nodes[right].Parent = index;
+      Refit(index);
+      return index;
+    } /* End of 'BuildSubtree' function */
+
+  public:
+    /* Tree constructor.
+     * ARGUMENTS:
+     *   - leaves boxes enlargement:
+     *       FLT Margin;
+     */
+    aabb_tree( FLT Margin = 0 ) : Margin(Margin)
+    {
+    } /* End of 'aabb_tree' function */
+
+    /* Insert object to tree function.
+     * ARGUMENTS:
+     *   - object bounding box:
+     *       const vec2 &Min, const vec2 &Max;
+     *   - user data:
+     *       const Type &Data;
+     * RETURNS:
+     *   (INT) object proxy index.
+     */
+    INT Insert( const vec2 &Min, const vec2 &Max, const Type &Data )
+    {
+      INT leaf = AllocNode();
+
+      Nodes[leaf].Min = Min - vec2(Margin);
+      Nodes[leaf].Max = Max + vec2(Margin);
+      Nodes[leaf].Data = Data;
+      InsertLeaf(leaf);
+      return leaf;
+    } /* End of 'Insert' function */
+
+    /* Insert many objects to tree function.
+     * Objects are sorted along Morton curve and built to balanced subtree, which is
+     * much faster than inserting them one by one, then subtree is inserted to tree.
+     * ARGUMENTS:
+     *   - objects count:
+     *       size_t Count;
+     *   - callback, sets bounding box and user data of object (called for objects in order):
+     *       VOID GetObject( size_t Index, vec2 *Min, vec2 *Max, Type *Data );
+     *   - objects proxies container to add to:
+     *       std::vector<INT> *Proxies;
+     * RETURNS: None.
+     */
+    template<class Func>
+      VOID Insert( size_t Count, Func GetObject, std::vector<INT> *Proxies )
+      {
+        if (Count == 0)
+          return;
+
+        std::vector<build_leaf> leaves(Count), sorted(Count);
+        vec2 min(INFINITY), max(-INFINITY);
+
+        Nodes.reserve(Nodes.size() + Count * 2);
+        for (size_t i = 0; i < Count; i++)
+        {
+          INT leaf = AllocNode();
+          node &n = Nodes[leaf];
+
+          GetObject(i, &n.Min, &n.Max, &n.Data);
+          min = vec2::Min(min, n.Min + n.Max);
+          max = vec2(mth::Max(max[0], n.Min[0] + n.Max[0]), mth::Max(max[1], n.Min[1] + n.Max[1]));
+          leaves[i].Index = leaf;
+          Proxies->push_back(leaf);
+        }
+
+        // Doubled box centers are quantized in their bounding box
+        FLT
+          scale_x = max[0] > min[0] ? 65535 / (max[0] - min[0]) : 0,
+          scale_y = max[1] > min[1] ? 65535 / (max[1] - min[1]) : 0;
+        for (build_leaf &leaf : leaves)
+        {
+          node &n = Nodes[leaf.Index];
+
+          leaf.Code =
+            SpreadBits((UINT32)((n.Min[0] + n.Max[0] - min[0]) * scale_x)) |
+            SpreadBits((UINT32)((n.Min[1] + n.Max[1] - min[1]) * scale_y)) << 1;
+          n.Min = n.Min - vec2(Margin);
+          n.Max = n.Max + vec2(Margin);
+        }
+
+        // Radix sort by codes bytes, after even passes count leaves are sorted in place
+        for (INT shift = 0; shift < 32; shift += 8)
+        {
+          size_t offsets[257] = {};
+
+          for (const build_leaf &leaf : leaves)
+            offsets[((leaf.Code >> shift) & 0xFF) + 1]++;
+          for (INT i = 0; i < 256; i++)
+            offsets[i + 1] += offsets[i];
+          for (const build_leaf &leaf : leaves)
+            sorted[offsets[(leaf.Code >> shift) & 0xFF]++] = leaf;
+          leaves.swap(sorted);
+        }
+        InsertLeaf(BuildSubtree(leaves.data(), leaves.data() + Count));
+      } /* End of 'Insert' function */
+
+    /* Remove object from tree function.
+     * ARGUMENTS:
+     *   - object proxy index:
+     *       INT Proxy;
+     * RETURNS: None.
+     */
+    VOID Remove( INT Proxy )
+    {
+      RemoveLeaf(Proxy);
+      FreeNode(Proxy);
+    } /* End of 'Remove' function */
+
+    /* Update object bounding box function.
+     * ARGUMENTS:
+     *   - object proxy index:
+     *       INT Proxy;
+     *   - new object bounding box:
+     *       const vec2 &Min, const vec2 &Max;
+     * RETURNS:
+     *   (BOOL) whether tree was restructured.
+     */
+    BOOL Move( INT Proxy, const vec2 &Min, const vec2 &Max )
+    {
+      if (IsContains(Nodes[Proxy].Min, Nodes[Proxy].Max, Min, Max))
+        return FALSE;
+
+      RemoveLeaf(Proxy);
+      Nodes[Proxy].Min = Min - vec2(Margin);
+      Nodes[Proxy].Max = Max + vec2(Margin);
+      InsertLeaf(Proxy);
+      return TRUE;
+    } /* End of 'Move' function */
+
+    /* Get object user data function.
+     * ARGUMENTS:
+     *   - object proxy index:
+     *       INT Proxy;
+     * RETURNS:
+     *   (Type &) user data reference.
+     */
+    Type & GetData( INT Proxy )
+    {
+      return Nodes[Proxy].Data;
+    } /* End of 'GetData' function */
+
+    /* Get object user data function.
+     * ARGUMENTS:
+     *   - object proxy index:
+     *       INT Proxy;
+     * RETURNS:
+     *   (const Type &) user data reference.
+     */
+    const Type & GetData( INT Proxy ) const
+    {
+      return Nodes[Proxy].Data;
+    } /* End of 'GetData' function */
+
+    /* Find all objects which boxes overlap box function.
+     * ARGUMENTS:
+     *   - box to check:
+     *       const vec2 &Min, const vec2 &Max;
+     *   - callback, called for every found object, returns FALSE to stop query:
+     *       BOOL Callback( INT Proxy, const Type &Data );
+     * RETURNS: None.
+     */
+    template<class Func>
+      VOID Query( const vec2 &Min, const vec2 &Max, Func Callback ) const
+      {
+        if (Root == -1)
+          return;
+
+        std::vector<INT> stack;
+        stack.reserve(64);
+
+        stack.push_back(Root);
+        while (!stack.empty())
+        {
+          const node &n = Nodes[stack.back()];
+          INT index = stack.back();
+          stack.pop_back();
+
+          if (!IsOverlap(n.Min, n.Max, Min, Max))
+            continue;
+
+          if (n.Left == -1)
+          {
+            if (!Callback(index, n.Data))
+              return;
+            continue;
+          }
+          stack.push_back(n.Left);
+          stack.push_back(n.Right);
+        }
+      } /* End of 'Query' function */
+
+    /* Remove all objects function.
+     * ARGUMENTS: None.
+     * RETURNS: None.
+     */
+    VOID Clear( VOID )
+    {
+      Nodes.clear();
+      Root = FreeList = -1;
+    } /* End of 'Clear' function */
+  }; /* end of 'aabb_tree' class */
+
+#endif /* __location_aabb_tree_h_ */
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "location_arena.h"
+
+/* Arena constructor.
+ * ARGUMENTS:
+ *   - first block size in bytes (next blocks are twice bigger than previous):
+ *       size_t BlockSize;
+ */
+arena::arena( size_t BlockSize ) : BlockSize(BlockSize)
+{
+} /* End of 'arena::arena' function */
+
+/* Arena destructor. */
+arena::~arena( VOID )
+{
+  for (block &b : Blocks)
+    delete[] b.Data;
+} /* End of 'arena::~arena' function */
+
+/* Allocate memory function.
+ * ARGUMENTS:
+ *   - memory size in bytes:
+ *       size_t Size;
+ *   - memory alignment (not bigger than 'alignof(std::max_align_t)'):
+ *       size_t Align;
+ * RETURNS:
+ *   (VOID *) allocated memory.
+ */
+VOID * arena::Allocate( size_t Size, size_t Align )
+{
+  for (;;)
+  {
+    // Blocks are aligned to any type, so offset alignment is enough
+    if (Block < Blocks.size())
+    {
+      size_t start = (Used + Align - 1) & ~(Align - 1);
+
+      if (start + Size <= Blocks[Block].Size)
+      {
+        Used = start + Size;
+        return Blocks[Block].Data + start;
+      }
+      if (Block + 1 < Blocks.size())
+      {
+        Block++, Used = 0;
+        continue;
+      }
+    }
+
+    size_t size = mth::Max(Blocks.empty() ? BlockSize : Blocks.back().Size * 2, Size);
+
+    Blocks.push_back({new BYTE[size], size});
+    Block = Blocks.size() - 1, Used = 0;
+  }
+} /* End of 'arena::Allocate' function */
+
+/* Release all allocated memory function.
+ * Memory is kept for next allocations, several used blocks are joined to one.
+ * ARGUMENTS:
+ *   - maximal size of kept memory in bytes (bigger memory is freed down to it):
+ *       size_t MaxKept;
+ * RETURNS: None.
+ */
+VOID arena::Release( size_t MaxKept )
+{
+  if (Blocks.size() > 1 || (!Blocks.empty() && Blocks[0].Size > MaxKept))
+  {
+    size_t size = 0;
+
+    for (block &b : Blocks)
+      size += b.Size, delete[] b.Data;
+    Blocks.clear();
+    size = mth::Min(size, MaxKept);
+    if (size > 0)
+      Blocks.push_back({new BYTE[size], size});
+  }
+  Block = 0, Used = 0;
+} /* End of 'arena::Release' function */
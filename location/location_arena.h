@@ -0,0 +1,147 @@
+#ifndef __location_arena_h_
+#define __location_arena_h_
+
+#include "../def.h"
+
+/* Monotonic memory arena class.
+ * Memory is taken from big blocks by moving pointer and is not freed by pieces:
+ * all of it is released at once after operation. Blocks are kept for next operations,
+ * so scratch data of repeated operations does not allocate memory.
+ */
+class arena
+{
+private:
+  /* Memory block structure. */
+  struct block
+  {
+    BYTE *Data;  // Block memory
+    size_t Size; // Block size in bytes
+  }; /* end of 'block' struct */
+
+  std::vector<block> Blocks; // Owned blocks
+  size_t Block = 0;          // Index of block memory is taken from
+  size_t Used = 0;           // Used bytes in current block
+  size_t BlockSize;          // First block size in bytes
+
+public:
+  /* Arena constructor.
+   * ARGUMENTS:
+   *   - first block size in bytes (next blocks are twice bigger than previous):
+   *       size_t BlockSize;
+   */
+  arena( size_t BlockSize = 16 << 10 );
+
+  /* Arena copying is not allowed (allocated memory is owned). */
+  arena( const arena & ) = delete;
+  arena &operator=( const arena & ) = delete;
+
+  /* Arena destructor. */
+  ~arena( VOID );
+
+  /* Allocate memory function.
+   * ARGUMENTS:
+   *   - memory size in bytes:
+   *       size_t Size;
+   *   - memory alignment (not bigger than 'alignof(std::max_align_t)'):
+   *       size_t Align;
+   * RETURNS:
+   *   (VOID *) allocated memory.
+   */
+  VOID * Allocate( size_t Size, size_t Align );
+
+  /* Release all allocated memory function.
+   * Memory is kept for next allocations, several used blocks are joined to one.
+   * ARGUMENTS:
+   *   - maximal size of kept memory in bytes (bigger memory is freed down to it):
+   *       size_t MaxKept;
+   * RETURNS: None.
+   */
+  VOID Release( size_t MaxKept = (size_t)-1 );
+}; /* end of 'arena' class */
+
+/* Standard containers allocator taking memory from arena class.
+ * Memory is not freed by container, it is released with arena.
+ */
+template<class Type>
+  class arena_allocator
+  {
+  public:
+    using value_type = Type;
+
+    arena *Arena; // Arena to take memory from
+
+    /* Allocator constructor.
+     * ARGUMENTS:
+     *   - arena to take memory from:
+     *       arena *Arena;
+     */
+    arena_allocator( arena *Arena ) : Arena(Arena)
+    {
+    } /* End of 'arena_allocator' function */
+
+    /* Allocator of another type constructor.
+     * ARGUMENTS:
+     *   - allocator to take arena of:
+     *       const arena_allocator<Other> &Alloc;
+     */
+    template<class Other>
+      arena_allocator( const arena_allocator<Other> &Alloc ) : Arena(Alloc.Arena)
+      {
+      } /* End of 'arena_allocator' function */
+
+    /* Allocate objects memory function.
+     * ARGUMENTS:
+     *   - objects count:
+     *       size_t Count;
+     * RETURNS:
+     *   (Type *) allocated memory.
+     */
+    Type * allocate( size_t Count )
+    {
+      return (Type *)Arena->Allocate(Count * sizeof(Type), alignof(Type));
+    } /* End of 'allocate' function */
+
+    /* Free objects memory function (memory is released with arena).
+     * ARGUMENTS:
+     *   - memory (not used):
+     *       Type *;
+     *   - objects count (not used):
+     *       size_t;
+     * RETURNS: None.
+     */
+    VOID deallocate( Type *, size_t )
+    {
+    } /* End of 'deallocate' function */
+
+    /* Allocators compare function.
+     * ARGUMENTS:
+     *   - allocator to compare with:
+     *       const arena_allocator<Other> &Alloc;
+     * RETURNS:
+     *   (BOOL) whether allocators take memory from the same arena.
+     */
+    template<class Other>
+      BOOL operator==( const arena_allocator<Other> &Alloc ) const
+      {
+        return Arena == Alloc.Arena;
+      } /* End of 'operator==' function */
+
+    /* Allocators compare function.
+     * ARGUMENTS:
+     *   - allocator to compare with:
+     *       const arena_allocator<Other> &Alloc;
+     * RETURNS:
+     *   (BOOL) whether allocators take memory from different arenas.
+     */
+    template<class Other>
+      BOOL operator!=( const arena_allocator<Other> &Alloc ) const
+      {
+        return Arena != Alloc.Arena;
+      } /* End of 'operator!=' function */
+  }; /* end of 'arena_allocator' class */
+
+// Vector with memory taken from arena
+template<class Type>
+  using arena_vector = std::vector<Type, arena_allocator<Type>>;
+
+#endif /* __location_arena_h_ */
@@ -0,0 +1,538 @@
+#include <algorithm>
+
+#include "location.h"
+#include "location_predicates.h"
+
+/* Boolean operations constructor.
+ * ARGUMENTS:
+ *   - points pool of polygons points (intersection points are added to it):
+ *       points_pool &Pool;
+ */
+polygon_boolean::polygon_boolean( points_pool &Pool ) : Pool(Pool)
+{
+} /* End of 'polygon_boolean::polygon_boolean' function */
+
+/* Add polygon segments to operands function.
+ * ARGUMENTS:
+ *   - polygon to add:
+ *       const polygon &Polly;
+ *   - operand (0 - subject, 1 - clip):
+ *       INT Set;
+ *   - winding direction (-1 to reverse polygon):
+ *       INT Dir;
+ * RETURNS: None.
+ */
+VOID polygon_boolean::AddPolygon( const polygon &Polly, INT Set, INT Dir )
+{
+  for (const segment &seg : Polly.Lines)
+    Segments.push_back({seg.St, seg.End, Set, Dir});
+} /* End of 'polygon_boolean::AddPolygon' function */
+
+/* Check sweep events order function.
+ * Events go by points, right points events go before left ones, edges go from bottom to top.
+ * ARGUMENTS:
+ *   - events:
+ *       size_t A, size_t B;
+ * RETURNS:
+ *   (BOOL) whether first event goes before second one.
+ */
+BOOL polygon_boolean::IsEventLess( size_t A, size_t B ) const
+{
+  const edge &a = Edges[A / 2], &b = Edges[B / 2];
+  BOOL is_left_a = A % 2 != 0, is_left_b = B % 2 != 0;
+  UINT32
+    pnt_a = is_left_a ? a.Left : a.Right, other_a = is_left_a ? a.Right : a.Left,
+    pnt_b = is_left_b ? b.Left : b.Right, other_b = is_left_b ? b.Right : b.Left;
+
+  // Equal points have one index
+  if (pnt_a != pnt_b)
+    return IsPointLess(pnt_a, pnt_b);
+  if (is_left_a != is_left_b)
+    return !is_left_a;
+  if (A == B)
+    return FALSE;
+
+  DBL orient = predicates::Orient2d(Pool.At(pnt_a), Pool.At(other_a), Pool.At(other_b));
+  if (orient != 0)
+    return is_left_a ? orient > 0 : orient < 0;
+  return A < B;
+} /* End of 'polygon_boolean::IsEventLess' function */
+
+/* Check sweep status order function.
+ * Edges do not cross, so edge inserted later is compared with line of another one by its left point.
+ * ARGUMENTS:
+ *   - edges indexes:
+ *       size_t A, size_t B;
+ * RETURNS:
+ *   (BOOL) whether first edge is below second one.
+ */
+BOOL polygon_boolean::IsBelow( size_t A, size_t B ) const
+{
+  if (A == B)
+    return FALSE;
+
+  const edge &a = Edges[A], &b = Edges[B];
+  vec2
+    al = Pool.At(a.Left), ar = Pool.At(a.Right),
+    bl = Pool.At(b.Left), br = Pool.At(b.Right);
+  DBL orient;
+
+  if (a.Left == b.Left)
+  {
+    if ((orient = predicates::Orient2d(al, ar, br)) != 0)
+      return orient > 0;
+  }
+  else if (IsPointLess(a.Left, b.Left))
+  {
+    if ((orient = predicates::Orient2d(al, ar, bl)) != 0 || (orient = predicates::Orient2d(al, ar, br)) != 0)
+      return orient > 0;
+  }
+  else if ((orient = predicates::Orient2d(bl, br, al)) != 0 || (orient = predicates::Orient2d(bl, br, ar)) != 0)
+    return orient < 0;
+  return A < B;
+} /* End of 'polygon_boolean::IsBelow' function */
+
+/* Find segments intersection points function.
+ * ARGUMENTS:
+ *   - segments indexes:
+ *       size_t A, size_t B;
+ *   - container to add (segment, point index) splits to:
+ *       arena_vector<std::pair<UINT32, UINT32>> *Splits;
+ * RETURNS: None.
+ */
+VOID polygon_boolean::Intersect( size_t A, size_t B, arena_vector<std::pair<UINT32, UINT32>> *Splits )
+{
+  const input_segment &s = Segments[A], &t = Segments[B];
+  vec2 a = Pool.At(s.St), b = Pool.At(s.End), c = Pool.At(t.St), d = Pool.At(t.End);
+  DBL
+    o1 = predicates::Orient2d(a, b, c), o2 = predicates::Orient2d(a, b, d),
+    o3 = predicates::Orient2d(c, d, a), o4 = predicates::Orient2d(c, d, b);
+
+  // Check if point of segment line lies strictly between segment points function
+  const auto IsInside = []( const vec2 &St, const vec2 &End, const vec2 &Pnt ) -> BOOL
+  {
+    INT axis = St[0] != End[0] ? 0 : 1;
+    return mth::Min(St[axis], End[axis]) < Pnt[axis] && Pnt[axis] < mth::Max(St[axis], End[axis]);
+  };
+
+  // Crossing point is added to pool (snapped to near points)
+  if (((o1 < 0 && o2 > 0) || (o1 > 0 && o2 < 0)) && ((o3 < 0 && o4 > 0) || (o3 > 0 && o4 < 0)))
+  {
+    DBL param = o3 / (o3 - o4);
+    UINT32 pnt = (UINT32)Pool.Add(vec2((FLT)(a[0] + (b[0] - a[0]) * param), (FLT)(a[1] + (b[1] - a[1]) * param)));
+
+    Splits->push_back({(UINT32)A, pnt});
+    Splits->push_back({(UINT32)B, pnt});
+    return;
+  }
+
+  // Touching and overlapping segments are split by points of another one
+  if (o1 == 0 && IsInside(a, b, c))
+    Splits->push_back({(UINT32)A, t.St});
+  if (o2 == 0 && IsInside(a, b, d))
+    Splits->push_back({(UINT32)A, t.End});
+  if (o3 == 0 && IsInside(c, d, a))
+    Splits->push_back({(UINT32)B, s.St});
+  if (o4 == 0 && IsInside(c, d, b))
+    Splits->push_back({(UINT32)B, s.End});
+} /* End of 'polygon_boolean::Intersect' function */
+
+/* Split segments by intersections and join equal pieces to edges function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID polygon_boolean::Split( VOID )
+{
+  size_t n = Segments.size();
+
+  // Segments with overlapping bounding boxes are found by sweep line over boxes left sides
+  arena_vector<FLT> min_x(n, 0, &Arena), max_x(n, 0, &Arena), min_y(n, 0, &Arena), max_y(n, 0, &Arena);
+  arena_vector<UINT32> order(n, 0, &Arena), active(&Arena);
+  arena_vector<std::pair<UINT32, UINT32>> splits(&Arena);
+
+  for (size_t i = 0; i < n; i++)
+  {
+    vec2 st = Pool.At(Segments[i].St), end = Pool.At(Segments[i].End);
+
+    min_x[i] = mth::Min(st[0], end[0]), max_x[i] = mth::Max(st[0], end[0]);
+    min_y[i] = mth::Min(st[1], end[1]), max_y[i] = mth::Max(st[1], end[1]);
+    order[i] = (UINT32)i;
+  }
+  std::sort(order.begin(), order.end(), [&]( UINT32 A, UINT32 B )
+            {
+              return min_x[A] < min_x[B];
+            });
+  for (UINT32 seg : order)
+  {
+    for (size_t i = 0; i < active.size();)
+    {
+      UINT32 other = active[i];
+
+      if (max_x[other] < min_x[seg])
+      {
+        active[i] = active.back();
+        active.pop_back();
+        continue;
+      }
+      if (min_y[seg] <= max_y[other] && min_y[other] <= max_y[seg])
+        Intersect(seg, other, &splits);
+      i++;
+    }
+    active.push_back(seg);
+  }
+
+  // Pieces of segments between split points, in segment direction
+  struct piece
+  {
+    UINT32 St, End; // Points indexes
+    INT Set, Dir;   // Operand and winding direction
+  };
+  arena_vector<piece> pieces(&Arena);
+  arena_vector<std::pair<DBL, UINT32>> points(&Arena);
+
+  std::sort(splits.begin(), splits.end());
+  for (size_t i = 0, split = 0; i < n; i++)
+  {
+    const input_segment &seg = Segments[i];
+    vec2 st = Pool.At(seg.St), dir = Pool.At(seg.End) - st;
+
+    points.clear();
+    for (; split < splits.size() && splits[split].first == i; split++)
+    {
+      vec2 pnt = Pool.At(splits[split].second);
+
+      points.push_back({(DBL)(pnt[0] - st[0]) * dir[0] + (DBL)(pnt[1] - st[1]) * dir[1], splits[split].second});
+    }
+    std::sort(points.begin(), points.end());
+
+    UINT32 prev = seg.St;
+    for (const auto &pnt : points)
+      pieces.push_back({prev, pnt.second, seg.Set, seg.Dir}), prev = pnt.second;
+    pieces.push_back({prev, seg.End, seg.Set, seg.Dir});
+  }
+
+  // Points with equal coordinates get one index
+  arena_vector<UINT32> used(&Arena), by_coords(&Arena), canonical(&Arena);
+
+  used.reserve(pieces.size() * 2);
+  for (const piece &p : pieces)
+    used.push_back(p.St), used.push_back(p.End);
+  std::sort(used.begin(), used.end());
+  used.erase(std::unique(used.begin(), used.end()), used.end());
+  by_coords.assign(used.begin(), used.end());
+  std::sort(by_coords.begin(), by_coords.end(), [&]( UINT32 A, UINT32 B )
+            {
+              return IsPointLess(A, B) || (!IsPointLess(B, A) && A < B);
+            });
+  canonical.resize(used.size());
+  for (size_t i = 0, first = 0; i < by_coords.size(); i++)
+  {
+    if (IsPointLess(by_coords[first], by_coords[i]))
+      first = i;
+    canonical[std::lower_bound(used.begin(), used.end(), by_coords[i]) - used.begin()] = by_coords[first];
+  }
+  const auto GetCanonical = [&]( UINT32 Pnt ) -> UINT32
+  {
+    return canonical[std::lower_bound(used.begin(), used.end(), Pnt) - used.begin()];
+  };
+
+  // Pieces are turned from left to right point, then equal ones are joined to edges
+  for (piece &p : pieces)
+  {
+    UINT32 st = GetCanonical(p.St), end = GetCanonical(p.End);
+
+    if (IsPointLess(st, end))
+      p.St = st, p.End = end;
+    else
+      p.St = end, p.End = st, p.Dir = -p.Dir;
+  }
+  std::sort(pieces.begin(), pieces.end(), []( const piece &A, const piece &B )
+            {
+              return A.St < B.St || (A.St == B.St && A.End < B.End);
+            });
+  Edges.clear();
+  for (size_t i = 0; i < pieces.size();)
+  {
+    edge e {pieces[i].St, pieces[i].End, {0, 0}, {0, 0}, FALSE, FALSE, (size_t)-1, (size_t)-1};
+
+    for (; i < pieces.size() && pieces[i].St == e.Left && pieces[i].End == e.Right; i++)
+      e.Delta[pieces[i].Set] += pieces[i].Dir;
+    // Degenerate pieces and pieces cancelling each other do not change winding numbers
+    if (e.Left != e.Right && (e.Delta[0] != 0 || e.Delta[1] != 0))
+      Edges.push_back(e);
+  }
+} /* End of 'polygon_boolean::Split' function */
+
+/* Find edges bounding result by sweep line function.
+ * ARGUMENTS:
+ *   - operation:
+ *       operation Op;
+ *   - whether polygons are given by even-odd rule (nonzero winding rule otherwise):
+ *       BOOL IsEvenOdd;
+ * RETURNS: None.
+ */
+VOID polygon_boolean::Sweep( operation Op, BOOL IsEvenOdd )
+{
+  // Check if point with operands winding numbers belongs to result function
+  const auto IsInResult = [&]( const INT *Wind ) -> BOOL
+  {
+    BOOL
+      is_subject = IsEvenOdd ? (Wind[0] & 1) != 0 : Wind[0] != 0,
+      is_clip = IsEvenOdd ? (Wind[1] & 1) != 0 : Wind[1] != 0;
+
+    switch (Op)
+    {
+    case OPERATION_UNION:
+      return is_subject || is_clip;
+    case OPERATION_INTERSECTION:
+      return is_subject && is_clip;
+    case OPERATION_DIFFERENCE:
+      return is_subject && !is_clip;
+    default:
+      return is_subject != is_clip;
+    }
+  };
+
+  size_t m = Edges.size();
+
+  Events.resize(m * 2);
+  for (size_t i = 0; i < m * 2; i++)
+    Events[i] = i;
+  std::sort(Events.begin(), Events.end(), [&]( size_t A, size_t B )
+            {
+              return IsEventLess(A, B);
+            });
+
+  // All edges and only result ones (to find nearest result edge below)
+  status edges(edge_less {this}, &Arena), results(edge_less {this}, &Arena);
+  arena_vector<status::iterator> edges_iters(m, edges.end(), &Arena), results_iters(m, results.end(), &Arena);
+
+  for (size_t event : Events)
+  {
+    size_t index = event / 2;
+    edge &e = Edges[index];
+
+    if (event % 2 == 0)
+    {
+      edges.erase(edges_iters[index]);
+      if (e.IsResult)
+        results.erase(results_iters[index]);
+      continue;
+    }
+
+    // Winding numbers below edge are ones above edge below it
+    auto iter = edges.insert(index).first;
+    INT below[2] = {0, 0};
+
+    edges_iters[index] = iter;
+    if (iter != edges.begin())
+    {
+      const edge &prev = Edges[*std::prev(iter)];
+
+      below[0] = prev.WindAbove[0], below[1] = prev.WindAbove[1];
+    }
+    e.WindAbove[0] = below[0] + e.Delta[0], e.WindAbove[1] = below[1] + e.Delta[1];
+    e.IsAbove = IsInResult(e.WindAbove);
+    e.IsResult = e.IsAbove != IsInResult(below);
+
+    if (e.IsResult)
+    {
+      iter = results.insert(index).first;
+      results_iters[index] = iter;
+      e.Below = iter != results.begin() ? *std::prev(iter) : -1;
+    }
+  }
+} /* End of 'polygon_boolean::Sweep' function */
+
+/* Walk result edges to contours function.
+ * ARGUMENTS:
+ *   - polygons container to add result polygons to:
+ *       std::vector<polygon> *Result;
+ * RETURNS: None.
+ */
+VOID polygon_boolean::Connect( std::vector<polygon> *Result )
+{
+  // Result edges go with result on the left
+  const auto GetSt = [&]( const edge &E ) -> UINT32
+  {
+    return E.IsAbove ? E.Left : E.Right;
+  };
+
+  // Result edges around every point, sorted counterclockwise
+  arena_vector<std::pair<UINT32, UINT32>> around(&Arena); // (point, edge) pairs
+  arena_vector<UINT32> left_pos(Edges.size(), 0, &Arena), right_pos(Edges.size(), 0, &Arena), group_st(&Arena), group_end(&Arena);
+
+  for (size_t i = 0; i < Edges.size(); i++)
+    if (Edges[i].IsResult)
+      around.push_back({Edges[i].Left, (UINT32)i}), around.push_back({Edges[i].Right, (UINT32)i});
+  std::sort(around.begin(), around.end(), [&]( const std::pair<UINT32, UINT32> &A, const std::pair<UINT32, UINT32> &B ) -> BOOL
+            {
+              if (A.first != B.first)
+                return A.first < B.first;
+
+              const edge &a = Edges[A.second], &b = Edges[B.second];
+              vec2
+                pnt = Pool.At(A.first),
+                pa = Pool.At(a.Left == A.first ? a.Right : a.Left),
+                pb = Pool.At(b.Left == B.first ? b.Right : b.Left);
+              // Upper half-plane (with positive X direction) goes first
+              BOOL
+                is_upper_a = pa[1] > pnt[1] || (pa[1] == pnt[1] && pa[0] > pnt[0]),
+                is_upper_b = pb[1] > pnt[1] || (pb[1] == pnt[1] && pb[0] > pnt[0]);
+
+              if (is_upper_a != is_upper_b)
+                return is_upper_a;
+
+              DBL orient = predicates::Orient2d(pnt, pa, pb);
+              return orient != 0 ? orient > 0 : A.second < B.second;
+            });
+  group_st.resize(around.size()), group_end.resize(around.size());
+  for (size_t i = 0, st = 0; i < around.size(); i++)
+  {
+    if (around[i].first != around[st].first)
+    {
+      for (size_t j = st; j < i; j++)
+        group_end[j] = (UINT32)i;
+      st = i;
+    }
+    group_st[i] = (UINT32)st;
+    if (i + 1 == around.size())
+      for (size_t j = st; j <= i; j++)
+        group_end[j] = (UINT32)around.size();
+
+    if (Edges[around[i].second].Left == around[i].first)
+      left_pos[around[i].second] = (UINT32)i;
+    else
+      right_pos[around[i].second] = (UINT32)i;
+  }
+
+  // Contours are walked from edges going first in sweep order, so contour is
+  // walked after contours below its first point, and its first edge is not vertical
+  arena_vector<size_t> contours_polygons(&Arena);
+
+  for (size_t event : Events)
+  {
+    size_t first = event / 2;
+    edge &first_edge = Edges[first];
+
+    if (event % 2 == 0 || !first_edge.IsResult || first_edge.Contour != (size_t)-1)
+      continue;
+
+    // Contour with result below its first edge is a hole of polygon of result edge below it
+    size_t contour = contours_polygons.size(), below = first_edge.Below;
+    if (!first_edge.IsAbove && below != (size_t)-1 && Edges[below].IsAbove && Edges[below].Contour != (size_t)-1)
+      contours_polygons.push_back(contours_polygons[Edges[below].Contour]);
+    else
+    {
+      contours_polygons.push_back(Result->size());
+      Result->push_back(polygon());
+    }
+    std::vector<segment> &lines = (*Result)[contours_polygons.back()].Lines;
+
+    // Next edge is first going from edge end clockwise from edge, so touching contours are walked apart
+    size_t e = first;
+    do
+    {
+      UINT32 st = GetSt(Edges[e]), end = st == Edges[e].Left ? Edges[e].Right : Edges[e].Left;
+      UINT32 pos = end == Edges[e].Left ? left_pos[e] : right_pos[e];
+      size_t next = -1;
+
+      Edges[e].Contour = contour;
+      lines.push_back(segment(st, end));
+      for (size_t k = group_st[pos] + 1; k < group_end[pos]; k++)
+      {
+        pos = pos == group_st[pos] ? group_end[pos] - 1 : pos - 1;
+
+        const edge &candidate = Edges[around[pos].second];
+        if (GetSt(candidate) == end && (candidate.Contour == (size_t)-1 || around[pos].second == first))
+        {
+          next = around[pos].second;
+          break;
+        }
+      }
+      e = next;
+    } while (e != (size_t)-1 && e != first);
+  }
+} /* End of 'polygon_boolean::Connect' function */
+
+/* Run operation for added segments function.
+ * ARGUMENTS:
+ *   - operation:
+ *       operation Op;
+ *   - whether polygons are given by even-odd rule (nonzero winding rule otherwise):
+ *       BOOL IsEvenOdd;
+ *   - polygons container to add result polygons to:
+ *       std::vector<polygon> *Result;
+ * RETURNS: None.
+ */
+VOID polygon_boolean::Run( operation Op, BOOL IsEvenOdd, std::vector<polygon> *Result )
+{
+  Split();
+  Sweep(Op, IsEvenOdd);
+  Connect(Result);
+
+  // Containers drop arena memory before it is released
+  Segments = arena_vector<input_segment>(&Arena);
+  Edges = arena_vector<edge>(&Arena);
+  Events = arena_vector<size_t>(&Arena);
+  Arena.Release();
+} /* End of 'polygon_boolean::Run' function */
+
+/* Compute boolean operation of polygons sets function.
+ * ARGUMENTS:
+ *   - subject polygons:
+ *       const std::vector<polygon> &Subject;
+ *   - clip polygons:
+ *       const std::vector<polygon> &Clip;
+ *   - operation:
+ *       operation Op;
+ *   - result polygons container:
+ *       std::vector<polygon> *Result;
+ * RETURNS: None.
+ */
+VOID polygon_boolean::Compute( const std::vector<polygon> &Subject, const std::vector<polygon> &Clip, operation Op, std::vector<polygon> *Result )
+{
+  const std::vector<polygon> *operands[2] = {&Subject, &Clip};
+  std::vector<polygon> normalized[2];
+
+  // Check if polygon is one closed ring function
+  const auto IsSingleRing = []( const polygon &Polly ) -> BOOL
+  {
+    for (size_t i = 0, n = Polly.Lines.size(); i < n; i++)
+      if (Polly.Lines[i].End != Polly.Lines[(i + 1) % n].St)
+        return FALSE;
+    return TRUE;
+  };
+
+  // Polygons of operand are joined by nonzero winding rule, so they are turned counterclockwise.
+  // Polygons with several rings are turned to counterclockwise outer contours and clockwise holes by even-odd rule
+  for (INT set = 0; set < 2; set++)
+    for (const polygon &polly : *operands[set])
+      if (!IsSingleRing(polly))
+      {
+        AddPolygon(polly, 0, 1);
+        Run(OPERATION_UNION, TRUE, &normalized[set]);
+      }
+
+  for (INT set = 0; set < 2; set++)
+  {
+    for (const polygon &polly : *operands[set])
+      if (IsSingleRing(polly))
+      {
+        DBL area = 0;
+
+        for (const segment &seg : polly.Lines)
+        {
+          vec2 st = Pool.At(seg.St), end = Pool.At(seg.End);
+
+          area += (DBL)st[0] * end[1] - (DBL)end[0] * st[1];
+        }
+        AddPolygon(polly, set, area < 0 ? -1 : 1);
+      }
+    for (const polygon &polly : normalized[set])
+      AddPolygon(polly, set, 1);
+  }
+
+  Result->clear();
+  Run(Op, FALSE, Result);
+} /* End of 'polygon_boolean::Compute' function */
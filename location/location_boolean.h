@@ -0,0 +1,197 @@
+#ifndef __location_boolean_h_
+#define __location_boolean_h_
+
+#include <set>
+
+#include "location_points_pool.h"
+#include "location_arena.h"
+
+// Forward declaration
+class polygon;
+
+/* Polygons boolean operations class.
+ * Operands are sets of polygons: region of set is union of its polygons, region of polygon
+ * is given by even-odd rule over its rings. Result polygons are outer contours (counterclockwise)
+ * with their holes (clockwise) added after them as rings.
+ * Segments are split by their intersections (candidates are found by bounding boxes sweep) and
+ * equal pieces are joined, then sweep line with ordered status of edges gives winding numbers of both
+ * operands around every edge in O((n + k) log n). Contours are walked by result edges around points,
+ * holes are connected to contours by nearest result edge below them.
+ * Scratch memory is taken from arena kept between operations.
+ */
+class polygon_boolean
+{
+public:
+  /* Boolean operation. */
+  enum operation
+  {
+    OPERATION_UNION,        // Points of subject or clip
+    OPERATION_INTERSECTION, // Points of both subject and clip
+    OPERATION_DIFFERENCE,   // Points of subject but not of clip
+    OPERATION_XOR           // Points of only one of subject and clip
+  }; /* end of 'operation' enum */
+
+private:
+  /* Input segment structure. */
+  struct input_segment
+  {
+    UINT32 St, End; // Points indexes in pool
+    INT Set;        // Operand (0 - subject, 1 - clip)
+    INT Dir;        // Winding direction (+1 or -1)
+  }; /* end of 'input_segment' struct */
+
+  /* Edge (piece of joined equal input segments) structure. */
+  struct edge
+  {
+    UINT32 Left, Right;   // Points indexes (left one goes first in sweep order)
+    INT Delta[2];         // Winding numbers change of operands crossing edge upwards
+    INT WindAbove[2];     // Winding numbers of operands above edge
+    BOOL IsResult;        // Whether edge bounds result
+    BOOL IsAbove;         // Whether result is above edge (to the left of vertical edge)
+    size_t Below;         // Nearest result edge below left point (-1 if none)
+    size_t Contour;       // Result contour of edge (-1 if not walked yet)
+  }; /* end of 'edge' struct */
+
+  /* Sweep status order of edges structure. */
+  struct edge_less
+  {
+    const polygon_boolean *Boolean; // Boolean operation edges are taken from
+
+    /* Compare edges function.
+     * ARGUMENTS:
+     *   - edges indexes:
+     *       size_t A, size_t B;
+     * RETURNS:
+     *   (BOOL) whether first edge is below second one.
+     */
+    BOOL operator()( size_t A, size_t B ) const
+    {
+      return Boolean->IsBelow(A, B);
+    } /* End of 'operator()' function */
+  }; /* end of 'edge_less' struct */
+
+  // Sweep status: set of edges crossed by sweep line ordered from bottom to top
+  using status = std::set<size_t, edge_less, arena_allocator<size_t>>;
+
+  points_pool &Pool;                             // Points pool of polygons points (intersection points are added to it)
+  arena Arena;                                   // Operation scratch memory
+  arena_vector<input_segment> Segments {&Arena}; // Operands segments
+  arena_vector<edge> Edges {&Arena};             // Edges sorted by points indexes
+  arena_vector<size_t> Events {&Arena};          // Sweep events (edge index * 2 + 1 for left point, + 0 for right one)
+
+  /* Add polygon segments to operands function.
+   * ARGUMENTS:
+   *   - polygon to add:
+   *       const polygon &Polly;
+   *   - operand (0 - subject, 1 - clip):
+   *       INT Set;
+   *   - winding direction (-1 to reverse polygon):
+   *       INT Dir;
+   * RETURNS: None.
+   */
+  VOID AddPolygon( const polygon &Polly, INT Set, INT Dir );
+
+  /* Check points sweep order function.
+   * ARGUMENTS:
+   *   - points indexes:
+   *       size_t A, size_t B;
+   * RETURNS:
+   *   (BOOL) whether first point is less by X, then by Y.
+   */
+  BOOL IsPointLess( size_t A, size_t B ) const
+  {
+    FLT ax = Pool.GetX()[A], bx = Pool.GetX()[B];
+
+    return ax < bx || (ax == bx && Pool.GetY()[A] < Pool.GetY()[B]);
+  } /* End of 'IsPointLess' function */
+
+  /* Check sweep events order function.
+   * Events go by points, right points events go before left ones, edges go from bottom to top.
+   * ARGUMENTS:
+   *   - events:
+   *       size_t A, size_t B;
+   * RETURNS:
+   *   (BOOL) whether first event goes before second one.
+   */
+  BOOL IsEventLess( size_t A, size_t B ) const;
+
+  /* Check sweep status order function.
+   * Edges do not cross, so edge inserted later is compared with line of another one by its left point.
+   * ARGUMENTS:
+   *   - edges indexes:
+   *       size_t A, size_t B;
+   * RETURNS:
+   *   (BOOL) whether first edge is below second one.
+   */
+  BOOL IsBelow( size_t A, size_t B ) const;
+
+  /* Find segments intersection points function.
+   * ARGUMENTS:
+   *   - segments indexes:
+   *       size_t A, size_t B;
+   *   - container to add (segment, point index) splits to:
+   *       arena_vector<std::pair<UINT32, UINT32>> *Splits;
+   * RETURNS: None.
+   */
+  VOID Intersect( size_t A, size_t B, arena_vector<std::pair<UINT32, UINT32>> *Splits );
+
+  /* Split segments by intersections and join equal pieces to edges function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID Split( VOID );
+
+  /* Find edges bounding result by sweep line function.
+   * ARGUMENTS:
+   *   - operation:
+   *       operation Op;
+   *   - whether polygons are given by even-odd rule (nonzero winding rule otherwise):
+   *       BOOL IsEvenOdd;
+   * RETURNS: None.
+   */
+  VOID Sweep( operation Op, BOOL IsEvenOdd );
+
+  /* Walk result edges to contours function.
+   * ARGUMENTS:
+   *   - polygons container to add result polygons to:
+   *       std::vector<polygon> *Result;
+   * RETURNS: None.
+   */
+  VOID Connect( std::vector<polygon> *Result );
+
+  /* Run operation for added segments function.
+   * ARGUMENTS:
+   *   - operation:
+   *       operation Op;
+   *   - whether polygons are given by even-odd rule (nonzero winding rule otherwise):
+   *       BOOL IsEvenOdd;
+   *   - polygons container to add result polygons to:
+   *       std::vector<polygon> *Result;
+   * RETURNS: None.
+   */
+  VOID Run( operation Op, BOOL IsEvenOdd, std::vector<polygon> *Result );
+
+public:
+  /* Boolean operations constructor.
+   * ARGUMENTS:
+   *   - points pool of polygons points (intersection points are added to it):
+   *       points_pool &Pool;
+   */
+  polygon_boolean( points_pool &Pool );
+
+  /* Compute boolean operation of polygons sets function.
+   * ARGUMENTS:
+   *   - subject polygons:
+   *       const std::vector<polygon> &Subject;
+   *   - clip polygons:
+   *       const std::vector<polygon> &Clip;
+   *   - operation:
+   *       operation Op;
+   *   - result polygons container:
+   *       std::vector<polygon> *Result;
+   * RETURNS: None.
+   */
+  VOID Compute( const std::vector<polygon> &Subject, const std::vector<polygon> &Clip, operation Op, std::vector<polygon> *Result );
+}; /* end of 'polygon_boolean' class */
+
+#endif /* __location_boolean_h_ */
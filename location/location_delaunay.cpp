@@ -0,0 +1,1239 @@
+#include <algorithm>
+#include <deque>
+
+#include "location.h"
+
+/* Constrained Delaunay triangulation constructor.
+ * ARGUMENTS:
+ *   - points pool to take polygons points from:
+ *       const points_pool &Pool;
+ */
+delaunay::delaunay( const points_pool &Pool ) :
+  Pool(Pool)
+{
+} /* End of 'delaunay::delaunay' function */
+
+/* Add triangle function.
+ * ARGUMENTS:
+ *   - triangle vertices:
+ *       INT V0, INT V1, INT V2;
+ *   - opposite half-edges for triangle edges:
+ *       INT A, INT B, INT C;
+ * RETURNS:
+ *   (INT) first half-edge of triangle.
+ */
+INT delaunay::AddTriangle( INT V0, INT V1, INT V2, INT A, INT B, INT C )
+{
+  INT t;
+
+  if (FreeTriangles.empty())
+  {
+    t = (INT)Triangles.size();
+    Triangles.push_back(V0);
+    Triangles.push_back(V1);
+    Triangles.push_back(V2);
+    HalfEdges.insert(HalfEdges.end(), 3, -1);
+    Constrained.insert(Constrained.end(), 3, FALSE);
+  }
+  else
+  {
+    t = FreeTriangles.back() * 3;
+    FreeTriangles.pop_back();
+    Triangles[t] = V0;
+    Triangles[t + 1] = V1;
+    Triangles[t + 2] = V2;
+  }
+  Link(t, A);
+  Link(t + 1, B);
+  Link(t + 2, C);
+  return t;
+} /* End of 'delaunay::AddTriangle' function */
+
+/* Remove triangle function.
+ * ARGUMENTS:
+ *   - triangle:
+ *       INT T;
+ * RETURNS: None.
+ */
+VOID delaunay::RemoveTriangle( INT T )
+{
+  for (INT e = T * 3; e < T * 3 + 3; e++)
+  {
+    if (HalfEdges[e] != -1)
+      Link(HalfEdges[e], -1);
+    Triangles[e] = -1;
+    HalfEdges[e] = -1;
+    Constrained[e] = FALSE;
+  }
+  if (T < (INT)IsInside.size())
+    IsInside[T] = FALSE;
+  FreeTriangles.push_back(T);
+} /* End of 'delaunay::RemoveTriangle' function */
+
+/* Get sweep hull hash key of point function.
+ * ARGUMENTS:
+ *   - vertex:
+ *       INT V;
+ * RETURNS:
+ *   (INT) hash key.
+ */
+INT delaunay::HashKey( INT V ) const
+{
+  DBL dx = X[V] - CenterX, dy = Y[V] - CenterY, len = fabs(dx) + fabs(dy);
+
+  if (len == 0)
+    return 0;
+
+  // Monotonic in angle pseudo angle in [0; 1]
+  DBL p = dx / len, angle = (dy > 0 ? 3 - p : 1 + p) / 4;
+  INT size = (INT)HullHash.size();
+
+  return mth::Clamp((INT)floor(angle * size), 0, size - 1);
+} /* End of 'delaunay::HashKey' function */
+
+/* Flip edge between two triangles function.
+ * ARGUMENTS:
+ *   - half-edge to flip (should have opposite):
+ *       INT A;
+ * RETURNS: None.
+ */
+VOID delaunay::Flip( INT A )
+{
+  /*           pl                    pl
+   *          /||\                  /  \
+   *       al/ || \bl            al/    \a
+   *        /  ||  \              /      \
+   *       /  a||b  \    flip    /___ar___\
+   *     p0\   ||   /p1   =>   p0\---bl---/p1
+   *        \  ||  /              \      /
+   *       ar\ || /br             b\    /br
+   *          \||/                  \  /
+   *           pr                    pr
+   */
+  INT
+    B = HalfEdges[A],
+    al = NextEdge(A), ar = PrevEdge(A),
+    br = NextEdge(B), bl = PrevEdge(B),
+    p0 = Triangles[ar], pr = Triangles[A], pl = Triangles[al], p1 = Triangles[bl],
+    hbl = HalfEdges[bl], har = HalfEdges[ar];
+  BYTE cbl = Constrained[bl], car = Constrained[ar];
+
+  Triangles[A] = p1;
+  Triangles[B] = p0;
+
+  // Edge swapped on the other side of the hull, fix hull reference
+  if (hbl == -1 && IsSweep)
+  {
+    INT e = HullStart;
+    do
+    {
+      if (HullTri[e] == bl)
+      {
+        HullTri[e] = A;
+        break;
+      }
+      e = HullPrev[e];
+    } while (e != HullStart);
+  }
+
+  Link(A, hbl);
+  Link(B, har);
+  Link(ar, bl);
+  Constrained[A] = cbl;
+  Constrained[B] = car;
+  Constrained[ar] = Constrained[bl] = FALSE;
+
+  if (!VertexEdge.empty())
+  {
+    VertexEdge[p0] = ar;
+    VertexEdge[p1] = bl;
+    VertexEdge[pr] = br;
+    VertexEdge[pl] = al;
+  }
+} /* End of 'delaunay::Flip' function */
+
+/* Restore Delaunay condition by flipping edges function.
+ * ARGUMENTS:
+ *   - half-edge, opposite to just added vertex:
+ *       INT A;
+ * RETURNS:
+ *   (INT) half-edge, which is left adjacent to convex hull.
+ */
+INT delaunay::Legalize( INT A )
+{
+  INT ar = 0;
+
+  EdgeStack.clear();
+  while (TRUE)
+  {
+    INT B = HalfEdges[A];
+    ar = PrevEdge(A);
+
+    // Hull and constrained edges are never flipped
+    if (B == -1 || Constrained[A])
+    {
+      if (EdgeStack.empty())
+        break;
+      A = EdgeStack.back();
+      EdgeStack.pop_back();
+      continue;
+    }
+
+    INT
+      al = NextEdge(A), bl = PrevEdge(B),
+      p0 = Triangles[ar], pr = Triangles[A], pl = Triangles[al], p1 = Triangles[bl];
+
+    if (InCircle(p0, pr, pl, p1) > 0)
+    {
+      Flip(A);
+      EdgeStack.push_back(NextEdge(B));
+    }
+    else
+    {
+      if (EdgeStack.empty())
+        break;
+      A = EdgeStack.back();
+      EdgeStack.pop_back();
+    }
+  }
+  return ar;
+} /* End of 'delaunay::Legalize' function */
+
+/* Build unconstrained triangulation by sweep hull function.
+ * ARGUMENTS:
+ *   - vertices, which were not triangulated by sweep:
+ *       std::vector<INT> *Skipped;
+ * RETURNS:
+ *   (BOOL) whether triangulation is not empty.
+ */
+BOOL delaunay::Sweep( std::vector<INT> *Skipped )
+{
+  std::vector<INT> ids;
+  for (INT i = 0, cnt = (INT)Points.size(); i < cnt; i++)
+    if (Canonical[i] == i)
+      ids.push_back(i);
+
+  INT n = (INT)ids.size();
+  if (n < 3)
+    return FALSE;
+
+  // Seed triangle: point closest to bounding box center, its nearest neighbour and
+  // point giving the smallest circumcircle
+  DBL min_x = INFINITY, min_y = INFINITY, max_x = -INFINITY, max_y = -INFINITY;
+  for (INT i : ids)
+  {
+    min_x = mth::Min(min_x, X[i]), max_x = mth::Max(max_x, X[i]);
+    min_y = mth::Min(min_y, Y[i]), max_y = mth::Max(max_y, Y[i]);
+  }
+  DBL cx = (min_x + max_x) / 2, cy = (min_y + max_y) / 2, min_dist = INFINITY;
+  INT i0 = -1, i1 = -1, i2 = -1;
+
+  for (INT i : ids)
+  {
+    DBL d = (X[i] - cx) * (X[i] - cx) + (Y[i] - cy) * (Y[i] - cy);
+    if (d < min_dist)
+      i0 = i, min_dist = d;
+  }
+  min_dist = INFINITY;
+  for (INT i : ids)
+  {
+    DBL d = (X[i] - X[i0]) * (X[i] - X[i0]) + (Y[i] - Y[i0]) * (Y[i] - Y[i0]);
+    if (i != i0 && d < min_dist && d > 0)
+      i1 = i, min_dist = d;
+  }
+
+  const auto GetCircumcenter = [&]( INT A, INT B, INT C, DBL *Cx, DBL *Cy )
+  {
+    DBL
+      dx = X[B] - X[A], dy = Y[B] - Y[A],
+      ex = X[C] - X[A], ey = Y[C] - Y[A],
+      bl = dx * dx + dy * dy, cl = ex * ex + ey * ey,
+      d = 0.5 / (dx * ey - dy * ex);
+
+    *Cx = X[A] + (ey * bl - dy * cl) * d;
+    *Cy = Y[A] + (dx * cl - ex * bl) * d;
+  };
+
+  DBL min_radius = INFINITY;
+  for (INT i : ids)
+  {
+    if (i == i0 || i == i1)
+      continue;
+
+    DBL ccx, ccy;
+    GetCircumcenter(i0, i1, i, &ccx, &ccy);
+    DBL r = (ccx - X[i0]) * (ccx - X[i0]) + (ccy - Y[i0]) * (ccy - Y[i0]);
+    if (r < min_radius)
+      i2 = i, min_radius = r;
+  }
+
+  // All points are collinear
+  if (i2 == -1 || min_radius == INFINITY)
+    return FALSE;
+
+  if (Orient(i0, i1, i2) < 0)
+    std::swap(i1, i2);
+  GetCircumcenter(i0, i1, i2, &CenterX, &CenterY);
+
+  // Sort points by distance from seed circumcenter
+  std::vector<DBL> dists(Points.size());
+  for (INT i : ids)
+    dists[i] = (X[i] - CenterX) * (X[i] - CenterX) + (Y[i] - CenterY) * (Y[i] - CenterY);
+  std::sort(ids.begin(), ids.end(), [&]( INT A, INT B )
+            {
+              return dists[A] < dists[B] || (dists[A] == dists[B] && A < B);
+            });
+
+  // Initial counterclockwise hull
+  size_t cnt = Points.size();
+  HullPrev.assign(cnt, 0);
+  HullNext.assign(cnt, 0);
+  HullTri.assign(cnt, 0);
+  HullHash.assign((size_t)ceil(sqrt((DBL)n)), -1);
+
+  HullStart = i0;
+  HullNext[i0] = HullPrev[i2] = i1;
+  HullNext[i1] = HullPrev[i0] = i2;
+  HullNext[i2] = HullPrev[i1] = i0;
+  HullTri[i0] = 0;
+  HullTri[i1] = 1;
+  HullTri[i2] = 2;
+  HullHash[HashKey(i0)] = i0;
+  HullHash[HashKey(i1)] = i1;
+  HullHash[HashKey(i2)] = i2;
+
+  Triangles.reserve(mth::Max(2 * n - 5, 0) * 3);
+  HalfEdges.reserve(mth::Max(2 * n - 5, 0) * 3);
+  Constrained.reserve(mth::Max(2 * n - 5, 0) * 3);
+  AddTriangle(i0, i1, i2, -1, -1, -1);
+
+  IsSweep = TRUE;
+  for (INT i : ids)
+  {
+    if (i == i0 || i == i1 || i == i2)
+      continue;
+
+    // Find visible edge on the hull using hash
+    INT start = 0, key = HashKey(i), size = (INT)HullHash.size();
+    for (INT j = 0; j < size; j++)
+    {
+      start = HullHash[(key + j) % size];
+      if (start != -1 && start != HullNext[start])
+        break;
+    }
+
+    start = HullPrev[start];
+    INT e = start, q;
+    while (q = HullNext[e], Orient(e, q, i) >= 0)
+    {
+      e = q;
+      if (e == start)
+      {
+        e = -1;
+        break;
+      }
+    }
+
+    // Point lies on hull edge, it is inserted after sweep
+    if (e == -1)
+    {
+      Skipped->push_back(i);
+      continue;
+    }
+
+    // Add first triangle from the point
+    INT t = AddTriangle(e, i, HullNext[e], -1, -1, HullTri[e]);
+    HullTri[i] = Legalize(t + 2);
+    HullTri[e] = t;
+
+    // Walk forward through the hull, adding more triangles and flipping recursively
+    INT next = HullNext[e];
+    while (q = HullNext[next], Orient(next, q, i) < 0)
+    {
+      t = AddTriangle(next, i, q, HullTri[i], -1, HullTri[next]);
+      HullTri[i] = Legalize(t + 2);
+      HullNext[next] = next; // Mark as removed
+      next = q;
+    }
+
+    // Walk backward from the other side, adding more triangles and flipping
+    if (e == start)
+      while (q = HullPrev[e], Orient(q, e, i) < 0)
+      {
+        t = AddTriangle(q, i, e, -1, HullTri[e], HullTri[q]);
+        Legalize(t + 2);
+        HullTri[q] = t;
+        HullNext[e] = e; // Mark as removed
+        e = q;
+      }
+
+    // Update the hull indices
+    HullStart = HullPrev[i] = e;
+    HullNext[e] = HullPrev[next] = i;
+    HullNext[i] = next;
+
+    HullHash[HashKey(i)] = i;
+    HullHash[HashKey(e)] = e;
+  }
+  IsSweep = FALSE;
+
+  return TRUE;
+} /* End of 'delaunay::Sweep' function */
+
+/* Collect all half-edges going out of vertex function.
+ * ARGUMENTS:
+ *   - vertex:
+ *       INT V;
+ *   - half-edges container:
+ *       std::vector<INT> *Star;
+ * RETURNS: None.
+ */
+VOID delaunay::GetStar( INT V, std::vector<INT> *Star ) const
+{
+  INT e0 = VertexEdge[V], e = e0;
+
+  Star->clear();
+  if (e0 == -1)
+    return;
+
+  // Rotate counterclockwise
+  do
+  {
+    Star->push_back(e);
+    e = HalfEdges[PrevEdge(e)];
+  } while (e != -1 && e != e0);
+
+  // Hull reached, rotate clockwise from the start
+  if (e == -1)
+    for (INT t = HalfEdges[e0]; t != -1; t = HalfEdges[e])
+    {
+      e = NextEdge(t);
+      Star->push_back(e);
+    }
+} /* End of 'delaunay::GetStar' function */
+
+/* Find half-edge between two vertices function.
+ * ARGUMENTS:
+ *   - edge vertices:
+ *       INT A, INT B;
+ * RETURNS:
+ *   (INT) half-edge going from A to B or -1 if vertices are not connected.
+ */
+INT delaunay::FindEdge( INT A, INT B ) const
+{
+  INT e0 = VertexEdge[A], e = e0;
+
+  if (e0 == -1)
+    return -1;
+
+  do
+  {
+    if (Triangles[NextEdge(e)] == B)
+      return e;
+    e = HalfEdges[PrevEdge(e)];
+  } while (e != -1 && e != e0);
+
+  if (e == -1)
+    for (INT t = HalfEdges[e0]; t != -1; t = HalfEdges[e])
+    {
+      e = NextEdge(t);
+      if (Triangles[NextEdge(e)] == B)
+        return e;
+    }
+  return -1;
+} /* End of 'delaunay::FindEdge' function */
+
+/* Insert vertex to built triangulation function.
+ * ARGUMENTS:
+ *   - vertex:
+ *       INT V;
+ *   - triangle to start point location walk from:
+ *       INT Start;
+ * RETURNS:
+ *   (BOOL) whether vertex inserted.
+ */
+BOOL delaunay::InsertVertex( INT V, INT Start )
+{
+  // Stochastic walk to triangle containing vertex
+  INT t = Start, steps = (INT)Triangles.size() + 3;
+  UINT rnd = (UINT)V * 2654435761u;
+  while (steps-- > 0)
+  {
+    BOOL is_moved = FALSE;
+
+    rnd = rnd * 1103515245 + 12345;
+    for (INT k = 0; k < 3; k++)
+    {
+      INT e = t * 3 + (INT)((k + (rnd >> 16)) % 3);
+      if (Orient(Triangles[e], Triangles[NextEdge(e)], V) < 0)
+      {
+        if (HalfEdges[e] == -1)
+        {
+          InsertOutside(V, e);
+          return TRUE;
+        }
+        t = HalfEdges[e] / 3;
+        is_moved = TRUE;
+        break;
+      }
+    }
+    if (!is_moved)
+      break;
+  }
+  if (steps < 0)
+    return FALSE;
+
+  // Vertex on triangle edge: split edge and its neighbour triangle
+  for (INT e = t * 3; e < t * 3 + 3; e++)
+  {
+    INT u = Triangles[e], w = Triangles[NextEdge(e)];
+
+    if ((X[u] == X[V] && Y[u] == Y[V]) || (X[w] == X[V] && Y[w] == Y[V]))
+    {
+      Canonical[V] = (X[u] == X[V] && Y[u] == Y[V]) ? u : w;
+      return TRUE;
+    }
+    if (Orient(u, w, V) != 0)
+      continue;
+
+    INT
+      a = e, b = HalfEdges[e],
+      a1 = NextEdge(a), a2 = PrevEdge(a),
+      x = Triangles[a2], ha1 = HalfEdges[a1];
+    BYTE ca = Constrained[a], ca1 = Constrained[a1];
+
+    // (u, w, x) -> (u, V, x) + (V, w, x)
+    Triangles[a1] = V;
+    INT ta = AddTriangle(V, w, x, -1, ha1, a1);
+    Constrained[ta + 1] = ca1;
+    Constrained[a1] = FALSE;
+    Constrained[ta] = ca;
+
+    VertexEdge[u] = a;
+    VertexEdge[w] = ta + 1;
+    VertexEdge[x] = a2;
+    VertexEdge[V] = a1;
+
+    if (b != -1)
+    {
+      // (w, u, y) -> (w, V, y) + (V, u, y)
+      INT b1 = NextEdge(b), b2 = PrevEdge(b), y = Triangles[b2], hb1 = HalfEdges[b1];
+      BYTE cb1 = Constrained[b1];
+
+      Triangles[b1] = V;
+      INT tb = AddTriangle(V, u, y, a, hb1, b1);
+      Constrained[tb + 1] = cb1;
+      Constrained[b1] = FALSE;
+      Constrained[tb] = ca;
+      Link(b, ta);
+      VertexEdge[y] = b2;
+
+      Legalize(b2);
+      Legalize(tb + 1);
+    }
+    Legalize(a2);
+    Legalize(ta + 1);
+    return TRUE;
+  }
+
+  // Vertex strictly inside triangle: split it to three
+  INT
+    e0 = t * 3, e1 = e0 + 1, e2 = e0 + 2,
+    v0 = Triangles[e0], v1 = Triangles[e1], v2 = Triangles[e2],
+    h1 = HalfEdges[e1], h2 = HalfEdges[e2];
+  BYTE c1 = Constrained[e1], c2 = Constrained[e2];
+
+  Triangles[e2] = V;
+  INT t1 = AddTriangle(v1, v2, V, h1, -1, e1);
+  INT t2 = AddTriangle(v2, v0, V, h2, e2, t1 + 1);
+  Constrained[t1] = c1;
+  Constrained[t2] = c2;
+  Constrained[e1] = Constrained[e2] = FALSE;
+
+  VertexEdge[v0] = e0;
+  VertexEdge[v1] = t1;
+  VertexEdge[v2] = t2;
+  VertexEdge[V] = e2;
+
+  Legalize(e0);
+  Legalize(t1);
+  Legalize(t2);
+  return TRUE;
+} /* End of 'delaunay::InsertVertex' function */
+
+/* Insert vertex outside of convex hull function.
+ * Triangles are added to all hull edges visible from vertex, so hull stays convex.
+ * ARGUMENTS:
+ *   - vertex:
+ *       INT V;
+ *   - hull half-edge visible from vertex:
+ *       INT E;
+ * RETURNS: None.
+ */
+VOID delaunay::InsertOutside( INT V, INT E )
+{
+  INT u = Triangles[E], w = Triangles[NextEdge(E)];
+  INT t = AddTriangle(w, u, V, E, -1, -1);
+  INT left = t + 1, right = t + 2; // Fan hull edges (u, V) and (V, w)
+
+  Constrained[t] = Constrained[E];
+  VertexEdge[V] = right;
+
+  // Walk forward through the hull, hull half-edge going out of vertex is the most clockwise one
+  while (TRUE)
+  {
+    INT e = NextEdge(right);
+    while (HalfEdges[e] != -1)
+      e = NextEdge(HalfEdges[e]);
+
+    INT x = Triangles[NextEdge(e)];
+    if (Orient(w, x, V) >= 0)
+      break;
+    t = AddTriangle(x, w, V, e, right, -1);
+    Constrained[t] = Constrained[e];
+    right = t + 2, w = x;
+  }
+
+  // Walk backward, hull half-edge coming to vertex is the most counterclockwise one
+  while (TRUE)
+  {
+    INT e = PrevEdge(left);
+    while (HalfEdges[e] != -1)
+      e = PrevEdge(HalfEdges[e]);
+
+    INT y = Triangles[e];
+    if (Orient(y, u, V) >= 0)
+      break;
+    t = AddTriangle(u, y, V, e, -1, left);
+    Constrained[t] = Constrained[e];
+    VertexEdge[u] = t;
+    left = t + 1, u = y;
+  }
+} /* End of 'delaunay::InsertOutside' function */
+
+/* Collect half-edges going out of vertex in counterclockwise order function.
+ * ARGUMENTS:
+ *   - vertex:
+ *       INT V;
+ *   - half-edges container (starts with hull edge for hull vertex):
+ *       std::vector<INT> *Fan;
+ * RETURNS:
+ *   (BOOL) whether vertex is on convex hull.
+ */
+BOOL delaunay::GetFan( INT V, std::vector<INT> *Fan ) const
+{
+  INT e0 = VertexEdge[V], e = e0;
+  BOOL is_hull = FALSE;
+
+  // Rotate clockwise to the hull edge
+  while (TRUE)
+  {
+    INT t = HalfEdges[e];
+    if (t == -1)
+    {
+      is_hull = TRUE;
+      e0 = e;
+      break;
+    }
+    e = NextEdge(t);
+    if (e == e0)
+      break;
+  }
+
+  Fan->clear();
+  e = e0;
+  do
+  {
+    Fan->push_back(e);
+    e = HalfEdges[PrevEdge(e)];
+  } while (e != -1 && e != e0);
+  return is_hull;
+} /* End of 'delaunay::GetFan' function */
+
+/* Remove vertex from triangulation function.
+ * Inner vertex star is flipped to three triangles, which are merged,
+ * hull vertex triangles are removed and hull pockets are filled to keep it convex.
+ * ARGUMENTS:
+ *   - vertex:
+ *       INT V;
+ * RETURNS:
+ *   (BOOL) whether vertex removed.
+ */
+BOOL delaunay::RemoveVertex( INT V )
+{
+  std::vector<INT> fan;
+
+  if (!GetFan(V, &fan))
+  {
+    // Flip edges going out of vertex, until only three triangles left
+    while (fan.size() > 3)
+    {
+      INT flip = -1;
+
+      for (INT s : fan)
+      {
+        INT a = Triangles[NextEdge(s)], b = Triangles[PrevEdge(s)], c = Triangles[PrevEdge(HalfEdges[s])];
+        DBL ov = Orient(b, c, V), oa = Orient(b, c, a);
+
+        if ((ov > 0 && oa < 0) || (ov < 0 && oa > 0))
+        {
+          flip = s;
+          break;
+        }
+      }
+      if (flip == -1)
+        return FALSE;
+      Flip(flip);
+      GetFan(V, &fan);
+    }
+
+    // Merge three triangles to one
+    INT link[3], twin[3];
+    BYTE is_constrained[3];
+    for (INT i = 0; i < 3; i++)
+    {
+      INT l = NextEdge(fan[i]);
+
+      link[i] = Triangles[l];
+      twin[i] = HalfEdges[l];
+      is_constrained[i] = Constrained[l];
+    }
+    for (INT s : fan)
+      RemoveTriangle(s / 3);
+
+    INT t = AddTriangle(link[0], link[1], link[2], twin[0], twin[1], twin[2]);
+    for (INT i = 0; i < 3; i++)
+    {
+      Constrained[t + i] = is_constrained[i];
+      VertexEdge[link[i]] = t + i;
+    }
+    VertexEdge[V] = -1;
+    return TRUE;
+  }
+
+  // Hull vertex: boundary after removal goes by link edges in reversed order
+  INT k = (INT)fan.size();
+  std::vector<INT> boundary(k + 1), edges(k);
+  for (INT i = 0; i < k; i++)
+  {
+    INT l = NextEdge(fan[i]);
+
+    if (HalfEdges[l] == -1)
+      return FALSE;
+    boundary[k - i] = Triangles[l];
+    edges[k - 1 - i] = HalfEdges[l];
+  }
+  boundary[0] = Triangles[PrevEdge(fan[k - 1])];
+
+  for (INT s : fan)
+    RemoveTriangle(s / 3);
+  for (INT j = 0; j < k; j++)
+    VertexEdge[boundary[j]] = edges[j];
+  VertexEdge[boundary[k]] = NextEdge(edges[k - 1]);
+  VertexEdge[V] = -1;
+
+  // Fill reflex boundary vertices, stack keeps convex chain and its edges
+  std::vector<INT> chain {boundary[0]}, chain_edges {-1};
+  for (INT j = 1; j <= k; j++)
+  {
+    INT b = boundary[j], h = edges[j - 1];
+
+    while (chain.size() >= 2 && Orient(chain[chain.size() - 2], chain.back(), b) < 0)
+    {
+      INT t = AddTriangle(chain[chain.size() - 2], b, chain.back(), -1, h, chain_edges.back());
+
+      Constrained[t + 1] = Constrained[h];
+      Constrained[t + 2] = Constrained[chain_edges.back()];
+      VertexEdge[chain[chain.size() - 2]] = t;
+      h = t;
+      chain.pop_back();
+      chain_edges.pop_back();
+    }
+    chain.push_back(b);
+    chain_edges.push_back(h);
+  }
+  return TRUE;
+} /* End of 'delaunay::RemoveVertex' function */
+
+/* Restore Delaunay condition on touched triangles by flipping edges function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID delaunay::LegalizeTouched( VOID )
+{
+  EdgeStack.clear();
+  for (INT t : Touched)
+    if (Triangles[t * 3] != -1)
+      for (INT e = t * 3; e < t * 3 + 3; e++)
+        EdgeStack.push_back(e);
+
+  while (!EdgeStack.empty())
+  {
+    INT A = EdgeStack.back(), B = HalfEdges[A];
+    EdgeStack.pop_back();
+
+    // Hull and constrained edges are never flipped
+    if (B == -1 || Constrained[A])
+      continue;
+
+    INT
+      al = NextEdge(A), ar = PrevEdge(A), bl = PrevEdge(B),
+      p0 = Triangles[ar], pr = Triangles[A], pl = Triangles[al], p1 = Triangles[bl];
+
+    if (InCircle(p0, pr, pl, p1) > 0)
+    {
+      Flip(A);
+      for (INT e = 0; e < 3; e++)
+      {
+        EdgeStack.push_back(A / 3 * 3 + e);
+        EdgeStack.push_back(B / 3 * 3 + e);
+      }
+    }
+  }
+} /* End of 'delaunay::LegalizeTouched' function */
+
+/* Classify touched triangles by neighbours function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID delaunay::ClassifyTouched( VOID )
+{
+  INT tri_cnt = (INT)Triangles.size() / 3;
+  std::deque<INT> queue;
+
+  IsInside.resize(tri_cnt, FALSE);
+  IsTouched.resize(tri_cnt, FALSE);
+  for (INT t : Touched)
+    IsTouched[t] = Triangles[t * 3] != -1;
+
+  // Touched triangles near not touched ones or hull are classified first, crossing constrained edge changes side
+  for (INT t : Touched)
+  {
+    if (!IsTouched[t])
+      continue;
+    for (INT e = t * 3; e < t * 3 + 3; e++)
+    {
+      INT o = HalfEdges[e];
+
+      if (o == -1 || !IsTouched[o / 3])
+      {
+        IsInside[t] = (o == -1 ? FALSE : IsInside[o / 3]) != (BOOL)Constrained[e];
+        IsTouched[t] = FALSE;
+        queue.push_back(t);
+        break;
+      }
+    }
+  }
+  while (!queue.empty())
+  {
+    INT t = queue.front();
+    queue.pop_front();
+
+    for (INT e = t * 3; e < t * 3 + 3; e++)
+    {
+      INT o = HalfEdges[e];
+
+      if (o != -1 && IsTouched[o / 3])
+      {
+        IsInside[o / 3] = IsInside[t] != (BOOL)Constrained[e];
+        IsTouched[o / 3] = FALSE;
+        queue.push_back(o / 3);
+      }
+    }
+  }
+  for (INT t : Touched)
+    IsTouched[t] = FALSE;
+  Touched.clear();
+} /* End of 'delaunay::ClassifyTouched' function */
+
+/* Insert constrained edge function.
+ * ARGUMENTS:
+ *   - edge vertices:
+ *       INT A, INT B;
+ * RETURNS:
+ *   (BOOL) whether edge inserted (FALSE if it crosses another constrained edge).
+ */
+BOOL delaunay::InsertConstraint( INT A, INT B )
+{
+  std::vector<INT> star;
+  std::deque<std::pair<INT, INT>> crossed;
+  std::vector<std::pair<INT, INT>> created;
+
+  const auto MarkConstrained = [&]( INT E )
+  {
+    Constrained[E] = TRUE;
+    if (HalfEdges[E] != -1)
+      Constrained[HalfEdges[E]] = TRUE;
+    if (IsTracking)
+      Touched.push_back(E / 3);
+  };
+
+  while (A != B)
+  {
+    // Edge already exists (hull edge may exist only in opposite direction)
+    INT e = FindEdge(A, B);
+    if (e == -1)
+      e = FindEdge(B, A);
+    if (e != -1)
+    {
+      MarkConstrained(e);
+      return TRUE;
+    }
+
+    // Vertex lying on the segment splits it
+    GetStar(A, &star);
+    INT split = -1, cross = -1;
+    DBL len2 = (X[B] - X[A]) * (X[B] - X[A]) + (Y[B] - Y[A]) * (Y[B] - Y[A]);
+    const auto IsOnSegment = [&]( INT V )
+    {
+      DBL dot = (X[V] - X[A]) * (X[B] - X[A]) + (Y[V] - Y[A]) * (Y[B] - Y[A]);
+      return Orient(A, B, V) == 0 && dot > 0 && dot < len2;
+    };
+    for (INT s : star)
+    {
+      // Triangle (A, v, w) which segment goes through or its side lying on segment
+      INT v = Triangles[NextEdge(s)], w = Triangles[PrevEdge(s)];
+
+      if (IsOnSegment(v))
+      {
+        split = s;
+        break;
+      }
+      if (IsOnSegment(w))
+      {
+        split = PrevEdge(s);
+        break;
+      }
+      if (cross == -1 && Orient(A, v, B) > 0 && Orient(A, w, B) < 0)
+        cross = NextEdge(s);
+    }
+    if (split != -1)
+    {
+      MarkConstrained(split);
+      A = Triangles[split] == A ? Triangles[NextEdge(split)] : Triangles[split];
+      continue;
+    }
+    if (cross == -1)
+      return FALSE;
+
+    // Collect edges crossed by segment up to B or to vertex lying on segment
+    INT end = B;
+    crossed.clear();
+    while (TRUE)
+    {
+      if (Constrained[cross])
+        return FALSE;
+      crossed.push_back({Triangles[cross], Triangles[NextEdge(cross)]});
+
+      INT t = HalfEdges[cross];
+      if (t == -1)
+        return FALSE;
+
+      INT w = Triangles[PrevEdge(t)];
+      if (w == B)
+        break;
+
+      DBL o = Orient(A, B, w);
+      if (o == 0)
+      {
+        end = w;
+        break;
+      }
+      cross = o > 0 ? NextEdge(t) : PrevEdge(t);
+    }
+
+    // Flip crossed edges away until segment becomes an edge
+    created.clear();
+    size_t guard = crossed.size() * crossed.size() * 4 + 16;
+    while (!crossed.empty())
+    {
+      if (guard-- == 0)
+        return FALSE;
+
+      std::pair<INT, INT> edge = crossed.front();
+      crossed.pop_front();
+
+      INT c = FindEdge(edge.first, edge.second);
+      if (c == -1 || HalfEdges[c] == -1)
+        continue;
+
+      INT
+        p = edge.first, q = edge.second,
+        r = Triangles[PrevEdge(c)], s = Triangles[PrevEdge(HalfEdges[c])];
+
+      // Only strictly convex quadrilateral can be flipped
+      DBL op = Orient(r, s, p), oq = Orient(r, s, q);
+      if (!((op > 0 && oq < 0) || (op < 0 && oq > 0)))
+      {
+        crossed.push_back(edge);
+        continue;
+      }
+      Flip(c);
+
+      // New diagonal still crosses segment
+      DBL orr = Orient(A, end, r), os = Orient(A, end, s);
+      if (r != A && r != end && s != A && s != end && ((orr > 0 && os < 0) || (orr < 0 && os > 0)))
+        crossed.push_back({r, s});
+      else
+        created.push_back({r, s});
+    }
+
+    e = FindEdge(A, end);
+    if (e == -1)
+      e = FindEdge(end, A);
+    if (e == -1)
+      return FALSE;
+    MarkConstrained(e);
+
+    // Restore Delaunay condition for new edges
+    BOOL is_flipped = TRUE;
+    for (INT iteration = 0; is_flipped && iteration < 64; iteration++)
+    {
+      is_flipped = FALSE;
+      for (std::pair<INT, INT> &edge : created)
+      {
+        INT c = FindEdge(edge.first, edge.second);
+        if (c == -1 || HalfEdges[c] == -1 || Constrained[c])
+          continue;
+
+        INT r = Triangles[PrevEdge(c)], s = Triangles[PrevEdge(HalfEdges[c])];
+        if (InCircle(edge.first, edge.second, r, s) > 0)
+        {
+          Flip(c);
+          edge = {r, s};
+          is_flipped = TRUE;
+        }
+      }
+    }
+    A = end;
+  }
+  return TRUE;
+} /* End of 'delaunay::InsertConstraint' function */
+
+/* Triangulate polygons set function.
+ * ARGUMENTS:
+ *   - polygons, which segments become constrained edges:
+ *       const std::vector<polygon> &Polygons;
+ *   - index buffer to add triangles (three points pool indexes per triangle) inside polygons to:
+ *       std::vector<size_t> *Result;
+ * RETURNS:
+ *   (BOOL) FALSE if some segments crossed each other and were not inserted, TRUE otherwise.
+ */
+BOOL delaunay::Triangulate( const std::vector<polygon> &Polygons, std::vector<size_t> *Result )
+{
+  Points.clear();
+  Triangles.clear();
+  HalfEdges.clear();
+  Constrained.clear();
+  VertexEdge.clear();
+  IsInside.clear();
+  FreeTriangles.clear();
+
+  // Mesh vertices are all segments points
+  for (const polygon &polly : Polygons)
+    for (const segment &seg : polly.Lines)
+      Points.push_back(seg.St), Points.push_back(seg.End);
+  std::sort(Points.begin(), Points.end());
+  Points.erase(std::unique(Points.begin(), Points.end()), Points.end());
+
+  INT n = (INT)Points.size();
+  const FLT *pool_x = Pool.GetX(), *pool_y = Pool.GetY();
+  X.resize(n), Y.resize(n);
+  for (INT i = 0; i < n; i++)
+    X[i] = pool_x[Points[i]], Y[i] = pool_y[Points[i]];
+
+  // Points with equal coordinates are triangulated once
+  std::vector<INT> order(n);
+  for (INT i = 0; i < n; i++)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&]( INT A, INT B )
+            {
+              return X[A] < X[B] || (X[A] == X[B] && (Y[A] < Y[B] || (Y[A] == Y[B] && A < B)));
+            });
+  Canonical.resize(n);
+  IsShared.assign(n, FALSE);
+  for (INT k = 0; k < n; k++)
+  {
+    Canonical[order[k]] = k > 0 && X[order[k]] == X[order[k - 1]] && Y[order[k]] == Y[order[k - 1]] ?
+                          Canonical[order[k - 1]] : order[k];
+    if (Canonical[order[k]] != order[k])
+      IsShared[order[k]] = IsShared[Canonical[order[k]]] = TRUE;
+  }
+
+  std::vector<INT> skipped;
+  if (!Sweep(&skipped))
+    return TRUE;
+
+  VertexEdge.assign(n, -1);
+  for (INT e = 0, cnt = (INT)Triangles.size(); e < cnt; e++)
+    VertexEdge[Triangles[e]] = e;
+  for (INT v : skipped)
+    InsertVertex(v, (INT)Triangles.size() / 3 - 1);
+
+  // Insert all segments as constrained edges
+  BOOL is_ok = TRUE;
+  const auto GetVertex = [&]( size_t Index )
+  {
+    return Canonical[std::lower_bound(Points.begin(), Points.end(), Index) - Points.begin()];
+  };
+  for (const polygon &polly : Polygons)
+    for (const segment &seg : polly.Lines)
+    {
+      INT a = GetVertex(seg.St), b = GetVertex(seg.End);
+      if (a != b && VertexEdge[a] != -1 && VertexEdge[b] != -1)
+        is_ok &= InsertConstraint(a, b);
+    }
+
+  // Even-odd classification: count constrained edges crossed from the hull
+  INT tri_cnt = (INT)Triangles.size() / 3;
+  std::vector<INT> depth(tri_cnt, -1);
+  std::deque<INT> queue;
+
+  for (INT e = 0, cnt = (INT)Triangles.size(); e < cnt; e++)
+    if (HalfEdges[e] == -1)
+    {
+      INT t = e / 3, d = Constrained[e] ? 1 : 0;
+      if (depth[t] == -1 || d < depth[t])
+      {
+        depth[t] = d;
+        if (d == 0)
+          queue.push_front(t);
+        else
+          queue.push_back(t);
+      }
+    }
+  while (!queue.empty())
+  {
+    INT t = queue.front();
+    queue.pop_front();
+
+    for (INT e = t * 3; e < t * 3 + 3; e++)
+    {
+      INT o = HalfEdges[e];
+      if (o == -1)
+        continue;
+
+      INT nt = o / 3, nd = depth[t] + Constrained[e];
+      if (depth[nt] == -1 || nd < depth[nt])
+      {
+        depth[nt] = nd;
+        if (Constrained[e])
+          queue.push_back(nt);
+        else
+          queue.push_front(nt);
+      }
+    }
+  }
+
+  IsInside.resize(tri_cnt);
+  for (INT t = 0; t < tri_cnt; t++)
+    IsInside[t] = depth[t] % 2 == 1 && Triangles[t * 3] != -1;
+  GetTriangles(Result);
+  return is_ok;
+} /* End of 'delaunay::Triangulate' function */
+
+/* Update triangulation after point moving function.
+ * Points which are not triangulated are ignored.
+ * ARGUMENTS:
+ *   - moved point index in points pool:
+ *       size_t Index;
+ * RETURNS:
+ *   (BOOL) whether triangulation updated, if FALSE it should be built again.
+ */
+BOOL delaunay::MovePoint( size_t Index )
+{
+  auto found = std::lower_bound(Points.begin(), Points.end(), Index);
+  if (found == Points.end() || *found != Index)
+    return TRUE;
+
+  INT v = (INT)(found - Points.begin());
+  if (VertexEdge.empty() || VertexEdge[v] == -1 || IsShared[v] || Index >= Pool.Size())
+    return FALSE;
+
+  DBL x = Pool.GetX()[Index], y = Pool.GetY()[Index], old_x = X[v], old_y = Y[v];
+  if (x == old_x && y == old_y)
+    return TRUE;
+
+  std::vector<INT> fan, constrained;
+  BOOL is_hull = GetFan(v, &fan);
+
+  Touched.clear();
+  IsTracking = TRUE;
+
+  // Inner vertex stays inside its star: only flips are needed
+  X[v] = x, Y[v] = y;
+  BOOL is_inside_star = !is_hull;
+  for (size_t i = 0; i < fan.size() && is_inside_star; i++)
+    is_inside_star = Orient(v, Triangles[NextEdge(fan[i])], Triangles[PrevEdge(fan[i])]) > 0;
+
+  if (is_inside_star)
+    for (INT s : fan)
+      Touched.push_back(s / 3);
+  else
+  {
+    // Vertex is removed and inserted again, its constrained edges are restored
+    X[v] = old_x, Y[v] = old_y;
+    for (INT s : fan)
+    {
+      if (Constrained[s])
+        constrained.push_back(Triangles[NextEdge(s)]);
+      if (Constrained[PrevEdge(s)])
+        constrained.push_back(Triangles[PrevEdge(s)]);
+    }
+    std::sort(constrained.begin(), constrained.end());
+    constrained.erase(std::unique(constrained.begin(), constrained.end()), constrained.end());
+
+    INT start = Triangles[NextEdge(fan[0])];
+    BOOL is_ok = RemoveVertex(v);
+
+    X[v] = x, Y[v] = y;
+    is_ok = is_ok && InsertVertex(v, VertexEdge[start] / 3) && Canonical[v] == v;
+    for (size_t i = 0; i < constrained.size() && is_ok; i++)
+      is_ok = InsertConstraint(v, constrained[i]);
+    if (!is_ok)
+    {
+      IsTracking = FALSE;
+      return FALSE;
+    }
+  }
+
+  LegalizeTouched();
+  IsTracking = FALSE;
+  ClassifyTouched();
+  return TRUE;
+} /* End of 'delaunay::MovePoint' function */
+
+/* Get triangles inside polygons function.
+ * ARGUMENTS:
+ *   - index buffer to add triangles (three points pool indexes per triangle) to:
+ *       std::vector<size_t> *Result;
+ * RETURNS: None.
+ */
+VOID delaunay::GetTriangles( std::vector<size_t> *Result ) const
+{
+  INT tri_cnt = (INT)Triangles.size() / 3;
+  size_t inside_cnt = 0;
+
+  // Removed triangles are never inside
+  for (INT t = 0; t < tri_cnt; t++)
+    inside_cnt += IsInside[t];
+  if (inside_cnt == 0)
+    return;
+
+  // Inside flags go in sweep order almost randomly, so every triangle is written and kept by flag without branches
+  size_t pos = Result->size();
+  Result->resize(pos + inside_cnt * 3 + 3);
+
+  size_t *out = Result->data() + pos;
+  for (INT t = 0; t < tri_cnt; t++)
+  {
+    INT is_inside = IsInside[t], mask = -is_inside;
+
+    // Outside triangle is written as first point copies and then overwritten
+    out[0] = Points[Triangles[t * 3] & mask];
+    out[1] = Points[Triangles[t * 3 + 1] & mask];
+    out[2] = Points[Triangles[t * 3 + 2] & mask];
+    out += is_inside * 3;
+  }
+  Result->resize(pos + inside_cnt * 3);
+} /* End of 'delaunay::GetTriangles' function */
\ No newline at end of file
@@ -0,0 +1,293 @@
+#ifndef __location_delaunay_h_
+#define __location_delaunay_h_
+
+#include "location_points_pool.h"
+#include "location_predicates.h"
+
+class polygon;
+
+/* Constrained Delaunay triangulation class.
+ * Triangulation is built by radial sweep hull algorithm, then every polygon
+ * segment is inserted as constrained edge by flipping crossed edges away,
+ * and triangles are classified by even-odd rule, so enclosed polygons become holes.
+ * Mesh is stored in half-edge arrays: half-edge E belongs to triangle E / 3,
+ * goes from vertex Triangles[E] to the next vertex of triangle.
+ * Built mesh is kept, so moved points are updated locally: vertex is moved
+ * inside its star or removed and inserted again, then only touched triangles
+ * are flipped to Delaunay and classified again.
+ */
+class delaunay
+{
+private:
+  const points_pool &Pool; // Points pool to take polygons points from
+
+  std::vector<size_t> Points;   // Mesh vertices indexes in points pool
+  std::vector<DBL> X, Y;        // Mesh vertices coordinates
+  std::vector<INT> Canonical;   // Vertex with the same coordinates, which is really triangulated
+  std::vector<INT> Triangles;   // Triangles vertices, three per triangle
+  std::vector<INT> HalfEdges;   // Opposite half-edges (-1 for convex hull edges)
+  std::vector<BYTE> Constrained; // Constrained half-edges flags
+  std::vector<INT> VertexEdge;  // Any half-edge going out of vertex
+  std::vector<BYTE> IsShared;   // Has vertex another vertex with the same coordinates flags
+  std::vector<BYTE> IsInside;   // Is triangle inside polygons flags
+  std::vector<INT> FreeTriangles; // Removed triangles, which places are reused
+
+  // Triangles changed by local update
+  std::vector<INT> Touched;
+  std::vector<BYTE> IsTouched;
+  BOOL IsTracking = FALSE;
+
+  // Sweep hull data
+  std::vector<INT> HullPrev, HullNext, HullTri, HullHash;
+  INT HullStart = 0;
+  DBL CenterX = 0, CenterY = 0;
+  BOOL IsSweep = FALSE;
+
+  std::vector<INT> EdgeStack; // Legalization stack
+
+  /* Get next half-edge in triangle function.
+   * ARGUMENTS:
+   *   - half-edge:
+   *       INT E;
+   * RETURNS:
+   *   (INT) next half-edge.
+   */
+  static INT NextEdge( INT E )
+  {
+    return E % 3 == 2 ? E - 2 : E + 1;
+  } /* End of 'NextEdge' function */
+
+  /* Get previous half-edge in triangle function.
+   * ARGUMENTS:
+   *   - half-edge:
+   *       INT E;
+   * RETURNS:
+   *   (INT) previous half-edge.
+   */
+  static INT PrevEdge( INT E )
+  {
+    return E % 3 == 0 ? E + 2 : E - 1;
+  } /* End of 'PrevEdge' function */
+
+  /* Get orientation of three vertices function.
+   * ARGUMENTS:
+   *   - vertices:
+   *       INT A, INT B, INT C;
+   * RETURNS:
+   *   (DBL) positive for counterclockwise, negative for clockwise, zero for collinear vertices.
+   */
+  DBL Orient( INT A, INT B, INT C ) const
+  {
+    return predicates::Orient2d(X[A], Y[A], X[B], Y[B], X[C], Y[C]);
+  } /* End of 'Orient' function */
+
+  /* Check if vertex is inside circumcircle of counterclockwise triangle function.
+   * ARGUMENTS:
+   *   - triangle vertices:
+   *       INT A, INT B, INT C;
+   *   - vertex to check:
+   *       INT D;
+   * RETURNS:
+   *   (DBL) positive if vertex is inside circle, negative if outside, zero if on circle.
+   */
+  DBL InCircle( INT A, INT B, INT C, INT D ) const
+  {
+    return predicates::InCircle(X[A], Y[A], X[B], Y[B], X[C], Y[C], X[D], Y[D]);
+  } /* End of 'InCircle' function */
+
+  /* Link two opposite half-edges function.
+   * ARGUMENTS:
+   *   - half-edges:
+   *       INT A, INT B;
+   * RETURNS: None.
+   */
+  VOID Link( INT A, INT B )
+  {
+    HalfEdges[A] = B;
+    if (B != -1)
+      HalfEdges[B] = A;
+    if (IsTracking)
+    {
+      Touched.push_back(A / 3);
+      if (B != -1)
+        Touched.push_back(B / 3);
+    }
+  } /* End of 'Link' function */
+
+  /* Add triangle function.
+   * ARGUMENTS:
+   *   - triangle vertices:
+   *       INT V0, INT V1, INT V2;
+   *   - opposite half-edges for triangle edges:
+   *       INT A, INT B, INT C;
+   * RETURNS:
+   *   (INT) first half-edge of triangle.
+   */
+  INT AddTriangle( INT V0, INT V1, INT V2, INT A, INT B, INT C );
+
+  /* Remove triangle function.
+   * ARGUMENTS:
+   *   - triangle:
+   *       INT T;
+   * RETURNS: None.
+   */
+  VOID RemoveTriangle( INT T );
+
+  /* Get sweep hull hash key of point function.
+   * ARGUMENTS:
+   *   - vertex:
+   *       INT V;
+   * RETURNS:
+   *   (INT) hash key.
+   */
+  INT HashKey( INT V ) const;
+
+  /* Flip edge between two triangles function.
+   * ARGUMENTS:
+   *   - half-edge to flip (should have opposite):
+   *       INT A;
+   * RETURNS: None.
+   */
+  VOID Flip( INT A );
+
+  /* Restore Delaunay condition by flipping edges function.
+   * ARGUMENTS:
+   *   - half-edge, opposite to just added vertex:
+   *       INT A;
+   * RETURNS:
+   *   (INT) half-edge, which is left adjacent to convex hull.
+   */
+  INT Legalize( INT A );
+
+  /* Build unconstrained triangulation by sweep hull function.
+   * ARGUMENTS:
+   *   - vertices, which were not triangulated by sweep:
+   *       std::vector<INT> *Skipped;
+   * RETURNS:
+   *   (BOOL) whether triangulation is not empty.
+   */
+  BOOL Sweep( std::vector<INT> *Skipped );
+
+  /* Collect all half-edges going out of vertex function.
+   * ARGUMENTS:
+   *   - vertex:
+   *       INT V;
+   *   - half-edges container:
+   *       std::vector<INT> *Star;
+   * RETURNS: None.
+   */
+  VOID GetStar( INT V, std::vector<INT> *Star ) const;
+
+  /* Find half-edge between two vertices function.
+   * ARGUMENTS:
+   *   - edge vertices:
+   *       INT A, INT B;
+   * RETURNS:
+   *   (INT) half-edge going from A to B or -1 if vertices are not connected.
+   */
+  INT FindEdge( INT A, INT B ) const;
+
+  /* Insert vertex to built triangulation function.
+   * ARGUMENTS:
+   *   - vertex:
+   *       INT V;
+   *   - triangle to start point location walk from:
+   *       INT Start;
+   * RETURNS:
+   *   (BOOL) whether vertex inserted.
+   */
+  BOOL InsertVertex( INT V, INT Start );
+
+  /* Insert vertex outside of convex hull function.
+   * Triangles are added to all hull edges visible from vertex, so hull stays convex.
+   * ARGUMENTS:
+   *   - vertex:
+   *       INT V;
+   *   - hull half-edge visible from vertex:
+   *       INT E;
+   * RETURNS: None.
+   */
+  VOID InsertOutside( INT V, INT E );
+
+  /* Collect half-edges going out of vertex in counterclockwise order function.
+   * ARGUMENTS:
+   *   - vertex:
+   *       INT V;
+   *   - half-edges container (starts with hull edge for hull vertex):
+   *       std::vector<INT> *Fan;
+   * RETURNS:
+   *   (BOOL) whether vertex is on convex hull.
+   */
+  BOOL GetFan( INT V, std::vector<INT> *Fan ) const;
+
+  /* Remove vertex from triangulation function.
+   * Inner vertex star is flipped to three triangles, which are merged,
+   * hull vertex triangles are removed and hull pockets are filled to keep it convex.
+   * ARGUMENTS:
+   *   - vertex:
+   *       INT V;
+   * RETURNS:
+   *   (BOOL) whether vertex removed.
+   */
+  BOOL RemoveVertex( INT V );
+
+  /* Restore Delaunay condition on touched triangles by flipping edges function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID LegalizeTouched( VOID );
+
+  /* Classify touched triangles by neighbours function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID ClassifyTouched( VOID );
+
+  /* Insert constrained edge function.
+   * ARGUMENTS:
+   *   - edge vertices:
+   *       INT A, INT B;
+   * RETURNS:
+   *   (BOOL) whether edge inserted (FALSE if it crosses another constrained edge).
+   */
+  BOOL InsertConstraint( INT A, INT B );
+
+public:
+  /* Constrained Delaunay triangulation constructor.
+   * ARGUMENTS:
+   *   - points pool to take polygons points from:
+   *       const points_pool &Pool;
+   */
+  delaunay( const points_pool &Pool );
+
+  /* Triangulate polygons set function.
+   * ARGUMENTS:
+   *   - polygons, which segments become constrained edges:
+   *       const std::vector<polygon> &Polygons;
+   *   - index buffer to add triangles (three points pool indexes per triangle) inside polygons to:
+   *       std::vector<size_t> *Result;
+   * RETURNS:
+   *   (BOOL) FALSE if some segments crossed each other and were not inserted, TRUE otherwise.
+   */
+  BOOL Triangulate( const std::vector<polygon> &Polygons, std::vector<size_t> *Result );
+
+  /* Update triangulation after point moving function.
+   * Points which are not triangulated are ignored.
+   * ARGUMENTS:
+   *   - moved point index in points pool:
+   *       size_t Index;
+   * RETURNS:
+   *   (BOOL) whether triangulation updated, if FALSE it should be built again.
+   */
+  BOOL MovePoint( size_t Index );
+
+  /* Get triangles inside polygons function.
+   * ARGUMENTS:
+   *   - index buffer to add triangles (three points pool indexes per triangle) to:
+   *       std::vector<size_t> *Result;
+   * RETURNS: None.
+   */
+  VOID GetTriangles( std::vector<size_t> *Result ) const;
+}; /* end of 'delaunay' class */
+
+#endif /* __location_delaunay_h_ */
\ No newline at end of file
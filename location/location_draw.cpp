@@ -0,0 +1,26 @@
+#include "location.h"
+#include "location_render.h"
+
+/* Draw wall sections function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location::Draw( VOID ) const
+{
+  if (Renderer == nullptr)
+    Renderer = std::make_shared<location_render>();
+  Renderer->Draw(*this, CurrPoly, (FLT)PlaceingRadius);
+} /* End pf 'location::Draw' function */
+
+/* Set points labels density function.
+ * ARGUMENTS:
+ *   - minimal distance between labels in pixels (0 to show all labels):
+ *       FLT Pixels;
+ * RETURNS: None.
+ */
+VOID location::SetLabelsSpacing( FLT Pixels )
+{
+  if (Renderer == nullptr)
+    Renderer = std::make_shared<location_render>();
+  Renderer->SetLabelsSpacing(Pixels);
+} /* End of 'location::SetLabelsSpacing' function */
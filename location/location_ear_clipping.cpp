@@ -0,0 +1,377 @@
+#include <algorithm>
+
+#include "location_ear_clipping.h"
+
+/* Ear clipping triangulation constructor.
+ * ARGUMENTS:
+ *   - points pool to take polygon points from:
+ *       const points_pool &Pool;
+ */
+ear_clipping::ear_clipping( const points_pool &Pool ) :
+  Pool(Pool), OrientBound(0)
+{
+} /* End of 'ear_clipping::ear_clipping' function */
+
+/* Build kd-tree node of reflex vertices function.
+ * ARGUMENTS:
+ *   - node index:
+ *       INT Node;
+ *   - node vertices range in tree vertices array:
+ *       INT Start, INT End;
+ * RETURNS: None.
+ */
+VOID ear_clipping::BuildNode( INT Node, INT Start, INT End )
+{
+  if ((INT)Nodes.size() <= Node)
+    Nodes.resize(Node + 1);
+
+  node nd {X[TreeVertices[Start]], Y[TreeVertices[Start]], X[TreeVertices[Start]], Y[TreeVertices[Start]], Start, End, End - Start};
+  for (INT i = Start + 1; i < End; i++)
+  {
+    INT v = TreeVertices[i];
+
+    nd.MinX = mth::Min(nd.MinX, X[v]), nd.MaxX = mth::Max(nd.MaxX, X[v]);
+    nd.MinY = mth::Min(nd.MinY, Y[v]), nd.MaxY = mth::Max(nd.MaxY, Y[v]);
+  }
+  Nodes[Node] = nd;
+
+  if (End - Start <= LeafSize)
+  {
+    for (INT i = Start; i < End; i++)
+      VertexLeaf[TreeVertices[i]] = Node;
+    return;
+  }
+
+  // Split by wider side, so vertices on one line (as rooms doors) are split along it
+  const std::vector<DBL> &coords = nd.MaxX - nd.MinX >= nd.MaxY - nd.MinY ? X : Y;
+  INT mid = (Start + End) / 2;
+
+  std::nth_element(TreeVertices.begin() + Start, TreeVertices.begin() + mid, TreeVertices.begin() + End, [&]( INT A, INT B )
+                   {
+                     return coords[A] < coords[B];
+                   });
+  BuildNode(Node * 2 + 1, Start, mid);
+  BuildNode(Node * 2 + 2, mid, End);
+} /* End of 'ear_clipping::BuildNode' function */
+
+/* Build kd-tree of reflex vertices function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID ear_clipping::BuildTree( VOID )
+{
+  INT n = (INT)X.size();
+
+  TreeVertices.clear();
+  VertexLeaf.assign(n, -1);
+  for (INT i = 0; i < n; i++)
+    if (IsReflex[i])
+      TreeVertices.push_back(i);
+
+  Nodes.clear();
+  if (TreeVertices.empty())
+    Nodes.push_back({0, 0, 0, 0, 0, 0, 0});
+  else
+    BuildNode(0, 0, (INT)TreeVertices.size());
+} /* End of 'ear_clipping::BuildTree' function */
+
+/* Check if point lies inside or on border of triangle with exact orientations function.
+ * ARGUMENTS:
+ *   - triangle vertices:
+ *       INT A, INT B, INT C;
+ *   - point vertex:
+ *       INT P;
+ * RETURNS:
+ *   (BOOL) whether point lies inside triangle.
+ */
+BOOL ear_clipping::IsInTriangle( INT A, INT B, INT C, INT P ) const
+{
+  return GetArea(A, B, P) >= 0 && GetArea(B, C, P) >= 0 && GetArea(C, A, P) >= 0;
+} /* End of 'ear_clipping::IsInTriangle' function */
+
+/* Check if vertex is polygon ear function.
+ * ARGUMENTS:
+ *   - vertex:
+ *       INT V;
+ * RETURNS:
+ *   (BOOL) whether vertex is ear.
+ */
+BOOL ear_clipping::IsEar( INT V ) const
+{
+  INT a = Prev[V], b = V, c = Next[V];
+
+  if (IsReflex[b] || GetArea(a, b, c) <= 0)
+    return FALSE;
+
+  // Only reflex vertices can lie inside ear of simple polygon
+  const DBL *x = X.data(), *y = Y.data(), bound = OrientBound;
+  const BYTE *is_reflex = IsReflex.data(), *is_removed = IsRemoved.data();
+  const INT *vertices = TreeVertices.data();
+  DBL
+    xa = x[a], ya = y[a], xb = x[b], yb = y[b], xc = x[c], yc = y[c],
+    min_x = mth::Min(xa, mth::Min(xb, xc)), max_x = mth::Max(xa, mth::Max(xb, xc)),
+    min_y = mth::Min(ya, mth::Min(yb, yc)), max_y = mth::Max(ya, mth::Max(yb, yc));
+
+  // Tree is balanced, so stack of depth size is enough
+  INT stack[64], stack_size = 0;
+
+  stack[stack_size++] = 0;
+  while (stack_size > 0)
+  {
+    INT node_index = stack[--stack_size];
+    const node &nd = Nodes[node_index];
+
+    if (nd.LiveCount == 0 || nd.MinX > max_x || nd.MaxX < min_x || nd.MinY > max_y || nd.MaxY < min_y)
+      continue;
+    // Fan ears have big bounding boxes, so nodes outside of any triangle side are skipped too
+    if (IsBoxOutside(nd, xa, ya, xb, yb) || IsBoxOutside(nd, xb, yb, xc, yc) || IsBoxOutside(nd, xc, yc, xa, ya))
+      continue;
+    if (nd.End - nd.Start > LeafSize)
+    {
+      stack[stack_size++] = node_index * 2 + 1;
+      stack[stack_size++] = node_index * 2 + 2;
+      continue;
+    }
+
+    for (INT i = nd.Start; i < nd.End; i++)
+    {
+      INT p = vertices[i];
+
+      if (!is_reflex[p] || is_removed[p] || p == a || p == c)
+        continue;
+      DBL xp = x[p], yp = y[p];
+      // Skip vertices coinciding with triangle corners
+      if ((xp == xa && yp == ya) || (xp == xb && yp == yb) || (xp == xc && yp == yc))
+        continue;
+      // Orientations are filtered by ring bound here, exact check is out of line
+      DBL
+        d0 = (xa - xp) * (yb - yp) - (ya - yp) * (xb - xp),
+        d1 = (xb - xp) * (yc - yp) - (yb - yp) * (xc - xp),
+        d2 = (xc - xp) * (ya - yp) - (yc - yp) * (xa - xp);
+      if (d0 < -bound || d1 < -bound || d2 < -bound)
+        continue;
+      if ((d0 > bound && d1 > bound && d2 > bound) || IsInTriangle(a, b, c, p))
+        return FALSE;
+    }
+  }
+  return TRUE;
+} /* End of 'ear_clipping::IsEar' function */
+
+/* Update vertex reflex flag after its neighbour was clipped function.
+ * ARGUMENTS:
+ *   - vertex:
+ *       INT V;
+ * RETURNS: None.
+ */
+VOID ear_clipping::UpdateVertex( INT V )
+{
+  // Reflex vertex can only become convex, so tree only loses live vertices
+  if (IsReflex[V] && GetArea(Prev[V], V, Next[V]) > 0)
+  {
+    IsReflex[V] = FALSE;
+    for (INT node = VertexLeaf[V]; node >= 0; node = node == 0 ? -1 : (node - 1) / 2)
+      Nodes[node].LiveCount--;
+  }
+} /* End of 'ear_clipping::UpdateVertex' function */
+
+/* Remove vertex from ring function.
+ * ARGUMENTS:
+ *   - vertex:
+ *       INT V;
+ * RETURNS: None.
+ */
+VOID ear_clipping::RemoveVertex( INT V )
+{
+  // Only forced clip removes reflex vertex
+  if (IsReflex[V])
+  {
+    IsReflex[V] = FALSE;
+    for (INT node = VertexLeaf[V]; node >= 0; node = node == 0 ? -1 : (node - 1) / 2)
+      Nodes[node].LiveCount--;
+  }
+  Next[Prev[V]] = Next[V];
+  Prev[Next[V]] = Prev[V];
+  IsRemoved[V] = TRUE;
+} /* End of 'ear_clipping::RemoveVertex' function */
+
+/* Clip ear and queue its neighbours function.
+ * ARGUMENTS:
+ *   - ear vertex:
+ *       INT V;
+ *   - index buffer to add triangle to:
+ *       std::vector<size_t> *Triangles;
+ * RETURNS: None.
+ */
+VOID ear_clipping::Clip( INT V, std::vector<size_t> *Triangles )
+{
+  INT a = Prev[V], c = Next[V];
+
+  Triangles->push_back(Indices[a]);
+  Triangles->push_back(Indices[V]);
+  Triangles->push_back(Indices[c]);
+
+  // Only neighbours of clipped ear change their triangles
+  RemoveVertex(V);
+  UpdateVertex(a);
+  UpdateVertex(c);
+  Enqueue(a);
+  Enqueue(c);
+} /* End of 'ear_clipping::Clip' function */
+
+/* Triangulate one closed ring function.
+ * ARGUMENTS:
+ *   - indexes of ring vertices in points pool:
+ *       const std::vector<size_t> &Ring;
+ *   - index buffer to add triangles to:
+ *       std::vector<size_t> *Triangles;
+ * RETURNS:
+ *   (BOOL) whether ring triangulated without forced clips.
+ */
+BOOL ear_clipping::TriangulateRing( const std::vector<size_t> &Ring, std::vector<size_t> *Triangles )
+{
+  INT n = (INT)Ring.size();
+
+  // Fill working buffers
+  Indices.assign(Ring.begin(), Ring.end());
+  const FLT *pool_x = Pool.GetX(), *pool_y = Pool.GetY();
+  X.resize(n), Y.resize(n);
+  for (INT i = 0; i < n; i++)
+    X[i] = pool_x[Ring[i]], Y[i] = pool_y[Ring[i]];
+  auto x_range = std::minmax_element(X.begin(), X.end()), y_range = std::minmax_element(Y.begin(), Y.end());
+  OrientBound = predicates::GetOrientBound(mth::Max(*x_range.second - *x_range.first, *y_range.second - *y_range.first));
+
+  // Make ring counterclockwise
+  DBL area = 0;
+  for (INT i = 0, j = n - 1; i < n; j = i++)
+    area += (X[j] - X[i]) * (Y[j] + Y[i]);
+  if (area < 0)
+  {
+    std::reverse(Indices.begin(), Indices.end());
+    std::reverse(X.begin(), X.end());
+    std::reverse(Y.begin(), Y.end());
+  }
+
+  Prev.resize(n), Next.resize(n);
+  for (INT i = 0; i < n; i++)
+    Prev[i] = i == 0 ? n - 1 : i - 1, Next[i] = i == n - 1 ? 0 : i + 1;
+  IsRemoved.assign(n, FALSE);
+  IsReflex.assign(n, FALSE);
+
+  // Drop collinear vertices, they never form ears
+  INT count = n, start = 0;
+  for (INT v = 0; v < n && count > 3; v++)
+    if (GetArea(Prev[v], v, Next[v]) == 0)
+    {
+      if (v == start)
+        start = Next[v];
+      RemoveVertex(v), count--;
+    }
+
+  for (INT i = 0; i < n; i++)
+    IsReflex[i] = !IsRemoved[i] && GetArea(Prev[i], i, Next[i]) <= 0;
+  BuildTree();
+
+  // All vertices are ear candidates at first
+  IsQueued.assign(n, FALSE);
+  Queue.clear();
+  for (INT i = 0, v = start; i < count; i++, v = Next[v])
+    Enqueue(v);
+
+  // Clip ears from queue, empty queue after clips is refilled by whole ring
+  // (ears can be freed by reflex vertices which became convex)
+  BOOL is_forced = FALSE, is_clipped = FALSE;
+  INT ear = start;
+  size_t head = 0;
+  while (count > 3)
+  {
+    if (head == Queue.size())
+    {
+      Queue.clear(), head = 0;
+      if (is_clipped)
+      {
+        is_clipped = FALSE;
+        for (INT i = 0, v = ear; i < count; i++, v = Next[v])
+          Enqueue(v);
+        continue;
+      }
+
+      // No ears found in whole ring: polygon is not simple, clip first convex vertex (or any)
+      INT forced = ear;
+      for (INT v = Next[ear]; v != ear; v = Next[v])
+        if (GetArea(Prev[v], v, Next[v]) > 0)
+        {
+          forced = v;
+          break;
+        }
+      ear = Next[forced];
+      Clip(forced, Triangles), count--;
+      is_forced = is_clipped = TRUE;
+      continue;
+    }
+
+    INT v = Queue[head++];
+
+    IsQueued[v] = FALSE;
+    if (IsRemoved[v] || !IsEar(v))
+      continue;
+    ear = Next[v];
+    Clip(v, Triangles), count--;
+    is_clipped = TRUE;
+  }
+
+  // Last triangle
+  INT a = Prev[ear], c = Next[ear];
+  if (GetArea(a, ear, c) != 0)
+  {
+    Triangles->push_back(Indices[a]);
+    Triangles->push_back(Indices[ear]);
+    Triangles->push_back(Indices[c]);
+  }
+  return !is_forced;
+} /* End of 'ear_clipping::TriangulateRing' function */
+
+/* Triangulate polygon function.
+ * Each closed chain of polygon lines is triangulated separately.
+ * ARGUMENTS:
+ *   - polygon to triangulate:
+ *       const polygon &Polly;
+ *   - index buffer to add triangles (three points pool indexes per triangle) to:
+ *       std::vector<size_t> *Triangles;
+ * RETURNS:
+ *   (BOOL) FALSE if polygon is not simple and some triangles were forced, TRUE otherwise.
+ */
+BOOL ear_clipping::Triangulate( const polygon &Polly, std::vector<size_t> *Triangles )
+{
+  BOOL is_simple = TRUE;
+  std::vector<size_t> ring;
+
+  const auto FlushRing = [&]( VOID )
+  {
+    // Drop repeated points
+    ring.erase(std::unique(ring.begin(), ring.end(), [&]( size_t A, size_t B )
+                           {
+                             return A == B || (Pool[A][0] == Pool[B][0] && Pool[A][1] == Pool[B][1]);
+                           }), ring.end());
+    while (ring.size() > 1 && (ring.front() == ring.back() ||
+           (Pool[ring.front()][0] == Pool[ring.back()][0] && Pool[ring.front()][1] == Pool[ring.back()][1])))
+      ring.pop_back();
+
+    if (ring.size() >= 3)
+      is_simple &= TriangulateRing(ring, Triangles);
+    ring.clear();
+  };
+
+  // Split polygon lines to closed chains
+  for (size_t i = 0, cnt = Polly.Lines.size(); i < cnt; i++)
+  {
+    if (!ring.empty() && Polly.Lines[i - 1].End != Polly.Lines[i].St)
+      FlushRing();
+
+    ring.push_back(Polly.Lines[i].St);
+    if (Polly.Lines[i].End == ring.front())
+      FlushRing();
+  }
+  FlushRing();
+
+  return is_simple;
+} /* End of 'ear_clipping::Triangulate' function */
\ No newline at end of file
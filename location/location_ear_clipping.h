@@ -0,0 +1,180 @@
+#ifndef __location_ear_clipping_h_
+#define __location_ear_clipping_h_
+
+#include "location.h"
+#include "location_predicates.h"
+
+/* Polygon ear clipping triangulation class.
+ * Polygon vertices are kept in doubly linked list with convex/reflex flags,
+ * reflex vertices are kept in static kd-tree with live vertices counts, so ear test
+ * checks only reflex vertices near the ear instead of all polygon points.
+ * Ear candidates are kept in queue: after clip only clipped ear neighbours are tested again.
+ * Working buffers are reused between polygons.
+ */
+class ear_clipping
+{
+private:
+  /* Reflex vertices kd-tree node structure. */
+  struct node
+  {
+    DBL MinX, MinY, MaxX, MaxY; // Node vertices bounding box
+    INT Start, End;             // Node vertices range in tree vertices array
+    INT LiveCount;              // Number of vertices which are still reflex
+  }; /* end of 'node' struct */
+
+  static const INT LeafSize = 8; // Maximal number of vertices in kd-tree leaf
+
+  const points_pool &Pool; // Points pool to take polygon points from
+
+  std::vector<size_t> Indices;   // Ring vertices indexes in points pool
+  std::vector<DBL> X, Y;         // Ring vertices coordinates
+  std::vector<INT> Prev, Next;   // Ring vertices linked list
+  std::vector<BYTE> IsReflex;    // Vertex reflex flags
+  std::vector<BYTE> IsRemoved;   // Vertex removed (clipped) flags
+  std::vector<INT> Queue;        // Ear candidates queue
+  std::vector<BYTE> IsQueued;    // Vertex is in candidates queue flags
+
+  // Reflex vertices kd-tree (node children are 2 * i + 1 and 2 * i + 2)
+  std::vector<node> Nodes;
+  std::vector<INT> TreeVertices; // Reflex vertices ordered by tree leaves
+  std::vector<INT> VertexLeaf;   // Vertex leaf node (-1 for convex vertices)
+  DBL OrientBound;               // Orientation error bound of ring box
+
+  /* Get doubled signed area of triangle function.
+   * ARGUMENTS:
+   *   - triangle vertices:
+   *       INT A, INT B, INT C;
+   * RETURNS:
+   *   (DBL) doubled signed area, positive for counterclockwise triangle.
+   */
+  DBL GetArea( INT A, INT B, INT C ) const
+  {
+    return predicates::Orient2d(X[A], Y[A], X[B], Y[B], X[C], Y[C], OrientBound);
+  } /* End of 'GetArea' function */
+
+  /* Check if kd-tree node box lies strictly to the right of line function.
+   * ARGUMENTS:
+   *   - node:
+   *       const node &Node;
+   *   - line points:
+   *       DBL X0, DBL Y0, DBL X1, DBL Y1;
+   * RETURNS:
+   *   (BOOL) whether all box points lie to the right of line.
+   */
+  BOOL IsBoxOutside( const node &Node, DBL X0, DBL Y0, DBL X1, DBL Y1 ) const
+  {
+    // Box corner with maximal orientation
+    DBL
+      dx = X1 - X0, dy = Y1 - Y0,
+      x = dy >= 0 ? Node.MinX : Node.MaxX, y = dx >= 0 ? Node.MaxY : Node.MinY;
+
+    return dx * (y - Y0) - dy * (x - X0) < -OrientBound;
+  } /* End of 'IsBoxOutside' function */
+
+  /* Build kd-tree node of reflex vertices function.
+   * ARGUMENTS:
+   *   - node index:
+   *       INT Node;
+   *   - node vertices range in tree vertices array:
+   *       INT Start, INT End;
+   * RETURNS: None.
+   */
+  VOID BuildNode( INT Node, INT Start, INT End );
+
+  /* Build kd-tree of reflex vertices function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID BuildTree( VOID );
+
+  /* Check if point lies inside or on border of triangle with exact orientations function.
+   * ARGUMENTS:
+   *   - triangle vertices:
+   *       INT A, INT B, INT C;
+   *   - point vertex:
+   *       INT P;
+   * RETURNS:
+   *   (BOOL) whether point lies inside triangle.
+   */
+  BOOL IsInTriangle( INT A, INT B, INT C, INT P ) const;
+
+  /* Check if vertex is polygon ear function.
+   * ARGUMENTS:
+   *   - vertex:
+   *       INT V;
+   * RETURNS:
+   *   (BOOL) whether vertex is ear.
+   */
+  BOOL IsEar( INT V ) const;
+
+  /* Update vertex reflex flag after its neighbour was clipped function.
+   * ARGUMENTS:
+   *   - vertex:
+   *       INT V;
+   * RETURNS: None.
+   */
+  VOID UpdateVertex( INT V );
+
+  /* Remove vertex from ring function.
+   * ARGUMENTS:
+   *   - vertex:
+   *       INT V;
+   * RETURNS: None.
+   */
+  VOID RemoveVertex( INT V );
+
+  /* Add vertex to ear candidates queue function.
+   * ARGUMENTS:
+   *   - vertex:
+   *       INT V;
+   * RETURNS: None.
+   */
+  VOID Enqueue( INT V )
+  {
+    if (!IsQueued[V])
+      IsQueued[V] = TRUE, Queue.push_back(V);
+  } /* End of 'Enqueue' function */
+
+  /* Clip ear and queue its neighbours function.
+   * ARGUMENTS:
+   *   - ear vertex:
+   *       INT V;
+   *   - index buffer to add triangle to:
+   *       std::vector<size_t> *Triangles;
+   * RETURNS: None.
+   */
+  VOID Clip( INT V, std::vector<size_t> *Triangles );
+
+  /* Triangulate one closed ring function.
+   * ARGUMENTS:
+   *   - indexes of ring vertices in points pool:
+   *       const std::vector<size_t> &Ring;
+   *   - index buffer to add triangles to:
+   *       std::vector<size_t> *Triangles;
+   * RETURNS:
+   *   (BOOL) whether ring triangulated without forced clips.
+   */
+  BOOL TriangulateRing( const std::vector<size_t> &Ring, std::vector<size_t> *Triangles );
+
+public:
+  /* Ear clipping triangulation constructor.
+   * ARGUMENTS:
+   *   - points pool to take polygon points from:
+   *       const points_pool &Pool;
+   */
+  ear_clipping( const points_pool &Pool );
+
+  /* Triangulate polygon function.
+   * Each closed chain of polygon lines is triangulated separately.
+   * ARGUMENTS:
+   *   - polygon to triangulate:
+   *       const polygon &Polly;
+   *   - index buffer to add triangles (three points pool indexes per triangle) to:
+   *       std::vector<size_t> *Triangles;
+   * RETURNS:
+   *   (BOOL) FALSE if polygon is not simple and some triangles were forced, TRUE otherwise.
+   */
+  BOOL Triangulate( const polygon &Polly, std::vector<size_t> *Triangles );
+}; /* end of 'ear_clipping' class */
+
+#endif /* __location_ear_clipping_h_ */
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* _WIN32 */
+
+#include "location_file.h"
+
+// Segments are stored in file as they are in polygon lines
+static_assert(sizeof(segment) == 2 * sizeof(UINT32) && std::is_trivially_copyable<segment>::value,
+              "segment should be pair of 32-bit indexes");
+
+const char location_file::Magic[8] = {'T', 'R', 'I', 'L', 'O', 'C', '\r', '\n'}; // Format magic (line ends catch text mode damage)
+const UINT32 location_file::Version = 1;                                        // Current format version
+const UINT32 location_file::ByteOrder = 0x01020304;                             // Byte order mark
+const UINT64 location_file::Alignment = 64;                                     // Sections alignment (cache line)
+
+/* Location file destructor. */
+location_file::~location_file( VOID )
+{
+  Close();
+} /* End of 'location_file::~location_file' function */
+
+/* Open and map file function.
+ * ARGUMENTS:
+ *   - file name:
+ *       const std::string &FileName;
+ * RETURNS:
+ *   (BOOL) FALSE if file can not be opened or it is not valid location file, TRUE otherwise.
+ */
+BOOL location_file::Open( const std::string &FileName )
+{
+  Close();
+
+#ifdef _WIN32
+  File = CreateFileA(FileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                     FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (File == INVALID_HANDLE_VALUE)
+    return FALSE;
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(File, &file_size) || (UINT64)file_size.QuadPart < sizeof(header) ||
+      (Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr)) == nullptr)
+  {
+    Close();
+    return FALSE;
+  }
+  Size = (UINT64)file_size.QuadPart;
+  Data = (const BYTE *)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+  INT fd = open(FileName.c_str(), O_RDONLY);
+  if (fd == -1)
+    return FALSE;
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == 0 && (UINT64)file_stat.st_size >= sizeof(header))
+  {
+    VOID *data = mmap(nullptr, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (data != MAP_FAILED)
+      Data = (const BYTE *)data, Size = (UINT64)file_stat.st_size;
+  }
+  // Mapping stays valid after file closing
+  close(fd);
+#endif /* _WIN32 */
+
+  if (Data == nullptr || !Check())
+  {
+    Close();
+    return FALSE;
+  }
+  return TRUE;
+} /* End of 'location_file::Open' function */
+
+/* Unmap and close file function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location_file::Close( VOID )
+{
+#ifdef _WIN32
+  if (Data != nullptr)
+    UnmapViewOfFile(Data);
+  if (Mapping != nullptr)
+    CloseHandle(Mapping);
+  if (File != INVALID_HANDLE_VALUE)
+    CloseHandle(File);
+  Mapping = nullptr, File = INVALID_HANDLE_VALUE;
+#else
+  if (Data != nullptr)
+    munmap((VOID *)Data, (size_t)Size);
+#endif /* _WIN32 */
+  Data = nullptr, Size = 0;
+} /* End of 'location_file::Close' function */
+
+/* Check mapped file header and data function.
+ * ARGUMENTS: None.
+ * RETURNS:
+ *   (BOOL) whether file is valid.
+ */
+BOOL location_file::Check( VOID ) const
+{
+  const header &head = GetHeader();
+
+  if (memcmp(head.Magic, Magic, sizeof(Magic)) != 0 || head.Version != Version ||
+      head.ByteOrder != ByteOrder || head.FileSize != Size)
+    return FALSE;
+
+  // Sections should be aligned and lie in file, counts are checked first, so sizes do not overflow
+  const auto IsSection = [&]( UINT64 Offset, UINT64 Count, UINT64 ItemSize ) -> BOOL
+  {
+    return Offset % Alignment == 0 && Offset >= sizeof(header) && Offset <= Size && Count <= (Size - Offset) / ItemSize;
+  };
+  if (head.PointsCount > 0xFFFFFFFFull ||
+      !IsSection(head.XOffset, head.PointsCount, sizeof(FLT)) ||
+      !IsSection(head.YOffset, head.PointsCount, sizeof(FLT)) ||
+      !IsSection(head.SegmentsOffset, head.SegmentsCount, sizeof(segment)) ||
+      head.PolygonsCount >= Size / sizeof(UINT64) ||
+      !IsSection(head.PolygonsOffset, head.PolygonsCount + 1, sizeof(UINT64)))
+    return FALSE;
+
+  // Polygons are contiguous ranges of segments
+  const UINT64 *offsets = reinterpret_cast<const UINT64 *>(Data + head.PolygonsOffset);
+  if (offsets[0] != 0 || offsets[head.PolygonsCount] != head.SegmentsCount)
+    return FALSE;
+  for (UINT64 i = 0; i < head.PolygonsCount; i++)
+    if (offsets[i] > offsets[i + 1])
+      return FALSE;
+
+  // All segments reference existing points (without branches, so check runs at memory speed)
+  const UINT32 *indexes = reinterpret_cast<const UINT32 *>(Data + head.SegmentsOffset);
+  UINT32 max_index = 0;
+  for (UINT64 i = 0; i < head.SegmentsCount * 2; i++)
+    max_index = mth::Max(max_index, indexes[i]);
+  return head.SegmentsCount == 0 || max_index < head.PointsCount;
+} /* End of 'location_file::Check' function */
+
+/* Write location file function.
+ * ARGUMENTS:
+ *   - file name:
+ *       const std::string &FileName;
+ *   - points pool to write:
+ *       const points_pool &Pool;
+ *   - polygons to write:
+ *       const std::vector<polygon> &Polygons;
+ * RETURNS:
+ *   (BOOL) whether file written.
+ */
+BOOL location_file::Save( const std::string &FileName, const points_pool &Pool, const std::vector<polygon> &Polygons )
+{
+  header head {};
+  std::vector<UINT64> offsets(1, 0);
+
+  for (const polygon &polly : Polygons)
+    offsets.push_back(offsets.back() + polly.Lines.size());
+
+  memcpy(head.Magic, Magic, sizeof(Magic));
+  head.Version = Version;
+  head.ByteOrder = ByteOrder;
+  head.PointsCount = Pool.Size();
+  head.SegmentsCount = offsets.back();
+  head.PolygonsCount = Polygons.size();
+  head.XOffset = Align(sizeof(header));
+  head.YOffset = Align(head.XOffset + head.PointsCount * sizeof(FLT));
+  head.SegmentsOffset = Align(head.YOffset + head.PointsCount * sizeof(FLT));
+  head.PolygonsOffset = Align(head.SegmentsOffset + head.SegmentsCount * sizeof(segment));
+  head.FileSize = head.PolygonsOffset + offsets.size() * sizeof(UINT64);
+
+  std::ofstream file(FileName, std::ios::binary | std::ios::trunc);
+  if (!file)
+    return FALSE;
+
+  // Sections are written in order, gaps are filled by zeros
+  const auto Write = [&]( UINT64 Offset, const VOID *Src, UINT64 Bytes )
+  {
+    static const char zeros[64] = {};
+
+    file.write(zeros, (std::streamsize)(Offset - (UINT64)file.tellp()));
+    file.write((const char *)Src, (std::streamsize)Bytes);
+  };
+  Write(0, &head, sizeof(header));
+  Write(head.XOffset, Pool.GetX(), head.PointsCount * sizeof(FLT));
+  Write(head.YOffset, Pool.GetY(), head.PointsCount * sizeof(FLT));
+  Write(head.SegmentsOffset, nullptr, 0);
+  for (const polygon &polly : Polygons)
+    file.write((const char *)polly.Lines.data(), (std::streamsize)(polly.Lines.size() * sizeof(segment)));
+  Write(head.PolygonsOffset, offsets.data(), offsets.size() * sizeof(UINT64));
+
+  return (BOOL)file.good();
+} /* End of 'location_file::Save' function */
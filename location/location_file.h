@@ -0,0 +1,171 @@
+#ifndef __location_file_h_
+#define __location_file_h_
+
+#include "location.h"
+
+/* Location binary file class.
+ * File is laid out as it is used in memory, so it is mapped and its sections are read without parsing
+ * (location copies them to its own arrays in bulk, see 'location::Load'):
+ *   - header (format magic, version, byte order mark, sections counts and offsets);
+ *   - points X coordinates (FLT), then Y coordinates (FLT), as in points pool;
+ *   - polygons segments (pairs of UINT32 points indexes), as in polygon lines;
+ *   - polygons offsets (UINT64), first segment of every polygon and total segments count.
+ * Sections are aligned to 64 bytes. File is checked once at opening, indexes included,
+ * so its data could be used without range checks.
+ */
+class location_file
+{
+private:
+  /* File header structure. */
+  struct header
+  {
+    char Magic[8];                          // Format magic
+    UINT32 Version;                         // Format version
+    UINT32 ByteOrder;                       // Byte order mark, written by host
+    UINT64 FileSize;                        // Whole file size
+    UINT64 PointsCount;                     // Points count
+    UINT64 SegmentsCount;                   // Segments count of all polygons
+    UINT64 PolygonsCount;                   // Polygons count
+    UINT64 XOffset, YOffset;                // Points coordinates sections offsets
+    UINT64 SegmentsOffset, PolygonsOffset;  // Segments and polygons offsets sections offsets
+  }; /* end of 'header' struct */
+
+  static const char Magic[8];        // Format magic
+  static const UINT32 Version;       // Current format version
+  static const UINT32 ByteOrder;     // Byte order mark
+  static const UINT64 Alignment;     // Sections alignment
+
+  const BYTE *Data = nullptr; // Mapped file data
+  UINT64 Size = 0;            // Mapped file size
+#ifdef _WIN32
+  HANDLE File = INVALID_HANDLE_VALUE, Mapping = nullptr; // File and its mapping handles
+#endif /* _WIN32 */
+
+  /* Get header of mapped file function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (const header &) file header.
+   */
+  const header &GetHeader( VOID ) const
+  {
+    return *reinterpret_cast<const header *>(Data);
+  } /* End of 'GetHeader' function */
+
+  /* Align section offset function.
+   * ARGUMENTS:
+   *   - offset:
+   *       UINT64 Offset;
+   * RETURNS:
+   *   (UINT64) aligned offset.
+   */
+  static UINT64 Align( UINT64 Offset )
+  {
+    return (Offset + Alignment - 1) / Alignment * Alignment;
+  } /* End of 'Align' function */
+
+  /* Check mapped file header and data function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (BOOL) whether file is valid.
+   */
+  BOOL Check( VOID ) const;
+
+public:
+  /* Location file default constructor. */
+  location_file( VOID ) = default;
+
+  /* Location file copying is not allowed (file mapping is owned). */
+  location_file( const location_file & ) = delete;
+  location_file &operator=( const location_file & ) = delete;
+
+  /* Location file destructor. */
+  ~location_file( VOID );
+
+  /* Open and map file function.
+   * ARGUMENTS:
+   *   - file name:
+   *       const std::string &FileName;
+   * RETURNS:
+   *   (BOOL) FALSE if file can not be opened or it is not valid location file, TRUE otherwise.
+   */
+  BOOL Open( const std::string &FileName );
+
+  /* Unmap and close file function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID Close( VOID );
+
+  /* Write location file function.
+   * ARGUMENTS:
+   *   - file name:
+   *       const std::string &FileName;
+   *   - points pool to write:
+   *       const points_pool &Pool;
+   *   - polygons to write:
+   *       const std::vector<polygon> &Polygons;
+   * RETURNS:
+   *   (BOOL) whether file written.
+   */
+  static BOOL Save( const std::string &FileName, const points_pool &Pool, const std::vector<polygon> &Polygons );
+
+  /* Get points count function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (size_t) points count (0 if file is not opened).
+   */
+  size_t GetPointsCount( VOID ) const
+  {
+    return Data == nullptr ? 0 : (size_t)GetHeader().PointsCount;
+  } /* End of 'GetPointsCount' function */
+
+  /* Get points X coordinates array function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (const FLT *) GetPointsCount() X coordinates.
+   */
+  const FLT *GetX( VOID ) const
+  {
+    return reinterpret_cast<const FLT *>(Data + GetHeader().XOffset);
+  } /* End of 'GetX' function */
+
+  /* Get points Y coordinates array function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (const FLT *) GetPointsCount() Y coordinates.
+   */
+  const FLT *GetY( VOID ) const
+  {
+    return reinterpret_cast<const FLT *>(Data + GetHeader().YOffset);
+  } /* End of 'GetY' function */
+
+  /* Get polygons count function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (size_t) polygons count (0 if file is not opened).
+   */
+  size_t GetPolygonsCount( VOID ) const
+  {
+    return Data == nullptr ? 0 : (size_t)GetHeader().PolygonsCount;
+  } /* End of 'GetPolygonsCount' function */
+
+  /* Get polygon lines function.
+   * ARGUMENTS:
+   *   - polygon index, should be less than polygons count:
+   *       size_t Index;
+   *   - variable to set lines count in:
+   *       size_t *Count;
+   * RETURNS:
+   *   (const segment *) polygon lines.
+   */
+  const segment *GetPolygon( size_t Index, size_t *Count ) const
+  {
+    const header &head = GetHeader();
+    const UINT64 *offsets = reinterpret_cast<const UINT64 *>(Data + head.PolygonsOffset);
+
+    *Count = (size_t)(offsets[Index + 1] - offsets[Index]);
+    return reinterpret_cast<const segment *>(Data + head.SegmentsOffset) + offsets[Index];
+  } /* End of 'GetPolygon' function */
+}; /* end of 'location_file' class */
+
+#endif /* __location_file_h_ */
@@ -0,0 +1,568 @@
+#include <algorithm>
+#include <cstring>
+
+#include "location_import.h"
+
+/* Import constructor.
+ * ARGUMENTS:
+ *   - points pool to add points to:
+ *       points_pool &Pool;
+ *   - points snapping radius (0 - only equal points are merged):
+ *       DBL CheckRadius;
+ *   - reading buffer size in bytes:
+ *       size_t BufferSize;
+ */
+location_import::location_import( points_pool &Pool, DBL CheckRadius, size_t BufferSize ) :
+  Pool(Pool), CheckRadius(CheckRadius), Buffer(mth::Max(BufferSize, (size_t)1))
+{
+} /* End of 'location_import::location_import' function */
+
+/* Read next chunk of file to buffer function.
+ * ARGUMENTS: None.
+ * RETURNS:
+ *   (BOOL) FALSE at file end, TRUE otherwise.
+ */
+BOOL location_import::Fill( VOID )
+{
+  File.read(Buffer.data(), (std::streamsize)Buffer.size());
+  Pos = 0, End = (size_t)File.gcount();
+  return End > 0;
+} /* End of 'location_import::Fill' function */
+
+/* Skip whitespaces function.
+ * ARGUMENTS: None.
+ * RETURNS:
+ *   (INT) next not whitespace character or -1 at file end.
+ */
+INT location_import::SkipSpaces( VOID )
+{
+  INT ch = Peek();
+
+  while (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n')
+    Skip(), ch = Peek();
+  return ch;
+} /* End of 'location_import::SkipSpaces' function */
+
+/* Read number function.
+ * Numbers are parsed by digits, result is correctly rounded if it has
+ * less than 16 significant digits and small exponent (as usual coordinates have).
+ * ARGUMENTS:
+ *   - variable to set number in:
+ *       DBL *Result;
+ * RETURNS:
+ *   (BOOL) FALSE if there is no number at current character, TRUE otherwise.
+ */
+BOOL location_import::ReadNumber( DBL *Result )
+{
+  static const DBL powers[] =
+  {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  UINT64 mantissa = 0;
+  INT ch = Peek(), digits = 0, exponent = 0;
+  BOOL is_negative = ch == '-', is_number = FALSE;
+
+  if (ch == '-' || ch == '+')
+    Skip();
+
+  // Only 19 significant digits fit mantissa, next ones change exponent only
+  const auto ReadDigits = [&]( BOOL IsFraction )
+  {
+    for (ch = Peek(); ch >= '0' && ch <= '9'; Skip(), ch = Peek())
+    {
+      is_number = TRUE;
+      if (digits < 19)
+      {
+        mantissa = mantissa * 10 + (ch - '0');
+        digits += mantissa != 0;
+        exponent -= IsFraction;
+      }
+      else
+        exponent += !IsFraction;
+    }
+  };
+
+  ReadDigits(FALSE);
+  if (ch == '.')
+  {
+    Skip();
+    ReadDigits(TRUE);
+  }
+  if (!is_number)
+    return FALSE;
+
+  if (ch == 'e' || ch == 'E')
+  {
+    INT exp_value = 0;
+
+    Skip();
+    ch = Peek();
+    BOOL is_exp_negative = ch == '-';
+    if (ch == '-' || ch == '+')
+      Skip();
+    for (ch = Peek(); ch >= '0' && ch <= '9'; Skip(), ch = Peek())
+      exp_value = mth::Min(exp_value * 10 + (ch - '0'), 100000);
+    exponent += is_exp_negative ? -exp_value : exp_value;
+  }
+
+  // Mantissa and power of ten are exact doubles, so one operation rounds result correctly
+  DBL value = (DBL)mantissa;
+  if (mantissa < (1ull << 53) && exponent >= -22 && exponent <= 22)
+    value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+  else if (mantissa != 0)
+    value *= pow(10.0, exponent);
+  *Result = is_negative ? -value : value;
+  return TRUE;
+} /* End of 'location_import::ReadNumber' function */
+
+/* Read word (letters sequence) function.
+ * ARGUMENTS:
+ *   - variable to set word in upper case:
+ *       std::string *Word;
+ * RETURNS: None.
+ */
+VOID location_import::ReadWord( std::string *Word )
+{
+  Word->clear();
+  for (INT ch = Peek(); (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z'); Skip(), ch = Peek())
+    if (Word->size() < 16)
+      Word->push_back((char)(ch >= 'a' ? ch - 'a' + 'A' : ch));
+} /* End of 'location_import::ReadWord' function */
+
+/* Add point to deduplication index function.
+ * ARGUMENTS:
+ *   - point index in pool (after new points flushing):
+ *       size_t Index;
+ *   - point coordinates:
+ *       FLT X, FLT Y;
+ * RETURNS: None.
+ */
+VOID location_import::IndexPoint( size_t Index, FLT X, FLT Y )
+{
+  if (CheckRadius == 0)
+  {
+    UINT32 bits_x, bits_y;
+    FLT x = X + 0.0f, y = Y + 0.0f; // Negative zero is the same point as zero
+
+    memcpy(&bits_x, &x, sizeof(bits_x));
+    memcpy(&bits_y, &y, sizeof(bits_y));
+    Cells.emplace(GetCellKey(bits_x, bits_y), (UINT32)Index);
+    return;
+  }
+
+  auto cell = Cells.emplace(GetCellKey(GetCellCoord(X), GetCellCoord(Y)), 0xFFFFFFFF).first;
+  Prev.push_back(cell->second);
+  cell->second = (UINT32)Index;
+} /* End of 'location_import::IndexPoint' function */
+
+/* Find point or add it to new points function.
+ * ARGUMENTS:
+ *   - point coordinates:
+ *       FLT X, FLT Y;
+ * RETURNS:
+ *   (size_t) point index in pool (after new points flushing).
+ */
+size_t location_import::PlacePoint( FLT X, FLT Y )
+{
+  size_t pool_size = Pool.Size(), new_index = pool_size + NewX.size();
+
+  if (CheckRadius == 0)
+  {
+    UINT32 bits_x, bits_y;
+    FLT x = X + 0.0f, y = Y + 0.0f;
+
+    memcpy(&bits_x, &x, sizeof(bits_x));
+    memcpy(&bits_y, &y, sizeof(bits_y));
+    auto cell = Cells.emplace(GetCellKey(bits_x, bits_y), (UINT32)new_index);
+    if (!cell.second)
+      return cell.first->second;
+  }
+  else
+  {
+    // Nearest point of cells covered by search circle
+    DBL min_dist2 = CheckRadius * CheckRadius;
+    size_t found = -1;
+
+    for (INT64 cy = GetCellCoord((FLT)(Y - CheckRadius)), max_y = GetCellCoord((FLT)(Y + CheckRadius)); cy <= max_y; cy++)
+      for (INT64 cx = GetCellCoord((FLT)(X - CheckRadius)), max_x = GetCellCoord((FLT)(X + CheckRadius)); cx <= max_x; cx++)
+      {
+        auto cell = Cells.find(GetCellKey(cx, cy));
+        if (cell == Cells.end())
+          continue;
+
+        for (UINT32 i = cell->second; i != 0xFFFFFFFF; i = Prev[i])
+        {
+          FLT px = i < pool_size ? Pool.GetX()[i] : NewX[i - pool_size], py = i < pool_size ? Pool.GetY()[i] : NewY[i - pool_size];
+          DBL dist2 = ((DBL)px - X) * ((DBL)px - X) + ((DBL)py - Y) * ((DBL)py - Y);
+
+          if (dist2 < min_dist2 || (dist2 == min_dist2 && i < found))
+            min_dist2 = dist2, found = i;
+        }
+      }
+    if (found != (size_t)-1)
+      return found;
+    IndexPoint(new_index, X, Y);
+  }
+
+  NewX.push_back(X);
+  NewY.push_back(Y);
+  return new_index;
+} /* End of 'location_import::PlacePoint' function */
+
+/* Add new points to pool function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location_import::FlushPoints( VOID )
+{
+  Pool.Add(NewX.data(), NewY.data(), NewX.size());
+  NewX.clear();
+  NewY.clear();
+} /* End of 'location_import::FlushPoints' function */
+
+/* Finish current ring and make polygon of it function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location_import::RingEnd( VOID )
+{
+  size_t cnt = RingX.size();
+
+  // Closing point repeats first one
+  if (cnt > 1 && RingX[0] == RingX[cnt - 1] && RingY[0] == RingY[cnt - 1])
+    cnt--;
+
+  if (cnt >= 3)
+  {
+    // Points merged with previous are skipped, so there are no zero length segments
+    RingIndices.clear();
+    for (size_t i = 0; i < cnt; i++)
+    {
+      size_t index = PlacePoint(RingX[i], RingY[i]);
+
+      if (RingIndices.empty() || RingIndices.back() != index)
+        RingIndices.push_back(index);
+    }
+    while (RingIndices.size() > 1 && RingIndices.back() == RingIndices.front())
+      RingIndices.pop_back();
+
+    if (RingIndices.size() >= 3)
+    {
+      Result->push_back(polygon());
+
+      std::vector<segment> &lines = Result->back().Lines;
+      lines.reserve(RingIndices.size());
+      for (size_t i = 0; i < RingIndices.size(); i++)
+        lines.push_back(segment(RingIndices[i], RingIndices[(i + 1) % RingIndices.size()]));
+    }
+
+    // Points are added to pool by big groups
+    if (NewX.size() >= 4096)
+      FlushPoints();
+  }
+  RingX.clear();
+  RingY.clear();
+} /* End of 'location_import::RingEnd' function */
+
+/* Parse WKT function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location_import::ParseWkt( VOID )
+{
+  std::string word;
+
+  for (INT ch = Peek(); ch != -1; ch = Peek())
+    if ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z'))
+    {
+      ReadWord(&word);
+      if (word == "POLYGON")
+        ParseWktRings(2);
+      else if (word == "MULTIPOLYGON")
+        ParseWktRings(3);
+    }
+    else
+      Skip();
+} /* End of 'location_import::ParseWkt' function */
+
+/* Parse WKT polygon rings function.
+ * ARGUMENTS:
+ *   - nesting of rings in parenthesis (2 for polygon, 3 for multipolygon):
+ *       INT RingsDepth;
+ * RETURNS: None.
+ */
+VOID location_import::ParseWktRings( INT RingsDepth )
+{
+  std::string word;
+  INT ch = SkipSpaces(), depth = 0;
+
+  const auto IsNumberStart = []( INT Ch ) -> BOOL
+  {
+    return (Ch >= '0' && Ch <= '9') || Ch == '-' || Ch == '+' || Ch == '.';
+  };
+
+  // Dimensions ('Z', 'M', 'ZM') or 'EMPTY' go before rings
+  while ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z'))
+  {
+    ReadWord(&word);
+    if (word == "EMPTY")
+      return;
+    ch = SkipSpaces();
+  }
+  if (ch != '(')
+    return;
+
+  while ((ch = SkipSpaces()) != -1)
+    if (ch == '(')
+      depth++, Skip();
+    else if (ch == ')')
+    {
+      Skip();
+      if (depth == RingsDepth)
+        RingEnd();
+      if (--depth == 0)
+        return;
+    }
+    else if (depth == RingsDepth && IsNumberStart(ch))
+    {
+      DBL x, y;
+
+      // Point is first two numbers of tuple, others (Z, M) are skipped
+      if (ReadNumber(&x) && IsNumberStart(SkipSpaces()) && ReadNumber(&y))
+        RingAdd(x, y);
+      while ((ch = SkipSpaces()) != -1 && ch != ',' && ch != ')')
+        if (IsNumberStart(ch))
+          ReadNumber(&x);
+        else
+          Skip();
+      if (ch == ',')
+        Skip();
+    }
+    else if ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z'))
+      ReadWord(&word);
+    else
+      Skip();
+  RingX.clear();
+  RingY.clear();
+} /* End of 'location_import::ParseWktRings' function */
+
+/* Read GeoJSON string function.
+ * ARGUMENTS:
+ *   - variable to set string start in (longer strings are not kept whole):
+ *       std::string *Str;
+ * RETURNS: None.
+ */
+VOID location_import::ReadString( std::string *Str )
+{
+  Str->clear();
+  Skip();
+  for (INT ch = Peek(); ch != -1 && ch != '"'; ch = Peek())
+  {
+    Skip();
+    if (ch == '\\')
+    {
+      ch = Peek();
+      Skip();
+    }
+    if (Str->size() < 32)
+      Str->push_back((char)ch);
+  }
+  Skip();
+} /* End of 'location_import::ReadString' function */
+
+/* Parse GeoJSON function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location_import::ParseGeoJson( VOID )
+{
+  std::string str, type;
+
+  // Only keys are tracked, all other values are skipped by characters
+  for (INT ch = SkipSpaces(); ch != -1; ch = SkipSpaces())
+    if (ch == '{')
+    {
+      // Geometry type is known only if it goes before coordinates
+      type.clear();
+      Skip();
+    }
+    else if (ch == '"')
+    {
+      ReadString(&str);
+      if (SkipSpaces() != ':')
+        continue;
+      Skip();
+
+      if (str == "type" && SkipSpaces() == '"')
+        ReadString(&type);
+      else if (str == "coordinates" && (type.empty() || type == "Polygon" || type == "MultiPolygon"))
+        ParseGeoJsonCoordinates();
+    }
+    else
+      Skip();
+} /* End of 'location_import::ParseGeoJson' function */
+
+/* Parse GeoJSON coordinates value function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location_import::ParseGeoJsonCoordinates( VOID )
+{
+  INT ch = SkipSpaces(), depth = 0, numbers_cnt = 0, positions_depth = -1;
+  DBL position[2];
+
+  if (ch != '[')
+    return;
+
+  while ((ch = SkipSpaces()) != -1)
+    if (ch == '[')
+      depth++, numbers_cnt = 0, Skip();
+    else if (ch == ']')
+    {
+      Skip();
+      depth--;
+      if (numbers_cnt > 0)
+      {
+        // Position end, array of positions is ring if it is not coordinates itself (line string)
+        if (numbers_cnt >= 2)
+          RingAdd(position[0], position[1]);
+        positions_depth = depth;
+        numbers_cnt = 0;
+      }
+      else if (depth + 1 == positions_depth)
+      {
+        if (depth >= 1)
+          RingEnd();
+        positions_depth = -1;
+      }
+      if (depth == 0)
+        break;
+    }
+    else if ((ch >= '0' && ch <= '9') || ch == '-' || ch == '+' || ch == '.')
+    {
+      DBL value;
+
+      if (ReadNumber(&value) && numbers_cnt < 2)
+        position[numbers_cnt] = value;
+      numbers_cnt++;
+    }
+    else
+      Skip();
+  RingX.clear();
+  RingY.clear();
+} /* End of 'location_import::ParseGeoJsonCoordinates' function */
+
+/* Parse CSV function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location_import::ParseCsv( VOID )
+{
+  std::string id, ring_id;
+
+  const auto SkipBlanks = [&]( VOID ) -> INT
+  {
+    INT ch = Peek();
+
+    while (ch == ' ' || ch == '\t')
+      Skip(), ch = Peek();
+    return ch;
+  };
+
+  for (INT ch = Peek(); ch != -1; ch = Peek())
+  {
+    DBL x, y;
+
+    // Ring id is first field as is
+    id.clear();
+    for (; ch != -1 && ch != ',' && ch != '\n' && ch != '\r'; Skip(), ch = Peek())
+      if (id.size() < 64)
+        id.push_back((char)ch);
+
+    if (ch == ',' && (Skip(), SkipBlanks(), ReadNumber(&x)) && SkipBlanks() == ',' &&
+        (Skip(), SkipBlanks(), ReadNumber(&y)))
+    {
+      if (!RingX.empty() && id != ring_id)
+        RingEnd();
+      RingAdd(x, y);
+      ring_id = id;
+    }
+
+    // Rest of line is skipped
+    for (ch = Peek(); ch != -1 && ch != '\n'; ch = Peek())
+      Skip();
+    if (ch == '\n')
+      Skip();
+  }
+  RingEnd();
+} /* End of 'location_import::ParseCsv' function */
+
+/* Import polygons from file function.
+ * ARGUMENTS:
+ *   - file name:
+ *       const std::string &FileName;
+ *   - polygons container to add polygons to:
+ *       std::vector<polygon> *Polygons;
+ * RETURNS:
+ *   (BOOL) FALSE if file can not be read, TRUE otherwise.
+ */
+BOOL location_import::Import( const std::string &FileName, std::vector<polygon> *Polygons )
+{
+  File.close();
+  File.clear();
+  File.open(FileName, std::ios::binary);
+  if (!File)
+    return FALSE;
+
+  Result = Polygons;
+  Pos = End = 0;
+  RingX.clear();
+  RingY.clear();
+  NewX.clear();
+  NewY.clear();
+
+  // Points which are already in pool are indexed too
+  Cells.clear();
+  Prev.clear();
+  Cells.reserve(Pool.Size());
+  for (size_t i = 0; i < Pool.Size(); i++)
+    IndexPoint(i, Pool.GetX()[i], Pool.GetY()[i]);
+
+  // Format is found by file start (after UTF-8 byte order mark), it is read apart from buffer
+  format fmt = FORMAT_CSV;
+  std::string head(4096, 0);
+
+  File.read(&head[0], (std::streamsize)head.size());
+  head.resize((size_t)File.gcount());
+  File.clear();
+  File.seekg(0);
+  size_t start = head.compare(0, 3, "\xEF\xBB\xBF") == 0 ? 3 : 0;
+  for (size_t i = 0; i < start; i++)
+    Peek(), Skip();
+
+  size_t first = head.find_first_not_of(" \t\r\n", start);
+  std::transform(head.begin(), head.end(), head.begin(), []( char Ch ){ return Ch >= 'a' && Ch <= 'z' ? Ch - 'a' + 'A' : Ch; });
+  if (first != std::string::npos && head[first] == '{')
+    fmt = FORMAT_GEOJSON;
+  else if (head.find("POLYGON") != std::string::npos)
+    fmt = FORMAT_WKT;
+
+  switch (fmt)
+  {
+  case FORMAT_WKT:
+    ParseWkt();
+    break;
+  case FORMAT_GEOJSON:
+    ParseGeoJson();
+    break;
+  case FORMAT_CSV:
+    ParseCsv();
+    break;
+  }
+  FlushPoints();
+
+  BOOL is_ok = !File.bad();
+  File.close();
+  return is_ok;
+} /* End of 'location_import::Import' function */
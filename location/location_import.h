@@ -0,0 +1,236 @@
+#ifndef __location_import_h_
+#define __location_import_h_
+
+#include <fstream>
+#include <unordered_map>
+
+#include "location.h"
+
+/* Polygons datasets streaming import class.
+ * File is read by chunks of fixed size buffer and parsed on the fly, every polygon ring
+ * becomes location polygon as soon as it is read, so whole file is never kept in memory.
+ * Format is found by file start:
+ *   - GeoJSON ('{' first): rings of "coordinates" of Polygon and MultiPolygon geometries;
+ *   - WKT ('POLYGON' or 'MULTIPOLYGON' word in first 4 KB): rings of polygons, other text
+ *     (for example CSV columns around quoted WKT) is skipped;
+ *   - CSV otherwise: '<ring id>,<x>,<y>' lines, ring ends when id changes, not numeric lines are skipped.
+ * Rings closing points are dropped, holes become polygons too (they are holes by nesting).
+ * Points are deduplicated by hash of their coordinates (of radius sized cells), so import time
+ * does not depend on points density, new points are added to pool in bulk.
+ */
+class location_import
+{
+private:
+  /* File format. */
+  enum format
+  {
+    FORMAT_WKT,     // Well-known text
+    FORMAT_GEOJSON, // GeoJSON
+    FORMAT_CSV      // Coordinates CSV
+  }; /* end of 'format' enum */
+
+  points_pool &Pool; // Points pool to add points to
+  DBL CheckRadius;   // Points snapping radius (0 - only equal points are merged)
+
+  // Reading buffer
+  std::ifstream File;
+  std::vector<char> Buffer;
+  size_t Pos = 0, End = 0;
+
+  // Points deduplication index: cell key -> last point of cell, points of cell are chained
+  std::unordered_map<UINT64, UINT32> Cells;
+  std::vector<UINT32> Prev;    // Previous point of cell chain for every point (only for not zero radius)
+  std::vector<FLT> NewX, NewY; // Points not added to pool yet
+
+  // Current ring
+  std::vector<FLT> RingX, RingY;
+  std::vector<size_t> RingIndices;
+  std::vector<polygon> *Result = nullptr; // Polygons container to add polygons to
+
+  /* Get current character function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (INT) character or -1 at file end.
+   */
+  INT Peek( VOID )
+  {
+    if (Pos == End && !Fill())
+      return -1;
+    return (BYTE)Buffer[Pos];
+  } /* End of 'Peek' function */
+
+  /* Go to next character function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID Skip( VOID )
+  {
+    Pos++;
+  } /* End of 'Skip' function */
+
+  /* Read next chunk of file to buffer function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (BOOL) FALSE at file end, TRUE otherwise.
+   */
+  BOOL Fill( VOID );
+
+  /* Skip whitespaces function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (INT) next not whitespace character or -1 at file end.
+   */
+  INT SkipSpaces( VOID );
+
+  /* Read number function.
+   * Numbers are parsed by digits, result is correctly rounded if it has
+   * less than 16 significant digits and small exponent (as usual coordinates have).
+   * ARGUMENTS:
+   *   - variable to set number in:
+   *       DBL *Result;
+   * RETURNS:
+   *   (BOOL) FALSE if there is no number at current character, TRUE otherwise.
+   */
+  BOOL ReadNumber( DBL *Result );
+
+  /* Read word (letters sequence) function.
+   * ARGUMENTS:
+   *   - variable to set word in upper case:
+   *       std::string *Word;
+   * RETURNS: None.
+   */
+  VOID ReadWord( std::string *Word );
+
+  /* Get index cell coordinate of point component function.
+   * ARGUMENTS:
+   *   - point component:
+   *       FLT Coord;
+   * RETURNS:
+   *   (INT64) cell coordinate.
+   */
+  INT64 GetCellCoord( FLT Coord ) const
+  {
+    return (INT64)floor(Coord / CheckRadius);
+  } /* End of 'GetCellCoord' function */
+
+  /* Get index cell key function.
+   * Cell of zero radius index is point itself.
+   * ARGUMENTS:
+   *   - cell coordinates (point coordinates for zero radius):
+   *       INT64 X, INT64 Y;
+   * RETURNS:
+   *   (UINT64) cell key.
+   */
+  static UINT64 GetCellKey( INT64 X, INT64 Y )
+  {
+    return ((UINT64)(UINT32)X << 32) | (UINT32)Y;
+  } /* End of 'GetCellKey' function */
+
+  /* Add point to deduplication index function.
+   * ARGUMENTS:
+   *   - point index in pool (after new points flushing):
+   *       size_t Index;
+   *   - point coordinates:
+   *       FLT X, FLT Y;
+   * RETURNS: None.
+   */
+  VOID IndexPoint( size_t Index, FLT X, FLT Y );
+
+  /* Find point or add it to new points function.
+   * ARGUMENTS:
+   *   - point coordinates:
+   *       FLT X, FLT Y;
+   * RETURNS:
+   *   (size_t) point index in pool (after new points flushing).
+   */
+  size_t PlacePoint( FLT X, FLT Y );
+
+  /* Add new points to pool function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID FlushPoints( VOID );
+
+  /* Add point to current ring function.
+   * ARGUMENTS:
+   *   - point coordinates:
+   *       DBL X, DBL Y;
+   * RETURNS: None.
+   */
+  VOID RingAdd( DBL X, DBL Y )
+  {
+    RingX.push_back((FLT)X);
+    RingY.push_back((FLT)Y);
+  } /* End of 'RingAdd' function */
+
+  /* Finish current ring and make polygon of it function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID RingEnd( VOID );
+
+  /* Parse WKT function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID ParseWkt( VOID );
+
+  /* Parse WKT polygon rings function.
+   * ARGUMENTS:
+   *   - nesting of rings in parenthesis (2 for polygon, 3 for multipolygon):
+   *       INT RingsDepth;
+   * RETURNS: None.
+   */
+  VOID ParseWktRings( INT RingsDepth );
+
+  /* Parse GeoJSON function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID ParseGeoJson( VOID );
+
+  /* Parse GeoJSON coordinates value function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID ParseGeoJsonCoordinates( VOID );
+
+  /* Read GeoJSON string function.
+   * ARGUMENTS:
+   *   - variable to set string start in (longer strings are not kept whole):
+   *       std::string *Str;
+   * RETURNS: None.
+   */
+  VOID ReadString( std::string *Str );
+
+  /* Parse CSV function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID ParseCsv( VOID );
+
+public:
+  /* Import constructor.
+   * ARGUMENTS:
+   *   - points pool to add points to:
+   *       points_pool &Pool;
+   *   - points snapping radius (0 - only equal points are merged):
+   *       DBL CheckRadius;
+   *   - reading buffer size in bytes:
+   *       size_t BufferSize;
+   */
+  location_import( points_pool &Pool, DBL CheckRadius = 0, size_t BufferSize = 1 << 20 );
+
+  /* Import polygons from file function.
+   * ARGUMENTS:
+   *   - file name:
+   *       const std::string &FileName;
+   *   - polygons container to add polygons to:
+   *       std::vector<polygon> *Polygons;
+   * RETURNS:
+   *   (BOOL) FALSE if file can not be read, TRUE otherwise.
+   */
+  BOOL Import( const std::string &FileName, std::vector<polygon> *Polygons );
+}; /* end of 'location_import' class */
+
+#endif /* __location_import_h_ */
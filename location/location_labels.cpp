@@ -0,0 +1,226 @@
+#include "location_labels.h"
+
+// Digits bitmaps
+const BYTE location_labels::Font[10][GlyphH] =
+{
+  {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, // 0
+  {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 1
+  {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, // 2
+  {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, // 3
+  {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, // 4
+  {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, // 5
+  {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, // 6
+  {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // 7
+  {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, // 8
+  {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, // 9
+};
+
+/* Labels renderer destructor. */
+location_labels::~location_labels( VOID )
+{
+  if (Atlas != 0)
+    glDeleteTextures(1, &Atlas);
+} /* End of 'location_labels::~location_labels' function */
+
+/* Create atlas texture function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location_labels::CreateAtlas( VOID )
+{
+  std::vector<BYTE> texels(AtlasW * AtlasH, 0);
+
+  // Texture rows go from bottom to top
+  for (INT digit = 0; digit < 10; digit++)
+    for (INT row = 0; row < GlyphH; row++)
+      for (INT x = 0; x < GlyphW; x++)
+        if (Font[digit][row] & (1 << (GlyphW - 1 - x)))
+          texels[(GlyphH - 1 - row) * AtlasW + digit * GlyphAdvance + x] = 255;
+
+  glGenTextures(1, &Atlas);
+  glBindTexture(GL_TEXTURE_2D, Atlas);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, AtlasW, AtlasH, 0, GL_ALPHA, GL_UNSIGNED_BYTE, texels.data());
+} /* End of 'location_labels::CreateAtlas' function */
+
+/* Get location plane screen mapping from current matrices function.
+ * ARGUMENTS:
+ *   - mapping to fill:
+ *       mapping *Map;
+ * RETURNS:
+ *   (BOOL) whether plane is visible.
+ */
+BOOL location_labels::GetMapping( mapping *Map ) const
+{
+  DBL proj[16], model[16], m[16];
+  GLint viewport[4];
+
+  glGetDoublev(GL_PROJECTION_MATRIX, proj);
+  glGetDoublev(GL_MODELVIEW_MATRIX, model);
+  glGetIntegerv(GL_VIEWPORT, viewport);
+
+  // Column-major matrices product
+  for (INT col = 0; col < 4; col++)
+    for (INT row = 0; row < 4; row++)
+    {
+      m[col * 4 + row] = 0;
+      for (INT k = 0; k < 4; k++)
+        m[col * 4 + row] += proj[k * 4 + row] * model[col * 4 + k];
+    }
+
+  // Location plane is drawn without perspective, so its mapping to pixels is affine
+  Map->Width = viewport[2];
+  Map->Height = viewport[3];
+  Map->ScreenX[0] = m[0] * Map->Width / 2;
+  Map->ScreenX[1] = m[4] * Map->Width / 2;
+  Map->ScreenX[2] = (m[12] + 1) * Map->Width / 2;
+  Map->ScreenY[0] = m[1] * Map->Height / 2;
+  Map->ScreenY[1] = m[5] * Map->Height / 2;
+  Map->ScreenY[2] = (m[13] + 1) * Map->Height / 2;
+
+  DBL det = Map->ScreenX[0] * Map->ScreenY[1] - Map->ScreenX[1] * Map->ScreenY[0];
+  if (Map->Width <= 0 || Map->Height <= 0 || det == 0)
+    return FALSE;
+  Map->PixelX[0] = Map->ScreenY[1] / det;
+  Map->PixelX[1] = -Map->ScreenX[1] / det;
+  Map->PixelY[0] = -Map->ScreenY[0] / det;
+  Map->PixelY[1] = Map->ScreenX[0] / det;
+
+  Map->CellsW = MinSpacing > 0 ? (INT)ceil(Map->Width / MinSpacing) : 0;
+  Map->CellsH = MinSpacing > 0 ? (INT)ceil(Map->Height / MinSpacing) : 0;
+  return TRUE;
+} /* End of 'location_labels::GetMapping' function */
+
+/* Add point label quads function.
+ * ARGUMENTS:
+ *   - points pool:
+ *       const points_pool &Pool;
+ *   - point index:
+ *       size_t Point;
+ *   - screen mapping:
+ *       const mapping &Map;
+ *   - label color:
+ *       BYTE R, BYTE G, BYTE B;
+ * RETURNS: None.
+ */
+VOID location_labels::AddLabel( const points_pool &Pool, size_t Point, const mapping &Map, BYTE R, BYTE G, BYTE B )
+{
+  // Every point is labeled once per frame, even if it is shared by several segments
+  if (PointsMarks[Point] == Frame)
+    return;
+  PointsMarks[Point] = Frame;
+
+  DBL
+    x = Pool[Point][0],
+    y = Pool[Point][1] + OffsetY,
+    sx = Map.ScreenX[0] * x + Map.ScreenX[1] * y + Map.ScreenX[2],
+    sy = Map.ScreenY[0] * x + Map.ScreenY[1] * y + Map.ScreenY[2];
+
+  if (sx < 0 || sy < 0 || sx >= Map.Width || sy >= Map.Height)
+    return;
+
+  // Only one label per screen cell
+  if (Map.CellsW > 0)
+  {
+    size_t cell = (size_t)(sy / MinSpacing) * Map.CellsW + (size_t)(sx / MinSpacing);
+
+    if (Cells[cell] == Frame)
+      return;
+    Cells[cell] = Frame;
+  }
+
+  if (Texts[Point].empty())
+    Texts[Point] = std::to_string(Point);
+
+  const std::string &text = Texts[Point];
+  for (size_t i = 0; i < text.size(); i++)
+  {
+    INT digit = text[i] - '0';
+    DBL
+      px0 = (DBL)i * GlyphAdvance * GlyphScale, px1 = px0 + GlyphW * GlyphScale,
+      py1 = GlyphH * GlyphScale;
+    FLT
+      u0 = (FLT)(digit * GlyphAdvance) / AtlasW, u1 = (FLT)(digit * GlyphAdvance + GlyphW) / AtlasW,
+      v1 = (FLT)GlyphH / AtlasH;
+    const DBL corners[4][2] = {{px0, 0}, {px1, 0}, {px1, py1}, {px0, py1}};
+    const FLT tex[4][2] = {{u0, 0}, {u1, 0}, {u1, v1}, {u0, v1}};
+
+    for (INT k = 0; k < 4; k++)
+    {
+      Vertices.push_back((FLT)(x + Map.PixelX[0] * corners[k][0] + Map.PixelX[1] * corners[k][1]));
+      Vertices.push_back((FLT)(y + Map.PixelY[0] * corners[k][0] + Map.PixelY[1] * corners[k][1]));
+      TexCoords.push_back(tex[k][0]);
+      TexCoords.push_back(tex[k][1]);
+      Colors.push_back(R);
+      Colors.push_back(G);
+      Colors.push_back(B);
+    }
+  }
+} /* End of 'location_labels::AddLabel' function */
+
+/* Draw points labels function.
+ * ARGUMENTS:
+ *   - points pool:
+ *       const points_pool &Pool;
+ *   - location walls:
+ *       const std::vector<polygon> &Walls;
+ *   - current polygon:
+ *       const polygon &CurrPoly;
+ * RETURNS: None.
+ */
+VOID location_labels::Draw( const points_pool &Pool, const std::vector<polygon> &Walls, const polygon &CurrPoly )
+{
+  mapping map;
+
+  if (!GetMapping(&map))
+    return;
+  if (Atlas == 0)
+    CreateAtlas();
+
+  Frame++;
+  Texts.resize(Pool.Size());
+  PointsMarks.resize(Pool.Size(), 0);
+  Cells.resize((size_t)map.CellsW * map.CellsH, 0);
+  Vertices.clear();
+  TexCoords.clear();
+  Colors.clear();
+
+  // Walls labels are placed first, so they are not hidden by current polygon labels
+  for (const polygon &wall : Walls)
+    for (const segment &seg : wall.Lines)
+    {
+      AddLabel(Pool, seg.St, map, 102, 204, 76);
+      AddLabel(Pool, seg.End, map, 102, 204, 76);
+    }
+  for (const segment &seg : CurrPoly.Lines)
+  {
+    AddLabel(Pool, seg.St, map, 0, 0, 0);
+    AddLabel(Pool, seg.End, map, 0, 0, 0);
+  }
+  if (Vertices.empty())
+    return;
+
+  glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TEXTURE_BIT | GL_CURRENT_BIT);
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+  glEnable(GL_TEXTURE_2D);
+  glBindTexture(GL_TEXTURE_2D, Atlas);
+  glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+  glVertexPointer(2, GL_FLOAT, 0, Vertices.data());
+  glTexCoordPointer(2, GL_FLOAT, 0, TexCoords.data());
+  glColorPointer(3, GL_UNSIGNED_BYTE, 0, Colors.data());
+  glDrawArrays(GL_QUADS, 0, (GLsizei)(Vertices.size() / 2));
+
+  glPopClientAttrib();
+  glPopAttrib();
+} /* End of 'location_labels::Draw' function */
@@ -0,0 +1,99 @@
+#ifndef __location_labels_h_
+#define __location_labels_h_
+
+#include "location.h"
+
+/* Location points labels renderer class.
+ * Every point is labeled by its index once per frame. Labels are drawn as textured quads
+ * from one digits atlas texture by one draw call. Labels are kept at constant on-screen size;
+ * a label is hidden if it is out of viewport or too close to already placed label,
+ * so dense plans show only part of labels.
+ */
+class location_labels
+{
+private:
+  static const INT GlyphW = 5, GlyphH = 7;         // Glyph size in atlas texels
+  static const INT AtlasW = 64, AtlasH = 8;        // Atlas texture size
+  static const INT GlyphScale = 2;                 // Screen pixels per atlas texel
+  static const INT GlyphAdvance = GlyphW + 1;      // Distance between glyphs in atlas texels
+  static const BYTE Font[10][GlyphH];              // Digits bitmaps (top row first, 5 low bits per row)
+
+  GLuint Atlas = 0;         // Atlas texture
+  FLT MinSpacing = 24;      // Minimal distance between labels in pixels (0 - show all)
+  const FLT OffsetY = 0.03f; // Label offset from point in location units
+
+  std::vector<std::string> Texts; // Cached points labels
+  std::vector<size_t> PointsMarks; // Frame number of last point label adding (for deduplication)
+  std::vector<size_t> Cells;       // Frame number of last label placed in screen cell
+  size_t Frame = 0;                // Current frame number
+
+  std::vector<FLT> Vertices, TexCoords; // Quads vertices
+  std::vector<BYTE> Colors;              // Quads vertices colors
+
+  /* Screen mapping of location plane. */
+  struct mapping
+  {
+    DBL ScreenX[3], ScreenY[3]; // Location point to pixels transform
+    DBL PixelX[2], PixelY[2];   // Pixels offset to location offset transform
+    INT Width, Height;          // Viewport size
+    INT CellsW, CellsH;         // Culling grid size
+  }; /* end of 'mapping' struct */
+
+  /* Create atlas texture function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID CreateAtlas( VOID );
+
+  /* Get location plane screen mapping from current matrices function.
+   * ARGUMENTS:
+   *   - mapping to fill:
+   *       mapping *Map;
+   * RETURNS:
+   *   (BOOL) whether plane is visible.
+   */
+  BOOL GetMapping( mapping *Map ) const;
+
+  /* Add point label quads function.
+   * ARGUMENTS:
+   *   - points pool:
+   *       const points_pool &Pool;
+   *   - point index:
+   *       size_t Point;
+   *   - screen mapping:
+   *       const mapping &Map;
+   *   - label color:
+   *       BYTE R, BYTE G, BYTE B;
+   * RETURNS: None.
+   */
+  VOID AddLabel( const points_pool &Pool, size_t Point, const mapping &Map, BYTE R, BYTE G, BYTE B );
+
+public:
+  /* Labels renderer destructor. */
+  ~location_labels( VOID );
+
+  /* Set labels density function.
+   * ARGUMENTS:
+   *   - minimal distance between labels in pixels (0 to show all labels):
+   *       FLT Pixels;
+   * RETURNS: None.
+   */
+  VOID SetMinSpacing( FLT Pixels )
+  {
+    MinSpacing = mth::Max(Pixels, 0.0f);
+  } /* End of 'SetMinSpacing' function */
+
+  /* Draw points labels function.
+   * ARGUMENTS:
+   *   - points pool:
+   *       const points_pool &Pool;
+   *   - location walls:
+   *       const std::vector<polygon> &Walls;
+   *   - current polygon:
+   *       const polygon &CurrPoly;
+   * RETURNS: None.
+   */
+  VOID Draw( const points_pool &Pool, const std::vector<polygon> &Walls, const polygon &CurrPoly );
+}; /* end of 'location_labels' class */
+
+#endif /* __location_labels_h_ */
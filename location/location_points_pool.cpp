@@ -1,7 +1,77 @@
+#include <algorithm>
+
 #include "location_points_pool.h"
+#include "location_simd.h"
 
 const DBL points_pool::Epsilon = 0.0001;            // Epsilon of point finding
 const DBL points_pool::Epsilon2 = Epsilon * Epsilon; // Epsilon sqared
+const DBL points_pool::DefaultCellSize = 0.03;       // Grid cell size used by default
+
+/* Points pool constructor.
+ * ARGUMENTS:
+ *   - size of grid index cell, should be about points search radius:
+ *       DBL CellSize;
+ */
+points_pool::points_pool( DBL CellSize ) :
+  CellSize(CellSize)
+{
+} /* End of 'points_pool::points_pool' function */
+
+/* Add point to grid index function.
+ * ARGUMENTS:
+ *   - index of point in pool:
+ *       size_t Index;
+ * RETURNS: None.
+ */
+VOID points_pool::GridInsert( size_t Index )
+{
+  cell &c = Cells[GetCellKey(GetCellCoord(X[Index]), GetCellCoord(Y[Index]))];
+
+  c.Indices.push_back((UINT32)Index);
+  c.X.push_back(X[Index]);
+  c.Y.push_back(Y[Index]);
+} /* End of 'points_pool::GridInsert' function */
+
+/* Remove point from grid index function.
+ * ARGUMENTS:
+ *   - index of point in pool:
+ *       size_t Index;
+ * RETURNS: None.
+ */
+VOID points_pool::GridRemove( size_t Index )
+{
+  auto cell = Cells.find(GetCellKey(GetCellCoord(X[Index]), GetCellCoord(Y[Index])));
+  if (cell == Cells.end())
+    return;
+
+  auto &c = cell->second;
+  size_t pos = std::find(c.Indices.begin(), c.Indices.end(), (UINT32)Index) - c.Indices.begin();
+  if (pos < c.Indices.size())
+  {
+    c.Indices[pos] = c.Indices.back(), c.X[pos] = c.X.back(), c.Y[pos] = c.Y.back();
+    c.Indices.pop_back(), c.X.pop_back(), c.Y.pop_back();
+  }
+  if (c.Indices.empty())
+    Cells.erase(cell);
+} /* End of 'points_pool::GridRemove' function */
+
+/* Get squared search radius in FLT function.
+ * ARGUMENTS:
+ *   - search radius:
+ *       DBL CheckRadius;
+ * RETURNS:
+ *   (FLT) least FLT not less than squared radius.
+ */
+FLT points_pool::GetMaxDist2( DBL CheckRadius )
+{
+  DBL max_dist2 = CheckRadius == Epsilon ? Epsilon2 : CheckRadius * CheckRadius;
+  FLT res = (FLT)max_dist2;
+
+  // FLT distance is less than result exactly when it is less than DBL squared radius
+  if (res < max_dist2)
+    res = nextafterf(res, INFINITY);
+  return res;
+} /* End of 'points_pool::GetMaxDist2' function */
 
 /* Get point index in points pool.
  * ARGUMENTS:
@@ -16,19 +86,34 @@ const DBL points_pool::Epsilon2 = Epsilon * Epsilon; // Epsilon sqared
  */
 BOOL points_pool::Get( const vec2 &Pnt, size_t *Result, DBL CheckRadius ) const
 {
-  size_t min_dist_pnt = -1;
-  DBL min_dist2 = CheckRadius == Epsilon ? Epsilon2 : CheckRadius * CheckRadius;
+  FLT min_dist2 = GetMaxDist2(CheckRadius);
+  UINT32 min_dist_pnt = 0xFFFFFFFF;
 
-  // Check if point exectly matches with existing (with Epsilon)
-  for (size_t i = 0, cnt = Points.size(); i < cnt; i++)
+  // Point-Circle intersection, prefer lower index on equal distances as linear scan does
+  const auto CheckCell = [&]( const cell &Cell )
   {
-    // Point-Circle intersection
-    DBL dist2 = (Pnt - Points[i]).Length2();
-    if (dist2 < min_dist2)
-      min_dist2 = dist2, min_dist_pnt = i;
-  }
+    simd::NearestPoint(Cell.X.data(), Cell.Y.data(), Cell.Indices.data(), Cell.Indices.size(),
+                       Pnt[0], Pnt[1], &min_dist2, &min_dist_pnt);
+  };
+
+  DBL
+    min_x = floor((Pnt[0] - CheckRadius) / CellSize), max_x = floor((Pnt[0] + CheckRadius) / CellSize),
+    min_y = floor((Pnt[1] - CheckRadius) / CellSize), max_y = floor((Pnt[1] + CheckRadius) / CellSize);
+
+  // Check only cells covered by search circle, or all filled cells if there are less of them
+  if ((max_x - min_x + 1) * (max_y - min_y + 1) > Cells.size())
+    for (const auto &cell : Cells)
+      CheckCell(cell.second);
+  else
+    for (INT y = (INT)min_y; y <= (INT)max_y; y++)
+      for (INT x = (INT)min_x; x <= (INT)max_x; x++)
+      {
+        auto cell = Cells.find(GetCellKey(x, y));
+        if (cell != Cells.end())
+          CheckCell(cell->second);
+      }
 
-  if (min_dist_pnt == -1)
+  if (min_dist_pnt == 0xFFFFFFFF)
     return FALSE;
 
   if (Result != nullptr)
@@ -37,53 +122,122 @@ BOOL points_pool::Get( const vec2 &Pnt, size_t *Result, DBL CheckRadius ) const
   return TRUE;
 } /* End of 'points_pool::Get' function */
 
-/* Get point rvalue by index.
- * ARGUMETNS:
- *   - index:
- *       size_t Index;
+/* Get indices of many points in points pool function.
+ * Queries are processed grouped by grid cells, so every cell is loaded once per group.
+ * ARGUMENTS:
+ *   - points to get indices of:
+ *       const std::vector<vec2> &Pnts;
+ *   - indices container, index is (size_t)-1 if point is not found:
+ *       std::vector<size_t> *Results;
+ *   - radius of area in which try to find points:
+ *       DBL CheckRadius;
  * RETURNS:
- *   (const vec2 &) point.
+ *   (size_t) count of found points.
  */
-const vec2 &points_pool::Get( size_t Index ) const
+size_t points_pool::Get( const std::vector<vec2> &Pnts, std::vector<size_t> *Results, DBL CheckRadius ) const
 {
-  return Points[mth::Clamp(Index, (size_t)0, Points.size() - 1)];
+  size_t found = 0;
+  INT reach = (INT)ceil(CheckRadius / CellSize); // Cells around query cell which search circle can cover
+  FLT max_dist2 = GetMaxDist2(CheckRadius);
+
+  Results->assign(Pnts.size(), (size_t)-1);
+
+  // Queries sorted by its cells
+  std::vector<std::pair<UINT64, size_t>> order(Pnts.size());
+  for (size_t i = 0; i < Pnts.size(); i++)
+    order[i] = {GetCellKey(GetCellCoord(Pnts[i][0]), GetCellCoord(Pnts[i][1])), i};
+  std::sort(order.begin(), order.end());
+
+  std::vector<const cell *> near_cells;
+  BOOL is_all_cells = (DBL)(2 * reach + 1) * (2 * reach + 1) > Cells.size();
+  if (is_all_cells)
+    for (const auto &cell : Cells)
+      near_cells.push_back(&cell.second);
+
+  for (size_t i = 0; i < order.size(); i++)
+  {
+    const vec2 &pnt = Pnts[order[i].second];
+
+    // Collect cells around new query cell (superset of cells covered by search circle)
+    if (!is_all_cells && (i == 0 || order[i].first != order[i - 1].first))
+    {
+      INT cx = GetCellCoord(pnt[0]), cy = GetCellCoord(pnt[1]);
+
+      near_cells.clear();
+      for (INT y = cy - reach; y <= cy + reach; y++)
+        for (INT x = cx - reach; x <= cx + reach; x++)
+        {
+          auto cell = Cells.find(GetCellKey(x, y));
+          if (cell != Cells.end())
+            near_cells.push_back(&cell->second);
+        }
+    }
+
+    FLT min_dist2 = max_dist2;
+    UINT32 min_dist_pnt = 0xFFFFFFFF;
+    for (const cell *c : near_cells)
+      simd::NearestPoint(c->X.data(), c->Y.data(), c->Indices.data(), c->Indices.size(),
+                         pnt[0], pnt[1], &min_dist2, &min_dist_pnt);
+
+    if (min_dist_pnt != 0xFFFFFFFF)
+      (*Results)[order[i].second] = min_dist_pnt, found++;
+  }
+  return found;
 } /* End of 'points_pool::Get' function */
 
 /* Get point rvalue by index.
  * ARGUMETNS:
- *   - index:
+ *   - index (clamped to pool size):
  *       size_t Index;
  * RETURNS:
- *   (const vec2 &) point.
+ *   (vec2) point.
  */
-const vec2 &points_pool::operator[]( size_t Index ) const
+vec2 points_pool::Get( size_t Index ) const
 {
-  return Get(Index);
-} /* End of 'points_pool::operator[]' function */
+  return At(mth::Clamp(Index, (size_t)0, X.size() - 1));
+} /* End of 'points_pool::Get' function */
 
-/* Get point lvalue by index.
+/* Get point rvalue by index.
  * ARGUMETNS:
- *   - index:
+ *   - index (clamped to pool size):
  *       size_t Index;
  * RETURNS:
- *   (vec2 &) point.
+ *   (vec2) point.
  */
-vec2 &points_pool::Get( size_t Index )
+vec2 points_pool::operator[]( size_t Index ) const
 {
-  return Points[mth::Clamp(Index, (size_t)0, Points.size() - 1)];
-} /* End of 'points_pool::Get' function */
+  return Get(Index);
+} /* End of 'points_pool::operator[]' function */
 
-/* Get point lvalue by index.
+/* Set point possition function.
  * ARGUMETNS:
  *   - index:
  *       size_t Index;
- * RETURNS:
- *   (vec2 &) point.
+ *   - new point possition:
+ *       const vec2 &Pnt;
+ * RETURNS: None.
  */
-vec2 &points_pool::operator[]( size_t Index )
+VOID points_pool::Set( size_t Index, const vec2 &Pnt )
 {
-  return Get(Index);
-} /* End of 'points_pool::operator[]' function */
+  if (Index >= X.size())
+    return;
+
+  // Move point between grid cells only if it left its cell
+  if (GetCellCoord(X[Index]) == GetCellCoord(Pnt[0]) &&
+      GetCellCoord(Y[Index]) == GetCellCoord(Pnt[1]))
+  {
+    cell &c = Cells[GetCellKey(GetCellCoord(X[Index]), GetCellCoord(Y[Index]))];
+    size_t pos = std::find(c.Indices.begin(), c.Indices.end(), (UINT32)Index) - c.Indices.begin();
+
+    c.X[pos] = X[Index] = Pnt[0];
+    c.Y[pos] = Y[Index] = Pnt[1];
+    return;
+  }
+
+  GridRemove(Index);
+  X[Index] = Pnt[0], Y[Index] = Pnt[1];
+  GridInsert(Index);
+} /* End of 'points_pool::Set' function */
 
 /* Add point to pool function.
  * ARGUMENTS:
@@ -101,8 +255,10 @@ size_t points_pool::Add( const vec2 &Pnt, DBL CheckRadius )
   if (Get(Pnt, &new_pnt, CheckRadius))
     return new_pnt;
 
-  Points.push_back(Pnt);
-  return Points.size() - 1;
+  X.push_back(Pnt[0]);
+  Y.push_back(Pnt[1]);
+  GridInsert(X.size() - 1);
+  return X.size() - 1;
 } /* End of 'points_pool::AddPoint' function */
 
 /* Add point to pool function.
@@ -116,4 +272,65 @@ points_pool &points_pool::operator<<( const vec2 &Pnt )
 {
   Add(Pnt);
   return *this;
-} /* End of 'points_pool::operator<<' function */
\ No newline at end of file
+} /* End of 'points_pool::operator<<' function */
+
+/* Add points to pool as is function.
+ * Points are not snapped to existing ones, so they should be deduplicated by caller.
+ * ARGUMENTS:
+ *   - points coordinates arrays:
+ *       const FLT *PntsX, const FLT *PntsY;
+ *   - points count:
+ *       size_t Count;
+ * RETURNS:
+ *   (size_t) index of first added point in pool.
+ */
+size_t points_pool::Add( const FLT *PntsX, const FLT *PntsY, size_t Count )
+{
+  size_t first = X.size();
+
+  X.insert(X.end(), PntsX, PntsX + Count);
+  Y.insert(Y.end(), PntsY, PntsY + Count);
+  for (size_t i = first; i < X.size(); i++)
+    GridInsert(i);
+  return first;
+} /* End of 'points_pool::Add' function */
+
+/* Replace all points function.
+ * Points are taken as is without snapping, grid index is built again.
+ * ARGUMENTS:
+ *   - points coordinates arrays:
+ *       const FLT *PntsX, const FLT *PntsY;
+ *   - points count:
+ *       size_t Count;
+ * RETURNS: None.
+ */
+VOID points_pool::Assign( const FLT *PntsX, const FLT *PntsY, size_t Count )
+{
+  Clear();
+  Add(PntsX, PntsY, Count);
+} /* End of 'points_pool::Assign' function */
+
+/* Delete last added point function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID points_pool::PopBack( VOID )
+{
+  if (X.empty())
+    return;
+
+  GridRemove(X.size() - 1);
+  X.pop_back();
+  Y.pop_back();
+} /* End of 'points_pool::PopBack' function */
+
+/* Delete all points function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID points_pool::Clear( VOID )
+{
+  X.clear();
+  Y.clear();
+  Cells.clear();
+} /* End of 'points_pool::Clear' function */
\ No newline at end of file
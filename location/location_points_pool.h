@@ -1,23 +1,95 @@
 #ifndef __location_points_pool_h_
 #define __location_points_pool_h_
 
+#include <unordered_map>
+
 #include "../def.h"
 
 // Forward declaration
 class location;
 
-/* Location representation class. */
+/* Location points pool class.
+ * Points coordinates are stored as separate contiguous X and Y arrays, so scans over
+ * points are linear in memory. Points are addressed by 32-bit indices.
+ */
 class points_pool
 {
 private:
   friend class location;
 
-  std::vector<vec2> Points; // All location_points_pool points pool
+  std::vector<FLT> X, Y; // All location points coordinates
+
+  /* Grid cell: points lying in it with copies of their coordinates, so cell is scanned linearly. */
+  struct cell
+  {
+    std::vector<UINT32> Indices; // Points indices
+    std::vector<FLT> X, Y;       // Points coordinates
+  }; /* end of 'cell' struct */
+
+  // Uniform grid spatial index: cell key -> points lying in cell
+  std::unordered_map<UINT64, cell> Cells;
+  DBL CellSize; // Size of grid cell side
+
+  static const DBL Epsilon;         // Epsilon of point finding
+  static const DBL Epsilon2;        // Epsilon sqared
+  static const DBL DefaultCellSize; // Grid cell size used by default
+
+  /* Get grid cell coordinate of point component function.
+   * ARGUMENTS:
+   *   - point component:
+   *       DBL Coord;
+   * RETURNS:
+   *   (INT) grid cell coordinate.
+   */
+  INT GetCellCoord( DBL Coord ) const
+  {
+    return (INT)floor(Coord / CellSize);
+  } /* End of 'GetCellCoord' function */
 
-  static const DBL Epsilon;  // Epsilon of point finding
-  static const DBL Epsilon2; // Epsilon sqared
+  /* Get grid cell key by cell coordinates function.
+   * ARGUMENTS:
+   *   - cell coordinates:
+   *       INT X, INT Y;
+   * RETURNS:
+   *   (UINT64) cell key.
+   */
+  static UINT64 GetCellKey( INT X, INT Y )
+  {
+    return ((UINT64)(UINT32)X << 32) | (UINT32)Y;
+  } /* End of 'GetCellKey' function */
+
+  /* Add point to grid index function.
+   * ARGUMENTS:
+   *   - index of point in pool:
+   *       size_t Index;
+   * RETURNS: None.
+   */
+  VOID GridInsert( size_t Index );
+
+  /* Remove point from grid index function.
+   * ARGUMENTS:
+   *   - index of point in pool:
+   *       size_t Index;
+   * RETURNS: None.
+   */
+  VOID GridRemove( size_t Index );
+
+  /* Get squared search radius in FLT function.
+   * ARGUMENTS:
+   *   - search radius:
+   *       DBL CheckRadius;
+   * RETURNS:
+   *   (FLT) least FLT not less than squared radius.
+   */
+  static FLT GetMaxDist2( DBL CheckRadius );
 
 public:
+  /* Points pool constructor.
+   * ARGUMENTS:
+   *   - size of grid index cell, should be about points search radius:
+   *       DBL CellSize;
+   */
+  points_pool( DBL CellSize = DefaultCellSize );
 
   //
   // Points manage functions
@@ -36,41 +108,79 @@ public:
    */
   BOOL Get( const vec2 &Pnt, size_t *Result, DBL CheckRadius = Epsilon ) const;
 
+  /* Get indices of many points in points pool function.
+   * Queries are processed grouped by grid cells, so every cell is loaded once per group.
+   * ARGUMENTS:
+   *   - points to get indices of:
+   *       const std::vector<vec2> &Pnts;
+   *   - indices container, index is (size_t)-1 if point is not found:
+   *       std::vector<size_t> *Results;
+   *   - radius of area in which try to find points:
+   *       DBL CheckRadius;
+   * RETURNS:
+   *   (size_t) count of found points.
+   */
+  size_t Get( const std::vector<vec2> &Pnts, std::vector<size_t> *Results, DBL CheckRadius = Epsilon ) const;
+
   /* Get point rvalue by index.
    * ARGUMETNS:
-   *   - index:
+   *   - index (clamped to pool size):
    *       size_t Index;
    * RETURNS:
-   *   (const vec2 &) point.
+   *   (vec2) point.
    */
-  const vec2 &Get( size_t Index ) const;
+  vec2 Get( size_t Index ) const;
 
   /* Get point rvalue by index.
    * ARGUMETNS:
-   *   - index:
+   *   - index (clamped to pool size):
    *       size_t Index;
    * RETURNS:
-   *   (const vec2 &) point.
+   *   (vec2) point.
    */
-  const vec2 &operator[]( size_t Index ) const;
+  vec2 operator[]( size_t Index ) const;
 
-  /* Get point lvalue by index.
+  /* Get point by index without range check function (for hot loops).
    * ARGUMETNS:
-   *   - index:
+   *   - index, should be less than pool size:
    *       size_t Index;
    * RETURNS:
-   *   (vec2 &) point.
+   *   (vec2) point.
+   */
+  vec2 At( size_t Index ) const
+  {
+    return vec2(X[Index], Y[Index]);
+  } /* End of 'At' function */
+
+  /* Get points X coordinates array function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (const FLT *) Size() X coordinates.
    */
-  vec2 &Get( size_t Index );
+  const FLT *GetX( VOID ) const
+  {
+    return X.data();
+  } /* End of 'GetX' function */
 
-  /* Get point lvalue by index.
+  /* Get points Y coordinates array function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (const FLT *) Size() Y coordinates.
+   */
+  const FLT *GetY( VOID ) const
+  {
+    return Y.data();
+  } /* End of 'GetY' function */
+
+  /* Set point possition function.
    * ARGUMETNS:
    *   - index:
    *       size_t Index;
-   * RETURNS:
-   *   (vec2 &) point.
+   *   - new point possition:
+   *       const vec2 &Pnt;
+   * RETURNS: None.
    */
-  vec2 &operator[]( size_t Index );
+  VOID Set( size_t Index, const vec2 &Pnt );
 
   /* Add point to pool function.
    * ARGUMENTS:
@@ -92,6 +202,51 @@ public:
    */
   points_pool &operator<<( const vec2 &Pnt );
 
+  /* Add points to pool as is function.
+   * Points are not snapped to existing ones, so they should be deduplicated by caller.
+   * ARGUMENTS:
+   *   - points coordinates arrays:
+   *       const FLT *PntsX, const FLT *PntsY;
+   *   - points count:
+   *       size_t Count;
+   * RETURNS:
+   *   (size_t) index of first added point in pool.
+   */
+  size_t Add( const FLT *PntsX, const FLT *PntsY, size_t Count );
+
+  /* Replace all points function.
+   * Points are taken as is without snapping, grid index is built again.
+   * ARGUMENTS:
+   *   - points coordinates arrays:
+   *       const FLT *PntsX, const FLT *PntsY;
+   *   - points count:
+   *       size_t Count;
+   * RETURNS: None.
+   */
+  VOID Assign( const FLT *PntsX, const FLT *PntsY, size_t Count );
+
+  /* Delete last added point function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID PopBack( VOID );
+
+  /* Delete all points function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID Clear( VOID );
+
+  /* Get count of points in pool function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (size_t) count of points.
+   */
+  size_t Size( VOID ) const
+  {
+    return X.size();
+  } /* End of 'Size' function */
+
 }; /* end of 'location_points_pool' class */
 
 #endif /* __location_points_pool_h_ */
\ No newline at end of file
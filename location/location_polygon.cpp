@@ -3,141 +3,266 @@
 #include <algorithm>
 
 #include "location.h"
+#include "location_predicates.h"
+#include "location_prepared_polygon.h"
+#include "location_simd.h"
 
 /* Merge polygons function.
  * ARGUMENTS:
+ *   - points pool of polygons points (intersection points are added to it):
+ *       points_pool &Pool;
  *   - polygon to merge with:
  *       const polygon &Polly1, const polygon &Polly2;
  *   - polygon to set merged one in:
  *       polygon *Merged;
- * RETURNS: None.
+ * RETURNS:
+ *   (BOOL) TRUE if merged outline is closed, FALSE if some its walk did not come back to start point (see 'MergeBuild').
  */
-VOID polygon::Merge(const polygon &Polly, polygon *Merged) const
+BOOL polygon::Merge( points_pool &Pool, const polygon &Polly, polygon *Merged ) const
 {
-  BOOL IsIntersection = FALSE;                      // Show wheather any segments in polygons intersected or not.
-  std::map<size_t, std::vector<size_t>> InterEdjes; // Adjacnency list of edjes with start and end in polygons segments intersection points
+  // Merge data is kept by thread, so memory of its arena is reused by next merges.
+  // It is cleared after merge and keeps only bounded memory, so one big merge does not hold memory for thread life
+  static thread_local merge_data data;
 
-  // Fill adjacnency list of edjes list function
-  const auto IntersectPolygons = [&](const polygon &PollyFirst, const polygon &PollySeccond)
-  {
-    std::vector<size_t> prev_pnt_inters;
+  MergeIntersect(Pool, Polly, &data);
+  MergeAddPoints(Pool, &data);
+  BOOL is_closed = MergeBuild(Pool, Polly, &data, Merged);
+  data.Clear(merge_data::KeptMemory);
+  return is_closed;
+} /* End of 'polygon::Merge' function */
 
-    for (size_t i = 0, cnt = PollyFirst.Lines.size(); i < cnt; i++)
-    {
-      size_t next_pnt_ind = PollyFirst.Lines[i].End;
-      size_t curr_pnt_ind = PollyFirst.Lines[i].St;
+/* Merge many polygons function.
+ * Polygons are merged by pairs in rounds of balanced reduction tree, merges of every round
+ * run concurrently (except adding intersection points to pool, done in polygons order).
+ * ARGUMENTS:
+ *   - points pool of polygons points (intersection points are added to it):
+ *       points_pool &Pool;
+ *   - polygons to merge:
+ *       std::vector<polygon> Pollys;
+ *   - threads pool to run merges in:
+ *       thread_pool &Threads;
+ *   - polygon to set merged one in:
+ *       polygon *Merged;
+ * RETURNS:
+ *   (BOOL) TRUE if all merged outlines are closed, FALSE if some walk did not come back to start point (see 'MergeBuild').
+ */
+BOOL polygon::MergeAll( points_pool &Pool, std::vector<polygon> Pollys, thread_pool &Threads, polygon *Merged )
+{
+  // Merge data of every pair, kept between rounds (but not after merge), so arenas memory is reused
+  std::unique_ptr<merge_data[]> datas(new merge_data[Pollys.size() / 2]);
+  std::unique_ptr<BYTE[]> is_closed(new BYTE[Pollys.size() / 2]);
+  BOOL is_all_closed = TRUE;
 
-      // Get all intersection with another polly
-      std::vector<size_t> current_pnt_inters;
-      current_pnt_inters.push_back(next_pnt_ind);
-      current_pnt_inters.push_back(curr_pnt_ind);
-      for (const segment &seg_to_inter : PollySeccond.Lines)
+  // Neighbour polygons are merged to first of them, so results of one round are not read by other merges
+  while (Pollys.size() > 1)
+  {
+    size_t pairs_cnt = Pollys.size() / 2;
+
+    Threads.For(pairs_cnt, [&]( size_t Pair )
+      {
+        datas[Pair].Clear();
+        Pollys[Pair * 2].MergeIntersect(Pool, Pollys[Pair * 2 + 1], &datas[Pair]);
+      });
+    for (size_t i = 0; i < pairs_cnt; i++)
+      MergeAddPoints(Pool, &datas[i]);
+    Threads.For(pairs_cnt, [&]( size_t Pair )
       {
-        vec2 res;
+        is_closed[Pair] = Pollys[Pair * 2].MergeBuild(Pool, Pollys[Pair * 2 + 1], &datas[Pair], &Pollys[Pair * 2]);
+      });
+    for (size_t i = 0; i < pairs_cnt; i++)
+      is_all_closed = is_all_closed && is_closed[i];
 
-        // Check is segments intersects
-        if (PollyFirst.Lines[i].Intersect(location::PointsPool[seg_to_inter.St], location::PointsPool[seg_to_inter.End], &res))
-        {
-          size_t index = location::PointsPool.Add(res);
-          IsIntersection = TRUE;
+    // Merged polygons (and last one without pair) go to next round
+    for (size_t i = 1; i < pairs_cnt; i++)
+      Pollys[i] = std::move(Pollys[i * 2]);
+    if (Pollys.size() % 2 != 0)
+      Pollys[pairs_cnt++] = std::move(Pollys.back());
+    Pollys.resize(pairs_cnt);
+  }
 
-          // Add intersection point only if its not added already
-          if (std::find(InterEdjes[curr_pnt_ind].begin(), InterEdjes[curr_pnt_ind].end(), index) == InterEdjes[curr_pnt_ind].end() &&
-              std::find(current_pnt_inters.begin(), current_pnt_inters.end(), index) == current_pnt_inters.end())
-            current_pnt_inters.push_back(index);
-        }
-      }
+  if (Pollys.empty())
+    Merged->Lines.clear();
+  else
+    *Merged = std::move(Pollys[0]);
+  return is_all_closed;
+} /* End of 'polygon::MergeAll' function */
 
-      // Sort all intersections by length
-      std::sort(current_pnt_inters.begin(), current_pnt_inters.end(),
-                [&](size_t A, size_t B) -> BOOL
-                {
-                  vec2
-                    CurrA = location::PointsPool[A] - location::PointsPool[curr_pnt_ind],
-                    CurrB = location::PointsPool[B] - location::PointsPool[curr_pnt_ind];
-                  return CurrA.Length() < CurrB.Length();
-                });
-
-      // Add all segmetns as possible edjes of new polygon
-      for (size_t i = 0, cnt = current_pnt_inters.size(); i < cnt; i++)
-      {
-        if (i != cnt - 1)
-        {
-          InterEdjes.emplace(current_pnt_inters[i], std::vector<size_t>());
+/* Find intersection points of polygons sides function (merge stage, points pool is not changed).
+ * ARGUMENTS:
+ *   - points pool of polygons points:
+ *       const points_pool &Pool;
+ *   - polygon to merge with:
+ *       const polygon &Polly;
+ *   - merge data to fill:
+ *       merge_data *Data;
+ * RETURNS: None.
+ */
+VOID polygon::MergeIntersect( const points_pool &Pool, const polygon &Polly, merge_data *Data ) const
+{
+  // Intersect sides of first polygon with candidate sides of second one function
+  const auto IntersectPolygons = [&](const polygon &PollyFirst, const polygon &PollySeccond,
+                                     const arena_vector<std::pair<size_t, size_t>> &Candidates, size_t FirstSide)
+  {
+    arena_vector<FLT> x0(&Data->Arena), y0(&Data->Arena), x1(&Data->Arena), y1(&Data->Arena); // Candidate segments of current segment (structure of arrays)
+    arena_vector<FLT> rx(&Data->Arena), ry(&Data->Arena);                                     // Intersection points
+    arena_vector<UINT32> hits(&Data->Arena);
+    size_t candidate = 0;
 
-          if (std::find(InterEdjes[current_pnt_inters[i]].begin(),
-                        InterEdjes[current_pnt_inters[i]].end(),
-                        current_pnt_inters[i + 1]) == InterEdjes[current_pnt_inters[i]].end())
-            InterEdjes[current_pnt_inters[i]].push_back(current_pnt_inters[i + 1]);
-        }
+    for (size_t i = 0, cnt = PollyFirst.Lines.size(); i < cnt; i++)
+    {
+      // Gather candidate segments of another polly
+      x0.clear(), y0.clear(), x1.clear(), y1.clear();
+      for (; candidate < Candidates.size() && Candidates[candidate].first == i; candidate++)
+      {
+        const segment &seg_to_inter = PollySeccond.Lines[Candidates[candidate].second];
+        vec2 p0 = Pool.At(seg_to_inter.St), p1 = Pool.At(seg_to_inter.End);
 
-        if (i != 0 && std::find(InterEdjes[current_pnt_inters[i]].begin(),
-                                InterEdjes[current_pnt_inters[i]].end(),
-                                current_pnt_inters[i - 1]) == InterEdjes[current_pnt_inters[i]].end())
-          InterEdjes[current_pnt_inters[i]].push_back(current_pnt_inters[i - 1]);
+        x0.push_back(p0[0]), y0.push_back(p0[1]), x1.push_back(p1[0]), y1.push_back(p1[1]);
       }
+      if (x0.empty())
+        continue;
+
+      // Get all intersection with another polly, candidates are checked as lines by 'segment::Intersect'
+      vec2 st = Pool.At(PollyFirst.Lines[i].St), end = Pool.At(PollyFirst.Lines[i].End);
+      size_t inter_cnt = x0.size();
 
-      prev_pnt_inters = current_pnt_inters;
+      rx.resize(inter_cnt), ry.resize(inter_cnt), hits.resize((inter_cnt + 31) / 32);
+      if (simd::IntersectSegments(st[0], st[1], end[0], end[1], TRUE,
+                                  x0.data(), y0.data(), x1.data(), y1.data(), inter_cnt, hits.data(), rx.data(), ry.data()) != 0)
+      {
+        Data->IsIntersection = TRUE;
+        for (size_t j = 0; j < inter_cnt; j++)
+          if (hits[j / 32] & (1u << (j % 32)))
+            Data->Sides.push_back(FirstSide + i), Data->X.push_back(rx[j]), Data->Y.push_back(ry[j]);
+      }
     }
   };
 
-  // Fillign possible edjes list for new polygon
-  IntersectPolygons(*this, Polly);
-  IntersectPolygons(Polly, *this);
+  // Only segments with overlapping bounding boxes can intersect
+  arena_vector<std::pair<size_t, size_t>> candidates(&Data->Arena), candidates_swapped(&Data->Arena);
+  GetOverlappingSegments(Pool, Polly, &candidates);
+  candidates_swapped.reserve(candidates.size());
+  for (const auto &pair : candidates)
+    candidates_swapped.push_back({pair.second, pair.first});
+  std::sort(candidates_swapped.begin(), candidates_swapped.end());
+
+  IntersectPolygons(*this, Polly, candidates, 0);
+  IntersectPolygons(Polly, *this, candidates_swapped, Lines.size());
+} /* End of 'polygon::MergeIntersect' function */
+
+/* Add intersection points to points pool function (merge stage).
+ * ARGUMENTS:
+ *   - points pool to add points to:
+ *       points_pool &Pool;
+ *   - merge data:
+ *       merge_data *Data;
+ * RETURNS: None.
+ */
+VOID polygon::MergeAddPoints( points_pool &Pool, merge_data *Data )
+{
+  Data->Points.resize(Data->X.size());
+  for (size_t i = 0; i < Data->X.size(); i++)
+    Data->Points[i] = Pool.Add(vec2(Data->X[i], Data->Y[i]));
+} /* End of 'polygon::MergeAddPoints' function */
+
+/* Build merged polygon by intersection points function (merge stage, points pool is not changed).
+ * ARGUMENTS:
+ *   - points pool of polygons points:
+ *       const points_pool &Pool;
+ *   - polygon to merge with:
+ *       const polygon &Polly;
+ *   - merge data (its arena is used for scratch memory):
+ *       merge_data *Data;
+ *   - polygon to set merged one in:
+ *       polygon *Merged;
+ * RETURNS:
+ *   (BOOL) TRUE if merged outline is closed, FALSE if some its walk did not come back to start point.
+ */
+BOOL polygon::MergeBuild( const points_pool &Pool, const polygon &Polly, merge_data *Data, polygon *Merged ) const
+{
+  arena *scratch = &Data->Arena;
 
   // Check if no intersections. Check all 3 cases:
   //   - first contains second; - return first
   //   - second contains first; - return second
   //   - first near second;     - return both
-  if (!IsIntersection)
+  if (!Data->IsIntersection)
   {
     // Check if first polly inside second
-    BOOL IsInside = TRUE;
+    if (Data->Prepared == nullptr || &Data->Prepared->GetPool() != &Pool)
+      Data->Prepared.reset(new prepared_polygon(Pool));
+    prepared_polygon &prepared = *Data->Prepared;
+    arena_vector<vec2> pnts(scratch);
+    arena_vector<BYTE> is_inside(mth::Max(Lines.size(), Polly.Lines.size()), FALSE, scratch);
+
+    pnts.reserve(is_inside.size());
     for (const segment &seg : Lines)
-      if (!Polly.IsPointInside(location::PointsPool[seg.St]))
-      {
-        IsInside = FALSE;
-        break;
-      }
-    if (IsInside)
+      pnts.push_back(Pool.At(seg.St));
+    prepared.Build(Polly);
+    if (prepared.IsPointInside(pnts.data(), pnts.size(), is_inside.data()) == pnts.size())
     {
       *Merged = Polly;
-      return;
+      return TRUE;
     }
 
     // Check if second contains first
-    IsInside = TRUE;
+    pnts.clear();
     for (const segment &seg : Polly.Lines)
-      if (!IsPointInside(location::PointsPool[seg.St]))
-      {
-        IsInside = FALSE;
-        break;
-      }
-    if (IsInside)
+      pnts.push_back(Pool.At(seg.St));
+    prepared.Build(*this);
+    if (prepared.IsPointInside(pnts.data(), pnts.size(), is_inside.data()) == pnts.size())
     {
       *Merged = *this;
-      return;
+      return TRUE;
     }
 
     // First is near second. Create merged polygon just by adding segments from second to first.
-    polygon merged(*this);
-    for (const segment &seg : Polly.Lines)
-      merged.Lines.push_back(seg);
-    *Merged = merged;
-    return;
+    polygon merged;
+    merged.Lines.reserve(Lines.size() + Polly.Lines.size());
+    merged.Lines.insert(merged.Lines.end(), Lines.begin(), Lines.end());
+    merged.Lines.insert(merged.Lines.end(), Polly.Lines.begin(), Polly.Lines.end());
+    *Merged = std::move(merged);
+    return TRUE;
   }
 
-  // Find minimum point in two polygons to start merging from
-  vec2 first_pnt(INFINITY);
-  size_t first_pnt_ind = 0;
+  arena_vector<std::pair<size_t, size_t>> InterEdjes(scratch); // Edjes (in both directions) with start and end in polygons segments intersection points
+  arena_vector<size_t> current_pnt_inters(scratch);
+  size_t inter = 0;
+
+  // Arena memory is not reused by growing vectors, so known sizes are reserved
+  InterEdjes.reserve((Lines.size() + Polly.Lines.size() + Data->Points.size()) * 2);
+
+  // Sides of both polygons are split by their intersection points to possible edjes of new polygon
+  for (size_t side = 0, sides_cnt = Lines.size() + Polly.Lines.size(); side < sides_cnt; side++)
+  {
+    const segment &seg = side < Lines.size() ? Lines[side] : Polly.Lines[side - Lines.size()];
+    size_t next_pnt_ind = seg.End;
+    size_t curr_pnt_ind = seg.St;
+
+    current_pnt_inters.clear();
+    current_pnt_inters.push_back(next_pnt_ind);
+    current_pnt_inters.push_back(curr_pnt_ind);
+    for (; inter < Data->Sides.size() && Data->Sides[inter] == side; inter++)
+      current_pnt_inters.push_back(Data->Points[inter]);
 
-  for (const segment &seg : Lines)
-    if (first_pnt > location::PointsPool[seg.St])
-      first_pnt = location::PointsPool[seg.St], first_pnt_ind = seg.St;
+    // Sort all intersections by length and drop repeated ones
+    vec2 curr_pnt = Pool.At(curr_pnt_ind);
+    std::sort(current_pnt_inters.begin(), current_pnt_inters.end(),
+              [&](size_t A, size_t B) -> BOOL
+              {
+                FLT
+                  LenA = (Pool.At(A) - curr_pnt).Length2(),
+                  LenB = (Pool.At(B) - curr_pnt).Length2();
+                return LenA < LenB || (LenA == LenB && A < B);
+              });
+    current_pnt_inters.erase(std::unique(current_pnt_inters.begin(), current_pnt_inters.end()), current_pnt_inters.end());
 
-  for (const segment &seg : Polly.Lines)
-    if (first_pnt > location::PointsPool[seg.St])
-      first_pnt = location::PointsPool[seg.St], first_pnt_ind = seg.St;
+    for (size_t i = 1, cnt = current_pnt_inters.size(); i < cnt; i++)
+    {
+      InterEdjes.push_back({current_pnt_inters[i - 1], current_pnt_inters[i]});
+      InterEdjes.push_back({current_pnt_inters[i], current_pnt_inters[i - 1]});
+    }
+  }
 
   // Find the most left point and add new segment to merged polygon with end in that point
   // polygon merged;
@@ -151,7 +276,7 @@ VOID polygon::Merge(const polygon &Polly, polygon *Merged) const
   // do
   // {
   //   auto curr_vertex = InterEdjes.find(curr_pnt_ind);
-  //   vec2 curr_pnt = location::PointsPool[curr_pnt_ind];
+  //   vec2 curr_pnt = Pool[curr_pnt_ind];
   // 
   //   DBL max_angle = 0;
   //   size_t max_angle_ind = curr_vertex->second[0];
@@ -161,7 +286,7 @@ VOID polygon::Merge(const polygon &Polly, polygon *Merged) const
   //     if (visits[curr_vertex->second[i]])
   //       continue;
   // 
-  //     vec2 next_pnt = location::PointsPool[curr_vertex->second[i]];
+  //     vec2 next_pnt = Pool[curr_vertex->second[i]];
   //     DBL angle = acos(curr_pnt.Normalizing() & next_pnt.Normalizing());
   // 
   //     vec3 cross = (vec3(curr_pnt, 0) % vec3(next_pnt, 0));
@@ -177,48 +302,469 @@ VOID polygon::Merge(const polygon &Polly, polygon *Merged) const
   //   curr_pnt_ind = max_angle_ind;
   // } while (curr_pnt_ind != first_pnt_ind);
 
-  // Find the most left point and add new segment to merged polygon with end in that point
+  // Compressed adjacency graph: vertices sorted by index, offsets of their neighbours, sorted unique neighbours
+  arena_vector<size_t> vertices(scratch), offsets(scratch), neighbours(scratch);
+  vertices.reserve(InterEdjes.size()), offsets.reserve(InterEdjes.size() + 1);
+
+  std::sort(InterEdjes.begin(), InterEdjes.end());
+  InterEdjes.erase(std::unique(InterEdjes.begin(), InterEdjes.end()), InterEdjes.end());
+  neighbours.reserve(InterEdjes.size());
+  for (const auto &edje : InterEdjes)
+  {
+    if (vertices.empty() || vertices.back() != edje.first)
+      vertices.push_back(edje.first), offsets.push_back(neighbours.size());
+    neighbours.push_back(edje.second);
+  }
+  offsets.push_back(neighbours.size());
+
+  // Get half of turn angle to point, counted counterclockwise from direction back:
+  // 0 - back direction, 1 - left half-plane, 2 - straight direction, 3 - right half-plane
+  const auto GetTurnHalf = []( const vec2 &Curr, const vec2 &Back, const vec2 &Pnt ) -> INT
+  {
+    DBL orient = predicates::Orient2d(Curr, Back, Pnt);
+    if (orient != 0)
+      return orient > 0 ? 1 : 3;
+
+    BOOL is_back = Back[0] != Curr[0] ?
+      (Pnt[0] > Curr[0]) == (Back[0] > Curr[0]) :
+      (Pnt[1] > Curr[1]) == (Back[1] > Curr[1]);
+    return is_back ? 0 : 2;
+  };
+
+  // Walk outer boundary keeping exterior on the left: take the leftmost turn in every point.
+  // Leftmost turn maps every directed edge to the next one one-to-one while neighbours directions differ,
+  // so walk always comes back to start. Walk can miss start only if two neighbours lie in the same direction:
+  // collinear overlapping sides, which are not split in end points of each other (intersection gives only
+  // one point for them), then it gets into a cycle not passing start point and is stopped
+  const auto WalkBoundary = [&]( size_t FirstPntInd, polygon *Boundary ) -> BOOL
+  {
+    size_t curr_pnt_ind = FirstPntInd, prev = -1;
+    do
+    {
+      size_t vertex = std::lower_bound(vertices.begin(), vertices.end(), curr_pnt_ind) - vertices.begin();
+      if (vertex == vertices.size() || vertices[vertex] != curr_pnt_ind)
+        return FALSE;
+
+      vec2
+        curr_pnt = Pool.At(curr_pnt_ind),
+        // Start point is the most left one, so walk starts as if it came from the left
+        back_pnt = prev == (size_t)-1 ? vec2(curr_pnt[0] - 1, curr_pnt[1]) : Pool.At(prev),
+        next_pnt;
+      size_t next_pnt_ind = prev; // Walk goes back from dead end
+      INT next_half = -1;
+
+      // Angles are compared by halves, then by exact orientation inside half
+      for (size_t i = offsets[vertex]; i < offsets[vertex + 1]; i++)
+      {
+        size_t ind = neighbours[i];
+        if (ind == prev || ind == curr_pnt_ind)
+          continue;
+
+        vec2 pnt = Pool.At(ind);
+        INT half = GetTurnHalf(curr_pnt, back_pnt, pnt);
+        if (half > next_half || (half == next_half && half % 2 == 1 && predicates::Orient2d(curr_pnt, next_pnt, pnt) > 0))
+          next_pnt_ind = ind, next_pnt = pnt, next_half = half;
+      }
+      if (next_pnt_ind == (size_t)-1)
+        return FALSE;
+
+      Boundary->Lines.push_back(segment(curr_pnt_ind, next_pnt_ind));
+      prev = curr_pnt_ind;
+      curr_pnt_ind = next_pnt_ind;
+
+      // Walk can not be longer than graph, stop if it got into a cycle not passing start point
+    } while (curr_pnt_ind != FirstPntInd && Boundary->Lines.size() <= neighbours.size());
+    return curr_pnt_ind == FirstPntInd;
+  };
+
+  // Lexicographical order of points
+  const auto IsLess = [&]( size_t A, size_t B ) -> BOOL
+  {
+    vec2 a = Pool.At(A), b = Pool.At(B);
+    return a[0] < b[0] || (a[0] == b[0] && (a[1] < b[1] || (a[1] == b[1] && A < B)));
+  };
+
+  // Loop is a closed chain of segments
+  const auto IsSingleLoop = []( const polygon &Polly ) -> BOOL
+  {
+    for (size_t i = 0, n = Polly.Lines.size(); i < n; i++)
+      if (Polly.Lines[i].End != Polly.Lines[(i + 1) % n].St)
+        return FALSE;
+    return TRUE;
+  };
+
+  // Find the most left point of every graph component.
+  // Intersecting loops give connected graph, so components are searched only for polygons with several loops
+  arena_vector<size_t> starts(scratch), stack(scratch);
+  if (IsSingleLoop(*this) && IsSingleLoop(Polly))
+    starts.push_back(*std::min_element(vertices.begin(), vertices.end(), IsLess));
+  else
+  {
+    arena_vector<BYTE> is_visited(vertices.size(), 0, scratch);
+    for (size_t first = 0; first < vertices.size(); first++)
+    {
+      if (is_visited[first])
+        continue;
+
+      size_t start = vertices[first];
+      is_visited[first] = TRUE;
+      stack.push_back(first);
+      while (!stack.empty())
+      {
+        size_t vertex = stack.back();
+        stack.pop_back();
+        if (IsLess(vertices[vertex], start))
+          start = vertices[vertex];
+        for (size_t i = offsets[vertex]; i < offsets[vertex + 1]; i++)
+        {
+          size_t neighbour = std::lower_bound(vertices.begin(), vertices.end(), neighbours[i]) - vertices.begin();
+          if (neighbour < vertices.size() && vertices[neighbour] == neighbours[i] && !is_visited[neighbour])
+            is_visited[neighbour] = TRUE, stack.push_back(neighbour);
+        }
+      }
+      starts.push_back(start);
+    }
+  }
+
+  // Merged polygon is outer boundaries of all graph components, which are not inside other ones.
+  // All boundaries are walked first (from left to right), then components inside other ones are dropped
+  std::sort(starts.begin(), starts.end(), IsLess);
   polygon merged;
-  size_t curr_pnt_ind = first_pnt_ind, prev = -1;
-  do
-  {
-    auto curr_vertex = InterEdjes.find(curr_pnt_ind);
-    size_t next_pnt_ind = curr_vertex->second[0];
-    vec2
-      curr_pnt = location::PointsPool[curr_pnt_ind],
-      next_pnt = location::PointsPool[next_pnt_ind];
-
-    for (size_t i = 1, cnt = curr_vertex->second.size(); i < cnt; i++)
-      if ((curr_vertex->second[i] != prev && curr_vertex->second[i] != next_pnt_ind && curr_vertex->second[i] != curr_pnt_ind &&
-          segment(curr_pnt_ind, next_pnt_ind).GetPointHalfPlaneLocation(location::PointsPool[curr_vertex->second[i]]) == 1) || next_pnt_ind == prev)
+  arena_vector<size_t> bounds(scratch); // Lines ranges of components boundaries in merged polygon
+  bounds.reserve(starts.size() + 1);
+  BOOL is_closed = TRUE;
+  for (size_t start : starts)
+  {
+    bounds.push_back(merged.Lines.size());
+    is_closed = WalkBoundary(start, &merged) && is_closed;
+  }
+  bounds.push_back(merged.Lines.size());
+
+  if (starts.size() > 1)
+  {
+    // Components nesting is found by one sweep line going up over boundaries lines. Start point is the most left
+    // one of its component, so the nearest boundary line to the left of it belongs to another component.
+    // Boundaries do not cross, so if start is on interior side of that line, component is inside line one,
+    // otherwise it is inside only if line component is inside some other one
+    size_t lines_cnt = merged.Lines.size();
+    const auto GetLower = [&]( size_t Line ) -> vec2
+    {
+      vec2 st = Pool.At(merged.Lines[Line].St), end = Pool.At(merged.Lines[Line].End);
+      return st[1] < end[1] ? st : end;
+    };
+    const auto GetUpper = [&]( size_t Line ) -> vec2
+    {
+      vec2 st = Pool.At(merged.Lines[Line].St), end = Pool.At(merged.Lines[Line].End);
+      return st[1] < end[1] ? end : st;
+    };
+    // Get side of point relative to line going up: positive if point is on the left
+    const auto GetSide = [&]( size_t Line, const vec2 &Pnt ) -> DBL
+    {
+      return predicates::Orient2d(GetLower(Line), GetUpper(Line), Pnt);
+    };
+
+    // Lines crossing sweep line are ordered from left to right, indexes after lines are start points.
+    // Lines are compared by lower point of line starting later (lines without order are the same line walked twice)
+    const auto IsLeft = [&]( size_t A, size_t B ) -> BOOL
+    {
+      if (A >= lines_cnt)
+        return GetSide(B, Pool.At(starts[A - lines_cnt])) > 0;
+      if (B >= lines_cnt)
+        return GetSide(A, Pool.At(starts[B - lines_cnt])) < 0;
+
+      BOOL is_later = GetLower(A)[1] >= GetLower(B)[1];
+      size_t line = is_later ? B : A, other = is_later ? A : B;
+      DBL side = GetSide(line, GetLower(other));
+      if (side == 0)
+        side = GetSide(line, GetUpper(other));
+      if (side == 0)
+        return A < B;
+      return is_later ? side > 0 : side < 0;
+    };
+    using active_set = std::set<size_t, decltype(IsLeft), arena_allocator<size_t>>;
+    active_set active(IsLeft, arena_allocator<size_t>(scratch));
+    arena_vector<active_set::iterator> positions(lines_cnt, active.end(), scratch);
+
+    // Horizontal lines never cross horizontal ray, other ones are sorted by their lower and upper points
+    arena_vector<size_t> ups(scratch), downs(scratch), queries(scratch);
+    ups.reserve(lines_cnt), downs.reserve(lines_cnt), queries.reserve(starts.size());
+    for (size_t line = 0; line < lines_cnt; line++)
+      if (Pool.At(merged.Lines[line].St)[1] != Pool.At(merged.Lines[line].End)[1])
+        ups.push_back(line), downs.push_back(line);
+    for (size_t i = 0; i < starts.size(); i++)
+      queries.push_back(i);
+    std::sort(ups.begin(), ups.end(), [&]( size_t A, size_t B ) { return GetLower(A)[1] < GetLower(B)[1]; });
+    std::sort(downs.begin(), downs.end(), [&]( size_t A, size_t B ) { return GetUpper(A)[1] < GetUpper(B)[1]; });
+    std::sort(queries.begin(), queries.end(), [&]( size_t A, size_t B ) { return Pool.At(starts[A])[1] < Pool.At(starts[B])[1]; });
+
+    // Nearest line to the left of every start point: its component (-1 if there is no line) and
+    // whether start is on interior side of it. Boundary keeps exterior on the left, so start is inside
+    // line going up, but not inside line walked in both directions (its copy is next to it on sweep line)
+    arena_vector<size_t> hits(starts.size(), -1, scratch);
+    arena_vector<BYTE> is_interior(starts.size(), FALSE, scratch);
+    size_t up = 0, down = 0;
+    for (size_t query : queries)
+    {
+      // Lines are on sweep line by half-open Y range, lines ending are removed before new ones added
+      FLT y = Pool.At(starts[query])[1];
+      for (; up < ups.size() && GetLower(ups[up])[1] <= y; up++)
       {
-        next_pnt = location::PointsPool[curr_vertex->second[i]];
-        next_pnt_ind = curr_vertex->second[i];
-        i = 0;
+        for (; down < downs.size() && GetUpper(downs[down])[1] <= GetLower(ups[up])[1]; down++)
+          active.erase(positions[downs[down]]);
+        positions[ups[up]] = active.insert(ups[up]).first;
       }
+      for (; down < downs.size() && GetUpper(downs[down])[1] <= y; down++)
+        active.erase(positions[downs[down]]);
 
-    merged.Lines.push_back(segment(curr_pnt_ind, next_pnt_ind));
-    prev = curr_pnt_ind;
-    curr_pnt_ind = next_pnt_ind;
-  } while (curr_pnt_ind != first_pnt_ind);
+      auto nearest = active.lower_bound(lines_cnt + query);
+      if (nearest == active.begin())
+        continue;
 
-  *Merged = merged;
-} /* End of 'polygon::Merge' function */
+      const segment &seg = merged.Lines[*--nearest];
+      BOOL is_twice = FALSE;
+      if (nearest != active.begin())
+      {
+        const segment &copy = merged.Lines[*std::prev(nearest)];
+        is_twice = copy.St == seg.End && copy.End == seg.St;
+      }
+      hits[query] = std::upper_bound(bounds.begin(), bounds.end(), *nearest) - bounds.begin() - 1;
+      is_interior[query] = !is_twice && Pool.At(seg.St)[1] < Pool.At(seg.End)[1];
+    }
+
+    // Components to the left of start go before it
+    arena_vector<BYTE> is_nested(starts.size(), FALSE, scratch);
+    for (size_t i = 0; i < starts.size(); i++)
+      if (hits[i] != (size_t)-1)
+        is_nested[i] = is_interior[i] || is_nested[hits[i]];
+
+    // Lines of components, which are not inside other ones, are moved to the beginning of merged polygon
+    size_t kept_cnt = 0;
+    for (size_t i = 0; i < starts.size(); i++)
+      if (!is_nested[i])
+        for (size_t line = bounds[i]; line < bounds[i + 1]; line++)
+          merged.Lines[kept_cnt++] = merged.Lines[line];
+    merged.Lines.resize(kept_cnt);
+  }
+
+  *Merged = std::move(merged);
+  return is_closed;
+} /* End of 'polygon::MergeBuild' function */
+
+/* Find segments pairs of two polygons with overlapping bounding boxes by sweep line function.
+ * Sweep line goes by x, segments crossed by it are kept ordered by y (unless there are only a few of them),
+ * so every query visits only y-overlapping segments: O((n + k) log n) for n segments and k pairs,
+ * even if all x ranges overlap.
+ * ARGUMENTS:
+ *   - points pool of polygons points:
+ *       const points_pool &Pool;
+ *   - polygon to find overlapping segments with:
+ *       const polygon &Polly;
+ *   - pairs of segments indexes (this polygon segment, another polygon segment) container,
+ *     sorted by first index, then by second (its arena is used for scratch memory):
+ *       arena_vector<std::pair<size_t, size_t>> *Pairs;
+ * RETURNS: None.
+ */
+VOID polygon::GetOverlappingSegments( const points_pool &Pool, const polygon &Polly, arena_vector<std::pair<size_t, size_t>> *Pairs ) const
+{
+  arena *scratch = Pairs->get_allocator().Arena;
+
+  const DBL margin = 0.0001; // Boxes margin, covers intersection point rounding
+  size_t n = Lines.size(), cnt = n + Polly.Lines.size();
+
+  // Segments bounding boxes, segments of this polygon go first
+  arena_vector<DBL> min_x(cnt, 0, scratch), max_x(cnt, 0, scratch), min_y(cnt, 0, scratch), max_y(cnt, 0, scratch);
+  for (size_t i = 0; i < cnt; i++)
+  {
+    const segment &seg = i < n ? Lines[i] : Polly.Lines[i - n];
+    vec2 st = Pool.At(seg.St), end = Pool.At(seg.End);
+
+    min_x[i] = mth::Min(st[0], end[0]) - margin, max_x[i] = mth::Max(st[0], end[0]) + margin;
+    min_y[i] = mth::Min(st[1], end[1]) - margin, max_y[i] = mth::Max(st[1], end[1]) + margin;
+  }
+
+  // Sweep line events are boxes left sides
+  arena_vector<size_t> order(cnt, 0, scratch);
+  for (size_t i = 0; i < cnt; i++)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&]( size_t A, size_t B )
+            {
+              return min_x[A] < min_x[B];
+            });
+
+  // Segments crossed by sweep line for each polygon are kept in list while it is short: y checks of a few
+  // segments are cheaper than tree query. Long list goes to tree: buckets of all polygon segments sorted by
+  // bottom side with tree over them (segment tree layout), which keeps the highest top of active segments
+  // in every node. Query goes down only to nodes with active segments reaching its bottom and starting below
+  // its top, so it does not visit segments far by y. Segments passed by line are removed when query meets them
+  const size_t list_max = 64, bucket_size = 16;
+  size_t first[3] = {0, n, cnt}, size[2] = {0, 0};
+  arena_vector<size_t> lists[2] {arena_vector<size_t>(scratch), arena_vector<size_t>(scratch)};
+  arena_vector<DBL> trees[2] {arena_vector<DBL>(scratch), arena_vector<DBL>(scratch)};
+  arena_vector<DBL> bottoms(scratch), tops(scratch), rights(scratch); // Segments sides by rank
+  arena_vector<size_t> segs(scratch), rank(scratch);
+
+  // Update tree by changed top sides of bucket segments function
+  const auto UpdateBucket = [&]( INT Polly, size_t Bucket )
+  {
+    arena_vector<DBL> &tree = trees[Polly];
+    size_t st = first[Polly] + Bucket * bucket_size, end = mth::Min(st + bucket_size, first[Polly + 1]);
+    DBL top = -INFINITY;
+
+    for (size_t i = st; i < end; i++)
+      top = mth::Max(top, tops[i]);
+    for (size_t node = size[Polly] + Bucket; node > 0 && tree[node] != top; node /= 2)
+    {
+      tree[node] = top;
+      if (node > 1)
+        top = mth::Max(top, tree[node ^ 1]);
+    }
+  };
+
+  // Move active segments of polygon from list to tree function
+  const auto BuildTree = [&]( INT Polly )
+  {
+    if (rank.empty())
+      bottoms.resize(cnt), tops.resize(cnt), rights.resize(cnt), segs.resize(cnt), rank.resize(cnt);
+
+    arena_vector<std::pair<DBL, size_t>> by_bottom(scratch);
+    by_bottom.reserve(first[Polly + 1] - first[Polly]);
+    for (size_t seg = first[Polly]; seg < first[Polly + 1]; seg++)
+      by_bottom.push_back({min_y[seg], seg});
+    std::sort(by_bottom.begin(), by_bottom.end());
+    for (size_t i = first[Polly]; i < first[Polly + 1]; i++)
+    {
+      size_t seg = by_bottom[i - first[Polly]].second;
+
+      bottoms[i] = min_y[seg], tops[i] = -INFINITY, rights[i] = max_x[seg], segs[i] = seg, rank[seg] = i;
+    }
+    for (size_t seg : lists[Polly])
+      tops[rank[seg]] = max_y[seg];
+    lists[Polly].clear();
+
+    size_t buckets = (first[Polly + 1] - first[Polly] + bucket_size - 1) / bucket_size;
+    for (size[Polly] = 1; size[Polly] < buckets; size[Polly] *= 2)
+      ;
+    trees[Polly].resize(size[Polly] * 2, -INFINITY);
+    for (size_t bucket = 0; bucket < buckets; bucket++)
+      UpdateBucket(Polly, bucket);
+  };
+
+  // Tree node to visit: node index, first bucket and buckets count
+  struct visit
+  {
+    size_t Node, First, Count;
+  };
+  arena_vector<visit> stack(scratch);
+
+  Pairs->clear();
+  for (size_t seg : order)
+  {
+    INT polly = seg < n ? 0 : 1, other_polly = 1 - polly;
+    DBL bottom = min_y[seg], top = max_y[seg];
+
+    // Report pair of segment with another polygon one function
+    const auto Report = [&]( size_t Other )
+    {
+      Pairs->push_back(polly == 0 ? std::make_pair(seg, Other - n) : std::make_pair(Other, seg - n));
+    };
+
+    // List is cleared from passed segments by query, it goes to tree if it is still long
+    if (size[other_polly] == 0)
+    {
+      arena_vector<size_t> &others = lists[other_polly];
+
+      for (size_t i = 0; i < others.size();)
+      {
+        size_t other = others[i];
+
+        if (max_x[other] < min_x[seg])
+        {
+          others[i] = others.back();
+          others.pop_back();
+          continue;
+        }
+        if (bottom <= max_y[other] && min_y[other] <= top)
+          Report(other);
+        i++;
+      }
+      if (others.size() > list_max)
+        BuildTree(other_polly);
+    }
+    else
+    {
+      const arena_vector<DBL> &tree = trees[other_polly];
+      size_t other_first = first[other_polly], other_end = first[other_polly + 1];
+
+      stack.push_back({1, 0, size[other_polly]});
+      while (!stack.empty())
+      {
+        visit v = stack.back();
+        size_t st = other_first + v.First * bucket_size;
+
+        stack.pop_back();
+        if (tree[v.Node] < bottom || st >= other_end || bottoms[st] > top)
+          continue;
+        if (v.Count > 1)
+        {
+          stack.push_back({v.Node * 2 + 1, v.First + v.Count / 2, v.Count / 2});
+          stack.push_back({v.Node * 2, v.First, v.Count / 2});
+          continue;
+        }
+
+        BOOL is_removed = FALSE;
+        for (size_t i = st, end = mth::Min(st + bucket_size, other_end); i < end && bottoms[i] <= top; i++)
+          if (tops[i] >= bottom)
+          {
+            if (rights[i] < min_x[seg])
+              tops[i] = -INFINITY, is_removed = TRUE;
+            else
+              Report(segs[i]);
+          }
+        if (is_removed)
+          UpdateBucket(other_polly, v.First);
+      }
+    }
+
+    if (size[polly] == 0)
+      lists[polly].push_back(seg);
+    else
+    {
+      tops[rank[seg]] = top;
+      UpdateBucket(polly, (rank[seg] - first[polly]) / bucket_size);
+    }
+  }
+  std::sort(Pairs->begin(), Pairs->end());
+} /* End of 'polygon::GetOverlappingSegments' function */
 
 /* Check if point inside polygon.
  * ARGUMENTS:
+ *   - points pool of polygon points:
+ *       const points_pool &Pool;
  *   - point to check:
  *       const vec3 &Pnt;
  * RETURNS:
  *   (BOOL) whether point in polygon or not.
  */
-BOOL polygon::IsPointInside(const vec2 &Pnt) const
+BOOL polygon::IsPointInside( const points_pool &Pool, const vec2 &Pnt ) const
 {
-  INT cnt = 0;
+  const size_t BlockSize = 64;
   vec2 PntInfLine = Pnt + vec2(10000000, 0);
+  FLT x0[BlockSize], y0[BlockSize], x1[BlockSize], y1[BlockSize]; // Block segments points as structure of arrays
+  UINT32 hits[BlockSize / 32];
+  size_t cnt = 0;
 
-  for (const segment &seg : Lines)
-    cnt += seg.Intersect(Pnt, PntInfLine);
+  // Ray is checked as line against blocks of polygon segments, coordinates are streamed from pool through stack
+  for (size_t block = 0; block < Lines.size(); block += BlockSize)
+  {
+    size_t n = mth::Min(BlockSize, Lines.size() - block);
+
+    for (size_t i = 0; i < n; i++)
+    {
+      vec2 st = Pool.At(Lines[block + i].St), end = Pool.At(Lines[block + i].End);
 
+      x0[i] = st[0], y0[i] = st[1], x1[i] = end[0], y1[i] = end[1];
+    }
+    cnt += simd::IntersectSegments(Pnt[0], Pnt[1], PntInfLine[0], PntInfLine[1], FALSE, x0, y0, x1, y1, n, hits);
+  }
   return cnt % 2 != 0;
 } /* End of 'polygon::IsPointInside' function */
\ No newline at end of file
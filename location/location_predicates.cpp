@@ -0,0 +1,475 @@
+#include "location_predicates.h"
+
+/*
+ * Exact expansion arithmetic (J. R. Shewchuk, "Adaptive Precision Floating-Point
+ * Arithmetic and Fast Robust Geometric Predicates"). Expansion is an array of
+ * nonoverlapping DBL components, ordered by increasing magnitude, which sum is exact value.
+ * Code relies on IEEE round-to-nearest DBL arithmetic without extended precision and
+ * without fused multiply-add contraction.
+ */
+
+static const DBL
+  Epsilon = 1.1102230246251565e-16,                            // DBL rounding unit (2^-53)
+  Splitter = 134217729.0,                                       // 2^27 + 1, splits DBL into two halves
+  ResultErrBound = (3.0 + 8.0 * Epsilon) * Epsilon,             // Rounding error bound of result
+  OrientErrBoundB = (2.0 + 12.0 * Epsilon) * Epsilon,           // Orientation error bounds
+  OrientErrBoundC = (9.0 + 64.0 * Epsilon) * Epsilon * Epsilon,
+  InCircleErrBoundB = (4.0 + 48.0 * Epsilon) * Epsilon;         // In circle error bound
+
+/* Sum two numbers, which first one is not less by magnitude, exactly function.
+ * ARGUMENTS:
+ *   - numbers:
+ *       DBL A, DBL B;
+ *   - sum and its rounding error:
+ *       DBL *X, DBL *Y;
+ * RETURNS: None.
+ */
+static inline VOID FastTwoSum( DBL A, DBL B, DBL *X, DBL *Y )
+{
+  *X = A + B;
+  *Y = B - (*X - A);
+} /* End of 'FastTwoSum' function */
+
+/* Sum two numbers exactly function.
+ * ARGUMENTS:
+ *   - numbers:
+ *       DBL A, DBL B;
+ *   - sum and its rounding error:
+ *       DBL *X, DBL *Y;
+ * RETURNS: None.
+ */
+static inline VOID TwoSum( DBL A, DBL B, DBL *X, DBL *Y )
+{
+  DBL x = A + B, b_virt = x - A, a_virt = x - b_virt;
+
+  *X = x;
+  *Y = (A - a_virt) + (B - b_virt);
+} /* End of 'TwoSum' function */
+
+/* Get rounding error of two numbers difference function.
+ * ARGUMENTS:
+ *   - numbers:
+ *       DBL A, DBL B;
+ *   - rounded difference:
+ *       DBL X;
+ * RETURNS:
+ *   (DBL) difference rounding error.
+ */
+static inline DBL TwoDiffTail( DBL A, DBL B, DBL X )
+{
+  DBL b_virt = A - X, a_virt = X + b_virt;
+
+  return (A - a_virt) + (b_virt - B);
+} /* End of 'TwoDiffTail' function */
+
+/* Subtract two numbers exactly function.
+ * ARGUMENTS:
+ *   - numbers:
+ *       DBL A, DBL B;
+ *   - difference and its rounding error:
+ *       DBL *X, DBL *Y;
+ * RETURNS: None.
+ */
+static inline VOID TwoDiff( DBL A, DBL B, DBL *X, DBL *Y )
+{
+  *X = A - B;
+  *Y = TwoDiffTail(A, B, *X);
+} /* End of 'TwoDiff' function */
+
+/* Split number into two halves of 26 bits function.
+ * ARGUMENTS:
+ *   - number:
+ *       DBL A;
+ *   - high and low halves:
+ *       DBL *Hi, DBL *Lo;
+ * RETURNS: None.
+ */
+static inline VOID Split( DBL A, DBL *Hi, DBL *Lo )
+{
+  DBL c = Splitter * A, a_big = c - A;
+
+  *Hi = c - a_big;
+  *Lo = A - *Hi;
+} /* End of 'Split' function */
+
+/* Multiply two numbers exactly, second one is already split, function.
+ * ARGUMENTS:
+ *   - numbers:
+ *       DBL A, DBL B;
+ *   - second number halves:
+ *       DBL BHi, DBL BLo;
+ *   - product and its rounding error:
+ *       DBL *X, DBL *Y;
+ * RETURNS: None.
+ */
+static inline VOID TwoProductPresplit( DBL A, DBL B, DBL BHi, DBL BLo, DBL *X, DBL *Y )
+{
+  DBL a_hi, a_lo;
+
+  *X = A * B;
+  Split(A, &a_hi, &a_lo);
+  DBL
+    err1 = *X - a_hi * BHi,
+    err2 = err1 - a_lo * BHi,
+    err3 = err2 - a_hi * BLo;
+  *Y = a_lo * BLo - err3;
+} /* End of 'TwoProductPresplit' function */
+
+/* Multiply two numbers exactly function.
+ * ARGUMENTS:
+ *   - numbers:
+ *       DBL A, DBL B;
+ *   - product and its rounding error:
+ *       DBL *X, DBL *Y;
+ * RETURNS: None.
+ */
+static inline VOID TwoProduct( DBL A, DBL B, DBL *X, DBL *Y )
+{
+  DBL b_hi, b_lo;
+
+  Split(B, &b_hi, &b_lo);
+  TwoProductPresplit(A, B, b_hi, b_lo, X, Y);
+} /* End of 'TwoProduct' function */
+
+/* Get exact difference of two products A * B - C * D function.
+ * ARGUMENTS:
+ *   - numbers:
+ *       DBL A, DBL B, DBL C, DBL D;
+ *   - four components expansion of difference:
+ *       DBL *X;
+ * RETURNS: None.
+ */
+static inline VOID TwoTwoProductDiff( DBL A, DBL B, DBL C, DBL D, DBL *X )
+{
+  DBL a1, a0, b1, b0, i, j, k;
+
+  TwoProduct(A, B, &a1, &a0);
+  TwoProduct(C, D, &b1, &b0);
+
+  // (a1, a0) - b0
+  TwoDiff(a0, b0, &i, &X[0]);
+  TwoSum(a1, i, &j, &k);
+  // (j, k) - b1
+  TwoDiff(k, b1, &i, &X[1]);
+  TwoSum(j, i, &X[3], &X[2]);
+} /* End of 'TwoTwoProductDiff' function */
+
+/* Sum two expansions, dropping zero components, function.
+ * ARGUMENTS:
+ *   - expansions:
+ *       INT ELen, const DBL *E, INT FLen, const DBL *F;
+ *   - result expansion (up to ELen + FLen components):
+ *       DBL *H;
+ * RETURNS:
+ *   (INT) result expansion length.
+ */
+static INT ExpansionSum( INT ELen, const DBL *E, INT FLen, const DBL *F, DBL *H )
+{
+  INT e_ind = 0, f_ind = 0, h_ind = 0;
+  DBL q, q_new, hh;
+
+  // Components are merged by increasing magnitude
+  const auto TakeSmaller = [&]( VOID ) -> DBL
+  {
+    if (f_ind >= FLen || (e_ind < ELen && (F[f_ind] > E[e_ind]) == (F[f_ind] > -E[e_ind])))
+      return E[e_ind++];
+    return F[f_ind++];
+  };
+
+  q = TakeSmaller();
+  if (e_ind < ELen && f_ind < FLen)
+  {
+    FastTwoSum(TakeSmaller(), q, &q_new, &hh);
+    q = q_new;
+    if (hh != 0)
+      H[h_ind++] = hh;
+  }
+  while (e_ind < ELen || f_ind < FLen)
+  {
+    TwoSum(q, TakeSmaller(), &q_new, &hh);
+    q = q_new;
+    if (hh != 0)
+      H[h_ind++] = hh;
+  }
+  if (q != 0 || h_ind == 0)
+    H[h_ind++] = q;
+  return h_ind;
+} /* End of 'ExpansionSum' function */
+
+/* Scale expansion by number, dropping zero components, function.
+ * ARGUMENTS:
+ *   - expansion:
+ *       INT ELen, const DBL *E;
+ *   - number to scale by:
+ *       DBL B;
+ *   - result expansion (up to 2 * ELen components):
+ *       DBL *H;
+ * RETURNS:
+ *   (INT) result expansion length.
+ */
+static INT ScaleExpansion( INT ELen, const DBL *E, DBL B, DBL *H )
+{
+  INT h_ind = 0;
+  DBL b_hi, b_lo, q, hh, product1, product0, sum;
+
+  Split(B, &b_hi, &b_lo);
+  TwoProductPresplit(E[0], B, b_hi, b_lo, &q, &hh);
+  if (hh != 0)
+    H[h_ind++] = hh;
+  for (INT i = 1; i < ELen; i++)
+  {
+    TwoProductPresplit(E[i], B, b_hi, b_lo, &product1, &product0);
+    TwoSum(q, product0, &sum, &hh);
+    if (hh != 0)
+      H[h_ind++] = hh;
+    FastTwoSum(product1, sum, &q, &hh);
+    if (hh != 0)
+      H[h_ind++] = hh;
+  }
+  if (q != 0 || h_ind == 0)
+    H[h_ind++] = q;
+  return h_ind;
+} /* End of 'ScaleExpansion' function */
+
+/* Get approximate expansion value function.
+ * ARGUMENTS:
+ *   - expansion:
+ *       INT ELen, const DBL *E;
+ * RETURNS:
+ *   (DBL) expansion components sum.
+ */
+static DBL Estimate( INT ELen, const DBL *E )
+{
+  DBL q = E[0];
+
+  for (INT i = 1; i < ELen; i++)
+    q += E[i];
+  return q;
+} /* End of 'Estimate' function */
+
+/* Get lifted determinant term S * ((A * A + B * B) * Det) expansion function.
+ * ARGUMENTS:
+ *   - 2x2 determinant expansion:
+ *       INT DetLen, const DBL *Det;
+ *   - lifted point coordinates:
+ *       DBL A, DBL B;
+ *   - result expansion (up to 16 * DetLen components):
+ *       DBL *H;
+ * RETURNS:
+ *   (INT) result expansion length.
+ */
+static INT LiftExpansion( INT DetLen, const DBL *Det, DBL A, DBL B, DBL *H )
+{
+  DBL xa[24], xxa[48], yb[24], yyb[48];
+  INT
+    xa_len = ScaleExpansion(DetLen, Det, A, xa),
+    xxa_len = ScaleExpansion(xa_len, xa, A, xxa),
+    yb_len = ScaleExpansion(DetLen, Det, B, yb),
+    yyb_len = ScaleExpansion(yb_len, yb, B, yyb);
+
+  return ExpansionSum(xxa_len, xxa, yyb_len, yyb, H);
+} /* End of 'LiftExpansion' function */
+
+/* Get orientation of three points with adaptive precision function.
+ * ARGUMENTS:
+ *   - points:
+ *       DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy;
+ *   - sum of orientation determinant terms absolute values:
+ *       DBL DetSum;
+ * RETURNS:
+ *   (DBL) orientation determinant approximation with exact sign.
+ */
+DBL predicates::Orient2dAdapt( DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy, DBL DetSum )
+{
+  DBL
+    acx = Ax - Cx, bcx = Bx - Cx,
+    acy = Ay - Cy, bcy = By - Cy,
+    b[4], u[4], c1[8], c2[12], d[16];
+  DBL
+    acx_tail = TwoDiffTail(Ax, Cx, acx), bcx_tail = TwoDiffTail(Bx, Cx, bcx),
+    acy_tail = TwoDiffTail(Ay, Cy, acy), bcy_tail = TwoDiffTail(By, Cy, bcy);
+  BOOL is_diff_exact = acx_tail == 0 && acy_tail == 0 && bcx_tail == 0 && bcy_tail == 0;
+
+  // Differences of FLT coordinates are usually exact and short, so both products are exact
+  // and their rounded difference has exact sign (common for collinear points on grids)
+  if (is_diff_exact)
+  {
+    DBL hi, acx_lo, bcx_lo, acy_lo, bcy_lo;
+
+    Split(acx, &hi, &acx_lo);
+    Split(bcx, &hi, &bcx_lo);
+    Split(acy, &hi, &acy_lo);
+    Split(bcy, &hi, &bcy_lo);
+    if (acx_lo == 0 && bcx_lo == 0 && acy_lo == 0 && bcy_lo == 0)
+      return acx * bcy - acy * bcx;
+  }
+
+  // Exact determinant of rounded differences
+  TwoTwoProductDiff(acx, bcy, acy, bcx, b);
+  DBL det = Estimate(4, b), err_bound = OrientErrBoundB * DetSum;
+  if (det >= err_bound || -det >= err_bound)
+    return det;
+
+  if (is_diff_exact)
+    return det;
+
+  // First order correction by differences rounding errors
+  err_bound = OrientErrBoundC * DetSum + ResultErrBound * fabs(det);
+  det += (acx * bcy_tail + bcy * acx_tail) - (acy * bcx_tail + bcx * acy_tail);
+  if (det >= err_bound || -det >= err_bound)
+    return det;
+
+  // Exact determinant
+  TwoTwoProductDiff(acx_tail, bcy, acy_tail, bcx, u);
+  INT c1_len = ExpansionSum(4, b, 4, u, c1);
+  TwoTwoProductDiff(acx, bcy_tail, acy, bcx_tail, u);
+  INT c2_len = ExpansionSum(c1_len, c1, 4, u, c2);
+  TwoTwoProductDiff(acx_tail, bcy_tail, acy_tail, bcx_tail, u);
+  INT d_len = ExpansionSum(c2_len, c2, 4, u, d);
+
+  return d[d_len - 1];
+} /* End of 'predicates::Orient2dAdapt' function */
+
+/* Check if point is inside circle with exact arithmetic function.
+ * ARGUMENTS:
+ *   - circle points:
+ *       DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy;
+ *   - point to check:
+ *       DBL Dx, DBL Dy;
+ * RETURNS:
+ *   (DBL) determinant approximation with exact sign.
+ */
+static DBL InCircleExact( DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy, DBL Dx, DBL Dy )
+{
+  DBL
+    ab[4], bc[4], cd[4], da[4], ac[4], bd[4], temp8[8],
+    abc[12], bcd[12], cda[12], dab[12],
+    adet[96], bdet[96], cdet[96], ddet[96], abdet[192], cddet[192], deter[384];
+
+  // Exact 2x2 minors of raw coordinates
+  TwoTwoProductDiff(Ax, By, Bx, Ay, ab);
+  TwoTwoProductDiff(Bx, Cy, Cx, By, bc);
+  TwoTwoProductDiff(Cx, Dy, Dx, Cy, cd);
+  TwoTwoProductDiff(Dx, Ay, Ax, Dy, da);
+  TwoTwoProductDiff(Ax, Cy, Cx, Ay, ac);
+  TwoTwoProductDiff(Bx, Dy, Dx, By, bd);
+
+  // 3x3 minors
+  INT temp_len = ExpansionSum(4, cd, 4, da, temp8);
+  INT cda_len = ExpansionSum(temp_len, temp8, 4, ac, cda);
+  temp_len = ExpansionSum(4, da, 4, ab, temp8);
+  INT dab_len = ExpansionSum(temp_len, temp8, 4, bd, dab);
+  for (INT i = 0; i < 4; i++)
+    bd[i] = -bd[i], ac[i] = -ac[i];
+  temp_len = ExpansionSum(4, ab, 4, bc, temp8);
+  INT abc_len = ExpansionSum(temp_len, temp8, 4, ac, abc);
+  temp_len = ExpansionSum(4, bc, 4, cd, temp8);
+  INT bcd_len = ExpansionSum(temp_len, temp8, 4, bd, bcd);
+
+  // Lifted determinant
+  INT
+    a_len = LiftExpansion(bcd_len, bcd, Ax, Ay, adet),
+    b_len = LiftExpansion(cda_len, cda, Bx, By, bdet),
+    c_len = LiftExpansion(dab_len, dab, Cx, Cy, cdet),
+    d_len = LiftExpansion(abc_len, abc, Dx, Dy, ddet);
+  for (INT i = 0; i < b_len; i++)
+    bdet[i] = -bdet[i];
+  for (INT i = 0; i < d_len; i++)
+    ddet[i] = -ddet[i];
+
+  INT
+    ab_len = ExpansionSum(a_len, adet, b_len, bdet, abdet),
+    cd_len = ExpansionSum(c_len, cdet, d_len, ddet, cddet),
+    deter_len = ExpansionSum(ab_len, abdet, cd_len, cddet, deter);
+  return deter[deter_len - 1];
+} /* End of 'InCircleExact' function */
+
+/* Check if point is inside circle with adaptive precision function.
+ * ARGUMENTS:
+ *   - circle points:
+ *       DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy;
+ *   - point to check:
+ *       DBL Dx, DBL Dy;
+ *   - sum of determinant terms absolute values:
+ *       DBL Permanent;
+ * RETURNS:
+ *   (DBL) determinant approximation with exact sign.
+ */
+DBL predicates::InCircleAdapt( DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy, DBL Dx, DBL Dy, DBL Permanent )
+{
+  DBL
+    adx = Ax - Dx, bdx = Bx - Dx, cdx = Cx - Dx,
+    ady = Ay - Dy, bdy = By - Dy, cdy = Cy - Dy,
+    bc[4], ca[4], ab[4], adet[64], bdet[64], cdet[64], abdet[128], fin[192];
+
+  // Exact determinant of rounded differences
+  TwoTwoProductDiff(bdx, cdy, cdx, bdy, bc);
+  TwoTwoProductDiff(cdx, ady, adx, cdy, ca);
+  TwoTwoProductDiff(adx, bdy, bdx, ady, ab);
+  INT
+    a_len = LiftExpansion(4, bc, adx, ady, adet),
+    b_len = LiftExpansion(4, ca, bdx, bdy, bdet),
+    c_len = LiftExpansion(4, ab, cdx, cdy, cdet),
+    ab_len = ExpansionSum(a_len, adet, b_len, bdet, abdet),
+    fin_len = ExpansionSum(ab_len, abdet, c_len, cdet, fin);
+
+  DBL det = Estimate(fin_len, fin), err_bound = InCircleErrBoundB * Permanent;
+  if (det >= err_bound || -det >= err_bound)
+    return det;
+
+  // Determinant is exact if all differences are
+  if (TwoDiffTail(Ax, Dx, adx) == 0 && TwoDiffTail(Ay, Dy, ady) == 0 &&
+      TwoDiffTail(Bx, Dx, bdx) == 0 && TwoDiffTail(By, Dy, bdy) == 0 &&
+      TwoDiffTail(Cx, Dx, cdx) == 0 && TwoDiffTail(Cy, Dy, cdy) == 0)
+    return fin[fin_len - 1];
+
+  return InCircleExact(Ax, Ay, Bx, By, Cx, Cy, Dx, Dy);
+} /* End of 'predicates::InCircleAdapt' function */
+
+/* Intersect segment with line segment function.
+ * Pairs are classified by exact orientations: segments intersect if they cross or touch.
+ * Collinear segments intersect only if segment start matches one of line points.
+ * ARGUMENTS:
+ *   - segment points:
+ *       const vec2 &St, const vec2 &End;
+ *   - line segment points:
+ *       const vec2 &P0, const vec2 &P1;
+ *   - variable to set intersection point in (may be nullptr):
+ *       vec2 *Result;
+ * RETURNS:
+ *   (BOOL) whether segments intersect.
+ */
+BOOL predicates::Intersect( const vec2 &St, const vec2 &End, const vec2 &P0, const vec2 &P1, vec2 *Result )
+{
+  const auto Sign = []( DBL X ) -> INT
+  {
+    return X > 0 ? 1 : X < 0 ? -1 : 0;
+  };
+  INT
+    o_st = Sign(Orient2d(P0, P1, St)), o_end = Sign(Orient2d(P0, P1, End)),
+    o_p0 = Sign(Orient2d(St, End, P0)), o_p1 = Sign(Orient2d(St, End, P1));
+
+  // Collinear segments
+  if (o_st == 0 && o_end == 0)
+  {
+    if (!((St[0] == P0[0] && St[1] == P0[1]) || (St[0] == P1[0] && St[1] == P1[1])))
+      return FALSE;
+    if (Result != nullptr)
+      *Result = St;
+    return TRUE;
+  }
+
+  // Some segment lies on one side of another
+  if (o_st * o_end > 0 || o_p0 * o_p1 > 0)
+    return FALSE;
+
+  if (Result != nullptr)
+    // Touching point is exact, crossing point is computed
+    *Result =
+      o_st == 0 ? St :
+      o_end == 0 ? End :
+      o_p0 == 0 ? P0 :
+      o_p1 == 0 ? P1 :
+      GetCrossing(St[0], St[1], End[0], End[1], P0[0], P0[1], P1[0], P1[1]);
+  return TRUE;
+} /* End of 'predicates::Intersect' function */
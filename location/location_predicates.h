@@ -0,0 +1,185 @@
+#ifndef __location_predicates_h_
+#define __location_predicates_h_
+
+#include "../def.h"
+
+/* Robust geometric predicates class.
+ * Predicates are Shewchuk's adaptive precision ones: result is computed in DBL first and
+ * returned if its sign is guaranteed by floating point error bound, otherwise it is refined
+ * with exact expansion arithmetic. So signs are always exact, and only nearly degenerate
+ * inputs pay for exact arithmetic.
+ */
+class predicates
+{
+private:
+  static constexpr DBL
+    Epsilon = 1.1102230246251565e-16,                     // DBL rounding unit (2^-53)
+    OrientErrBoundA = (3.0 + 16.0 * Epsilon) * Epsilon,   // Orientation filter error bound factor
+    InCircleErrBoundA = (10.0 + 96.0 * Epsilon) * Epsilon; // In circle filter error bound factor
+
+  /* Get orientation of three points with adaptive precision function.
+   * ARGUMENTS:
+   *   - points:
+   *       DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy;
+   *   - sum of orientation determinant terms absolute values:
+   *       DBL DetSum;
+   * RETURNS:
+   *   (DBL) orientation determinant approximation with exact sign.
+   */
+  static DBL Orient2dAdapt( DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy, DBL DetSum );
+
+  /* Check if point is inside circle with adaptive precision function.
+   * ARGUMENTS:
+   *   - circle points:
+   *       DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy;
+   *   - point to check:
+   *       DBL Dx, DBL Dy;
+   *   - sum of determinant terms absolute values:
+   *       DBL Permanent;
+   * RETURNS:
+   *   (DBL) determinant approximation with exact sign.
+   */
+  static DBL InCircleAdapt( DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy, DBL Dx, DBL Dy, DBL Permanent );
+
+public:
+  /* Get orientation of three points function.
+   * ARGUMENTS:
+   *   - points:
+   *       DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy;
+   * RETURNS:
+   *   (DBL) positive for counterclockwise, negative for clockwise, zero for collinear points
+   *         (approximately doubled signed area of triangle).
+   */
+  static DBL Orient2d( DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy )
+  {
+    DBL
+      det_left = (Ax - Cx) * (By - Cy),
+      det_right = (Ay - Cy) * (Bx - Cx),
+      det = det_left - det_right,
+      det_sum = fabs(det_left) + fabs(det_right);
+
+    // Terms of different signs can not cancel each other, so bound is never hit for them
+    if (fabs(det) >= OrientErrBoundA * det_sum)
+      return det;
+    return Orient2dAdapt(Ax, Ay, Bx, By, Cx, Cy, det_sum);
+  } /* End of 'Orient2d' function */
+
+  /* Get orientation error bound for points inside box function.
+   * ARGUMENTS:
+   *   - box maximal side:
+   *       DBL Extent;
+   * RETURNS:
+   *   (DBL) error bound to pass to 'Orient2d'.
+   */
+  static DBL GetOrientBound( DBL Extent )
+  {
+    // Both determinant terms are at most squared extent
+    return OrientErrBoundA * 2 * Extent * Extent * (1 + 8 * Epsilon);
+  } /* End of 'GetOrientBound' function */
+
+  /* Get orientation of three points with precomputed error bound function.
+   * Determinant is computed once and returned if it is out of bound, so points sets with
+   * known extent (see 'GetOrientBound') skip per call filter.
+   * ARGUMENTS:
+   *   - points:
+   *       DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy;
+   *   - error bound of points box:
+   *       DBL Bound;
+   * RETURNS:
+   *   (DBL) positive for counterclockwise, negative for clockwise, zero for collinear points.
+   */
+  static DBL Orient2d( DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy, DBL Bound )
+  {
+    DBL det = (Ax - Cx) * (By - Cy) - (Ay - Cy) * (Bx - Cx);
+
+    if (det > Bound || det < -Bound)
+      return det;
+    return Orient2d(Ax, Ay, Bx, By, Cx, Cy);
+  } /* End of 'Orient2d' function */
+
+  /* Get orientation of three points function.
+   * ARGUMENTS:
+   *   - points:
+   *       const vec2 &A, const vec2 &B, const vec2 &C;
+   * RETURNS:
+   *   (DBL) positive for counterclockwise, negative for clockwise, zero for collinear points.
+   */
+  static DBL Orient2d( const vec2 &A, const vec2 &B, const vec2 &C )
+  {
+    return Orient2d(A[0], A[1], B[0], B[1], C[0], C[1]);
+  } /* End of 'Orient2d' function */
+
+  /* Check if point is inside circle of counterclockwise triangle function.
+   * ARGUMENTS:
+   *   - triangle points:
+   *       DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy;
+   *   - point to check:
+   *       DBL Dx, DBL Dy;
+   * RETURNS:
+   *   (DBL) positive if point is inside circle, negative if outside, zero if on circle.
+   */
+  static DBL InCircle( DBL Ax, DBL Ay, DBL Bx, DBL By, DBL Cx, DBL Cy, DBL Dx, DBL Dy )
+  {
+    DBL
+      adx = Ax - Dx, ady = Ay - Dy,
+      bdx = Bx - Dx, bdy = By - Dy,
+      cdx = Cx - Dx, cdy = Cy - Dy,
+      bdxcdy = bdx * cdy, cdxbdy = cdx * bdy, alift = adx * adx + ady * ady,
+      cdxady = cdx * ady, adxcdy = adx * cdy, blift = bdx * bdx + bdy * bdy,
+      adxbdy = adx * bdy, bdxady = bdx * ady, clift = cdx * cdx + cdy * cdy,
+      det =
+        alift * (bdxcdy - cdxbdy) +
+        blift * (cdxady - adxcdy) +
+        clift * (adxbdy - bdxady),
+      permanent =
+        (fabs(bdxcdy) + fabs(cdxbdy)) * alift +
+        (fabs(cdxady) + fabs(adxcdy)) * blift +
+        (fabs(adxbdy) + fabs(bdxady)) * clift,
+      err_bound = InCircleErrBoundA * permanent;
+
+    if (det > err_bound || -det > err_bound)
+      return det;
+    return InCircleAdapt(Ax, Ay, Bx, By, Cx, Cy, Dx, Dy, permanent);
+  } /* End of 'InCircle' function */
+
+  /* Intersect segment with line segment function.
+   * Pairs are classified by exact orientations: segments intersect if they cross or touch.
+   * Collinear segments intersect only if segment start matches one of line points.
+   * ARGUMENTS:
+   *   - segment points:
+   *       const vec2 &St, const vec2 &End;
+   *   - line segment points:
+   *       const vec2 &P0, const vec2 &P1;
+   *   - variable to set intersection point in (may be nullptr):
+   *       vec2 *Result;
+   * RETURNS:
+   *   (BOOL) whether segments intersect.
+   */
+  static BOOL Intersect( const vec2 &St, const vec2 &End, const vec2 &P0, const vec2 &P1, vec2 *Result );
+
+  /* Get crossing point of segment and line segment function.
+   * Point is computed in FLT along line segment, parameter is clamped to it.
+   * ARGUMENTS:
+   *   - segment points:
+   *       FLT Sx0, FLT Sy0, FLT Sx1, FLT Sy1;
+   *   - line segment points:
+   *       FLT Lx0, FLT Ly0, FLT Lx1, FLT Ly1;
+   * RETURNS:
+   *   (vec2) crossing point.
+   */
+  static vec2 GetCrossing( FLT Sx0, FLT Sy0, FLT Sx1, FLT Sy1, FLT Lx0, FLT Ly0, FLT Lx1, FLT Ly1 )
+  {
+    FLT
+      a = Lx0 - Lx1, b = Sy0 - Sy1, c = Ly0 - Ly1, d = Sx0 - Sx1,
+      e = Lx0 - Sx0, f = Ly0 - Sy0,
+      div = a * b - c * d,
+      t = (e * b - f * d) / div;
+
+    // Nearly parallel lines may give any (even NAN) parameter
+    t = t > 0 ? t : 0;
+    t = t < 1 ? t : 1;
+    return vec2(Lx0 + (Lx1 - Lx0) * t, Ly0 + (Ly1 - Ly0) * t);
+  } /* End of 'GetCrossing' function */
+}; /* end of 'predicates' class */
+
+#endif /* __location_predicates_h_ */
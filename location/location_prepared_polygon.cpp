@@ -0,0 +1,181 @@
+#include <algorithm>
+
+#include "location.h"
+
+/* Prepared polygon constructor.
+ * ARGUMENTS:
+ *   - points pool to take polygon points from:
+ *       const points_pool &Pool;
+ */
+prepared_polygon::prepared_polygon( const points_pool &Pool ) :
+  Pool(Pool), MinX(0), MinY(0), MaxX(-1), MaxY(-1), OrientBound(0), BandHeight(1), BandsCount(1), BandsOffsets {0, 0}
+{
+} /* End of 'prepared_polygon::prepared_polygon' function */
+
+/* Build polygon bands function.
+ * ARGUMENTS:
+ *   - polygon to prepare:
+ *       const polygon &Polly;
+ * RETURNS: None.
+ */
+VOID prepared_polygon::Build( const polygon &Polly )
+{
+  const FLT *pool_x = Pool.GetX(), *pool_y = Pool.GetY();
+
+  MinX = MinY = INFINITY, MaxX = MaxY = -INFINITY;
+  for (const segment &seg : Polly.Lines)
+  {
+    MinX = mth::Min(MinX, mth::Min(pool_x[seg.St], pool_x[seg.End]));
+    MaxX = mth::Max(MaxX, mth::Max(pool_x[seg.St], pool_x[seg.End]));
+    MinY = mth::Min(MinY, mth::Min(pool_y[seg.St], pool_y[seg.End]));
+    MaxY = mth::Max(MaxY, mth::Max(pool_y[seg.St], pool_y[seg.End]));
+  }
+  OrientBound = predicates::GetOrientBound(mth::Max((DBL)MaxX - MinX, (DBL)MaxY - MinY));
+
+  // Horizontal edges never cross horizontal ray
+  INT edges_cnt = 0;
+  for (const segment &seg : Polly.Lines)
+    edges_cnt += pool_y[seg.St] != pool_y[seg.End];
+
+  // About one edge per band, but long edges should not be copied to too many bands
+  BandsCount = mth::Max(edges_cnt, 1);
+  for (;;)
+  {
+    BandHeight = (MaxY - MinY) / BandsCount;
+    if (BandsCount == 1 || !(BandHeight > 0))
+    {
+      BandsCount = 1, BandHeight = 1;
+      break;
+    }
+
+    size_t entries_cnt = 0;
+    for (const segment &seg : Polly.Lines)
+      if (pool_y[seg.St] != pool_y[seg.End])
+        entries_cnt += std::abs(GetBand(pool_y[seg.End]) - GetBand(pool_y[seg.St])) + 1;
+    if (entries_cnt <= (size_t)edges_cnt * 4)
+      break;
+    BandsCount /= 2;
+  }
+
+  // Counting sort of edges by bands
+  BandsOffsets.assign(BandsCount + 1, 0);
+  for (const segment &seg : Polly.Lines)
+    if (pool_y[seg.St] != pool_y[seg.End])
+    {
+      INT
+        first = GetBand(mth::Min(pool_y[seg.St], pool_y[seg.End])),
+        last = GetBand(mth::Max(pool_y[seg.St], pool_y[seg.End]));
+
+      for (INT band = first; band <= last; band++)
+        BandsOffsets[band + 1]++;
+    }
+  for (INT band = 0; band < BandsCount; band++)
+    BandsOffsets[band + 1] += BandsOffsets[band];
+
+  Fill.assign(BandsOffsets.begin(), BandsOffsets.end() - 1);
+  X0.resize(BandsOffsets.back()), Y0.resize(BandsOffsets.back());
+  X1.resize(BandsOffsets.back()), Y1.resize(BandsOffsets.back());
+  for (const segment &seg : Polly.Lines)
+    if (pool_y[seg.St] != pool_y[seg.End])
+    {
+      // Edges go upwards, so point left of edge means edge crosses ray
+      size_t lower = seg.St, upper = seg.End;
+      if (pool_y[lower] > pool_y[upper])
+        std::swap(lower, upper);
+
+      for (INT band = GetBand(pool_y[lower]), last = GetBand(pool_y[upper]); band <= last; band++)
+      {
+        INT i = Fill[band]++;
+
+        X0[i] = pool_x[lower], Y0[i] = pool_y[lower];
+        X1[i] = pool_x[upper], Y1[i] = pool_y[upper];
+      }
+    }
+} /* End of 'prepared_polygon::Build' function */
+
+/* Check if point is inside polygon by edges of its band function.
+ * ARGUMENTS:
+ *   - point to check (inside bounding box):
+ *       FLT Px, FLT Py;
+ *   - point band:
+ *       INT Band;
+ * RETURNS:
+ *   (BOOL) whether point in polygon or not.
+ */
+BOOL prepared_polygon::IsPointInsideBand( FLT Px, FLT Py, INT Band ) const
+{
+  BOOL is_inside = FALSE;
+
+  // Ray goes to the right, edges are half-open by Y to count shared vertices once
+  for (INT i = BandsOffsets[Band], end = BandsOffsets[Band + 1]; i < end; i++)
+    if (Y0[i] <= Py && Py < Y1[i])
+    {
+      if (X0[i] > Px && X1[i] > Px)
+        is_inside = !is_inside;
+      else if ((X0[i] >= Px || X1[i] >= Px) &&
+               predicates::Orient2d(X0[i], Y0[i], X1[i], Y1[i], Px, Py, OrientBound) > 0)
+        is_inside = !is_inside;
+    }
+  return is_inside;
+} /* End of 'prepared_polygon::IsPointInsideBand' function */
+
+/* Check if point inside polygon function.
+ * ARGUMENTS:
+ *   - point to check:
+ *       const vec2 &Pnt;
+ * RETURNS:
+ *   (BOOL) whether point in polygon or not.
+ */
+BOOL prepared_polygon::IsPointInside( const vec2 &Pnt ) const
+{
+  if (!(Pnt[0] >= MinX && Pnt[0] <= MaxX && Pnt[1] >= MinY && Pnt[1] <= MaxY))
+    return FALSE;
+  return IsPointInsideBand(Pnt[0], Pnt[1], GetBand(Pnt[1]));
+} /* End of 'prepared_polygon::IsPointInside' function */
+
+/* Check if points inside polygon function.
+ * Points are processed band by band, so every band edges are read once.
+ * ARGUMENTS:
+ *   - points to check:
+ *       const vec2 *Pnts;
+ *   - points count:
+ *       size_t Count;
+ *   - containment flags for every point (array of points count size):
+ *       BYTE *IsInside;
+ * RETURNS:
+ *   (size_t) count of points in polygon.
+ */
+size_t prepared_polygon::IsPointInside( const vec2 *Pnts, size_t Count, BYTE *IsInside )
+{
+  INT n = (INT)Count;
+  const auto IsInBox = [&]( const vec2 &Pnt ) -> BOOL
+  {
+    return Pnt[0] >= MinX && Pnt[0] <= MaxX && Pnt[1] >= MinY && Pnt[1] <= MaxY;
+  };
+
+  // Counting sort of points in bounding box by bands
+  QueriesOffsets.assign(BandsCount + 1, 0);
+  for (INT i = 0; i < n; i++)
+    if (IsInBox(Pnts[i]))
+      QueriesOffsets[GetBand(Pnts[i][1]) + 1]++;
+  for (INT band = 0; band < BandsCount; band++)
+    QueriesOffsets[band + 1] += QueriesOffsets[band];
+
+  QueriesOrder.resize(QueriesOffsets.back());
+  Fill.assign(QueriesOffsets.begin(), QueriesOffsets.end() - 1);
+  for (INT i = 0; i < n; i++)
+    if (IsInBox(Pnts[i]))
+      QueriesOrder[Fill[GetBand(Pnts[i][1])]++] = i;
+
+  size_t inside_cnt = 0;
+  std::fill(IsInside, IsInside + n, FALSE);
+  for (INT band = 0; band < BandsCount; band++)
+    for (INT i = QueriesOffsets[band]; i < QueriesOffsets[band + 1]; i++)
+    {
+      const vec2 &pnt = Pnts[QueriesOrder[i]];
+
+      if (IsPointInsideBand(pnt[0], pnt[1], band))
+        IsInside[QueriesOrder[i]] = TRUE, inside_cnt++;
+    }
+  return inside_cnt;
+} /* End of 'prepared_polygon::IsPointInside' function */
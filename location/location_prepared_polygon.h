@@ -0,0 +1,128 @@
+#ifndef __location_prepared_polygon_h_
+#define __location_prepared_polygon_h_
+
+#include "location_points_pool.h"
+#include "location_predicates.h"
+
+class polygon;
+
+/* Prepared polygon for repeated point containment queries class.
+ * Polygon edges are bucketed into horizontal bands by their Y ranges, so query
+ * checks only edges of one band instead of all polygon lines. Edges of every band are
+ * stored contiguously as structure of arrays, lower end first. Containment follows
+ * half-open crossing rule with exact orientations, points on border may be reported either way.
+ * Working buffers are reused between polygons.
+ */
+class prepared_polygon
+{
+private:
+  const points_pool &Pool; // Points pool to take polygon points from
+
+  // Polygon bounding box
+  FLT MinX, MinY, MaxX, MaxY;
+  DBL OrientBound; // Orientation error bound of bounding box
+
+  // Bands edges (bands are stored in one array by offsets)
+  FLT BandHeight;
+  INT BandsCount;
+  std::vector<INT> BandsOffsets;
+  std::vector<FLT> X0, Y0, X1, Y1;
+
+  // Batch queries sorted by bands
+  std::vector<INT> QueriesOffsets, QueriesOrder;
+  std::vector<INT> Fill; // Counting sort positions of bands
+
+  /* Get band of coordinate function.
+   * ARGUMENTS:
+   *   - coordinate:
+   *       FLT Y;
+   * RETURNS:
+   *   (INT) band index.
+   */
+  INT GetBand( FLT Y ) const
+  {
+    return mth::Clamp((INT)((Y - MinY) / BandHeight), 0, BandsCount - 1);
+  } /* End of 'GetBand' function */
+
+  /* Check if point is inside polygon by edges of its band function.
+   * ARGUMENTS:
+   *   - point to check (inside bounding box):
+   *       FLT Px, FLT Py;
+   *   - point band:
+   *       INT Band;
+   * RETURNS:
+   *   (BOOL) whether point in polygon or not.
+   */
+  BOOL IsPointInsideBand( FLT Px, FLT Py, INT Band ) const;
+
+public:
+  /* Prepared polygon constructor.
+   * ARGUMENTS:
+   *   - points pool to take polygon points from:
+   *       const points_pool &Pool;
+   */
+  prepared_polygon( const points_pool &Pool );
+
+  /* Get points pool of polygon points function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (const points_pool &) points pool.
+   */
+  const points_pool & GetPool( VOID ) const
+  {
+    return Pool;
+  } /* End of 'GetPool' function */
+
+  /* Get polygon bounding box minimum function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (vec2) bounding box minimum.
+   */
+  vec2 GetMin( VOID ) const
+  {
+    return vec2(MinX, MinY);
+  } /* End of 'GetMin' function */
+
+  /* Get polygon bounding box maximum function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (vec2) bounding box maximum.
+   */
+  vec2 GetMax( VOID ) const
+  {
+    return vec2(MaxX, MaxY);
+  } /* End of 'GetMax' function */
+
+  /* Build polygon bands function.
+   * ARGUMENTS:
+   *   - polygon to prepare:
+   *       const polygon &Polly;
+   * RETURNS: None.
+   */
+  VOID Build( const polygon &Polly );
+
+  /* Check if point inside polygon function.
+   * ARGUMENTS:
+   *   - point to check:
+   *       const vec2 &Pnt;
+   * RETURNS:
+   *   (BOOL) whether point in polygon or not.
+   */
+  BOOL IsPointInside( const vec2 &Pnt ) const;
+
+  /* Check if points inside polygon function.
+   * Points are processed band by band, so every band edges are read once.
+   * ARGUMENTS:
+   *   - points to check:
+   *       const vec2 *Pnts;
+   *   - points count:
+   *       size_t Count;
+   *   - containment flags for every point (array of points count size):
+   *       BYTE *IsInside;
+   * RETURNS:
+   *   (size_t) count of points in polygon.
+   */
+  size_t IsPointInside( const vec2 *Pnts, size_t Count, BYTE *IsInside );
+}; /* end of 'prepared_polygon' class */
+
+#endif /* __location_prepared_polygon_h_ */
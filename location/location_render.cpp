@@ -0,0 +1,288 @@
+#include "location_render.h"
+
+/* Renderer destructor. */
+location_render::~location_render( VOID )
+{
+  if (DeleteBuffers != nullptr)
+  {
+    if (Lines.Id != 0)
+      DeleteBuffers(1, &Lines.Id);
+    if (Circles.Id != 0)
+      DeleteBuffers(1, &Circles.Id);
+  }
+} /* End of 'location_render::~location_render' function */
+
+/* Load buffer objects functions function.
+ * ARGUMENTS: None.
+ * RETURNS: None.
+ */
+VOID location_render::Init( VOID )
+{
+  IsInited = TRUE;
+
+  GenBuffers = (gen_buffers)glutGetProcAddress("glGenBuffers");
+  DeleteBuffers = (delete_buffers)glutGetProcAddress("glDeleteBuffers");
+  BindBuffer = (bind_buffer)glutGetProcAddress("glBindBuffer");
+  BufferData = (buffer_data)glutGetProcAddress("glBufferData");
+  BufferSubData = (buffer_sub_data)glutGetProcAddress("glBufferSubData");
+
+  // Client arrays are used if some function is missing
+  if (GenBuffers == nullptr || DeleteBuffers == nullptr || BindBuffer == nullptr ||
+      BufferData == nullptr || BufferSubData == nullptr)
+    GenBuffers = nullptr, DeleteBuffers = nullptr;
+
+  // Unit circle
+  for (INT i = 0; i <= CircleSegments; i++)
+  {
+    DBL angle = i * 2 * mth::PI / CircleSegments;
+
+    CircleX.push_back((FLT)cos(angle));
+    CircleY.push_back((FLT)sin(angle));
+  }
+} /* End of 'location_render::Init' function */
+
+/* Upload changed buffer range function.
+ * ARGUMENTS:
+ *   - buffer:
+ *       buffer *Buf;
+ * RETURNS: None.
+ */
+VOID location_render::Upload( buffer *Buf )
+{
+  if (GenBuffers == nullptr)
+    return;
+
+  if (Buf->Id == 0)
+    GenBuffers(1, &Buf->Id);
+  BindBuffer(ArrayBuffer, Buf->Id);
+
+  // Buffer object is reallocated only when cached vertices outgrow it
+  if (Buf->Data.size() > Buf->Capacity)
+  {
+    Buf->Capacity = Buf->Data.capacity();
+    BufferData(ArrayBuffer, Buf->Capacity * sizeof(FLT), nullptr, DynamicDraw);
+    BufferSubData(ArrayBuffer, 0, Buf->Data.size() * sizeof(FLT), Buf->Data.data());
+  }
+  else if (Buf->DirtyMin != Buf->DirtyMax)
+    BufferSubData(ArrayBuffer, Buf->DirtyMin * sizeof(FLT), (Buf->DirtyMax - Buf->DirtyMin) * sizeof(FLT),
+                  Buf->Data.data() + Buf->DirtyMin);
+  Buf->DirtyMin = Buf->DirtyMax = 0;
+} /* End of 'location_render::Upload' function */
+
+/* Fill lines of polygon function.
+ * ARGUMENTS:
+ *   - points pool:
+ *       const points_pool &Pool;
+ *   - polygon:
+ *       const polygon &Polly;
+ *   - first vertex index:
+ *       size_t Start;
+ * RETURNS:
+ *   (size_t) vertices count.
+ */
+size_t location_render::FillLines( const points_pool &Pool, const polygon &Polly, size_t Start )
+{
+  size_t ind = Start * 2;
+
+  for (const segment &seg : Polly.Lines)
+  {
+    vec2 st = Pool.At(seg.St), end = Pool.At(seg.End);
+
+    Lines.Set(ind++, st[0]);
+    Lines.Set(ind++, st[1]);
+    Lines.Set(ind++, end[0]);
+    Lines.Set(ind++, end[1]);
+  }
+  return Polly.Lines.size() * 2;
+} /* End of 'location_render::FillLines' function */
+
+/* Fill circle of point function.
+ * ARGUMENTS:
+ *   - point position:
+ *       const vec2 &Pnt;
+ *   - first vertex index:
+ *       size_t Start;
+ *   - circle radius:
+ *       FLT Radius;
+ * RETURNS:
+ *   (size_t) vertices count.
+ */
+size_t location_render::FillCircle( const vec2 &Pnt, size_t Start, FLT Radius )
+{
+  size_t ind = Start * 2;
+
+  for (INT i = 0; i < CircleSegments; i++)
+  {
+    Circles.Set(ind++, Pnt[0] + Radius * CircleX[i]);
+    Circles.Set(ind++, Pnt[1] + Radius * CircleY[i]);
+    Circles.Set(ind++, Pnt[0] + Radius * CircleX[i + 1]);
+    Circles.Set(ind++, Pnt[1] + Radius * CircleY[i + 1]);
+  }
+  return CircleSegments * 2;
+} /* End of 'location_render::FillCircle' function */
+
+/* Fill circles of polygon points function.
+ * ARGUMENTS:
+ *   - points pool:
+ *       const points_pool &Pool;
+ *   - polygon:
+ *       const polygon &Polly;
+ *   - first vertex index:
+ *       size_t Start;
+ *   - circle radius:
+ *       FLT Radius;
+ * RETURNS:
+ *   (size_t) vertices count.
+ */
+size_t location_render::FillCircles( const points_pool &Pool, const polygon &Polly, size_t Start, FLT Radius )
+{
+  size_t vertex = Start;
+
+  const auto AddCircle = [&]( size_t Point )
+  {
+    // Every point is drawn once, even if it is shared by several segments (or by walls and current polygon)
+    if (PointsMarks[Point] == Fill || PointsMarks[Point] == WallsFill)
+      return;
+    PointsMarks[Point] = Fill;
+    PointsCircles[Point] = vertex;
+    vertex += FillCircle(Pool.At(Point), vertex, Radius);
+  };
+
+  for (const segment &seg : Polly.Lines)
+  {
+    AddCircle(seg.St);
+    AddCircle(seg.End);
+  }
+  return vertex - Start;
+} /* End of 'location_render::FillCircles' function */
+
+/* Fill lines and circles of all walls function.
+ * ARGUMENTS:
+ *   - points pool:
+ *       const points_pool &Pool;
+ *   - location walls:
+ *       const std::vector<polygon> &Walls;
+ *   - circle radius:
+ *       FLT Radius;
+ * RETURNS: None.
+ */
+VOID location_render::FillWalls( const points_pool &Pool, const std::vector<polygon> &Walls, FLT Radius )
+{
+  WallsFill = ++Fill;
+  WallsLines.clear();
+  WallsLinesCount = WallsCirclesCount = 0;
+  for (const polygon &wall : Walls)
+  {
+    WallsLines.push_back(WallsLinesCount);
+    WallsLinesCount += FillLines(Pool, wall, WallsLinesCount);
+    WallsCirclesCount += FillCircles(Pool, wall, WallsCirclesCount, Radius);
+  }
+} /* End of 'location_render::FillWalls' function */
+
+/* Update cached vertices by location changes function.
+ * ARGUMENTS:
+ *   - location:
+ *       const location &Loc;
+ *   - current polygon:
+ *       const polygon &CurrPoly;
+ *   - point circles radius:
+ *       FLT Radius;
+ * RETURNS: None.
+ */
+VOID location_render::Update( const location &Loc, const polygon &CurrPoly, FLT Radius )
+{
+  const points_pool &pool = Loc.GetPointsPool();
+  UINT64 generation = Loc.GetGeneration();
+
+  if (IsFilled && generation == FilledGeneration && Radius == FilledRadius)
+    return;
+
+  PointsMarks.resize(pool.Size(), 0);
+  PointsCircles.resize(pool.Size(), 0);
+
+  // Edited walls change vertices layout, so all walls are filled again.
+  // Moved points keep it: only lines of changed walls and circles of moved points are refilled
+  if (!IsFilled || Radius != FilledRadius || Loc.IsWallsEdited(FilledGeneration) || WallsLines.size() != Loc.Walls.size())
+    FillWalls(pool, Loc.Walls, Radius);
+  else
+  {
+    Loc.GetChangedWalls(FilledGeneration, &Changed);
+    for (size_t wall : Changed)
+      if (wall < Loc.Walls.size())
+        FillLines(pool, Loc.Walls[wall], WallsLines[wall]);
+
+    Loc.GetChangedPoints(FilledGeneration, &Changed);
+    for (size_t point : Changed)
+      if (point < pool.Size() && PointsMarks[point] == WallsFill)
+        FillCircle(pool.At(point), PointsCircles[point], Radius);
+  }
+
+  // Current polygon is small, it is filled on every update
+  Fill++;
+  CurrLinesCount = FillLines(pool, CurrPoly, WallsLinesCount);
+  CurrCirclesCount = FillCircles(pool, CurrPoly, WallsCirclesCount, Radius);
+
+  IsFilled = TRUE, FilledGeneration = generation, FilledRadius = Radius;
+} /* End of 'location_render::Update' function */
+
+/* Draw buffer range function.
+ * ARGUMENTS:
+ *   - buffer:
+ *       const buffer &Buf;
+ *   - first vertex and vertices count:
+ *       size_t First, size_t Count;
+ * RETURNS: None.
+ */
+VOID location_render::DrawRange( const buffer &Buf, size_t First, size_t Count )
+{
+  if (Count == 0)
+    return;
+
+  if (Buf.Id != 0)
+  {
+    BindBuffer(ArrayBuffer, Buf.Id);
+    glVertexPointer(2, GL_FLOAT, 0, nullptr);
+  }
+  else
+    glVertexPointer(2, GL_FLOAT, 0, Buf.Data.data());
+  glDrawArrays(GL_LINES, (GLint)First, (GLsizei)Count);
+} /* End of 'location_render::DrawRange' function */
+
+/* Draw location function.
+ * ARGUMENTS:
+ *   - location:
+ *       const location &Loc;
+ *   - current polygon:
+ *       const polygon &CurrPoly;
+ *   - point circles radius:
+ *       FLT Radius;
+ * RETURNS: None.
+ */
+VOID location_render::Draw( const location &Loc, const polygon &CurrPoly, FLT Radius )
+{
+  if (!IsInited)
+    Init();
+
+  // Update cached vertices
+  Update(Loc, CurrPoly, Radius);
+
+  Upload(&Lines);
+  Upload(&Circles);
+
+  // Draw
+  glEnableClientState(GL_VERTEX_ARRAY);
+
+  glColor3f(0.4f, 0.8f, 0.3f);
+  DrawRange(Lines, 0, WallsLinesCount);
+  DrawRange(Circles, 0, WallsCirclesCount);
+
+  glColor3f(0, 0, 0);
+  DrawRange(Lines, WallsLinesCount, CurrLinesCount);
+  DrawRange(Circles, WallsCirclesCount, CurrCirclesCount);
+
+  if (BindBuffer != nullptr && GenBuffers != nullptr)
+    BindBuffer(ArrayBuffer, 0);
+  glDisableClientState(GL_VERTEX_ARRAY);
+
+  Labels.Draw(Loc.GetPointsPool(), Loc.Walls, CurrPoly);
+} /* End of 'location_render::Draw' function */
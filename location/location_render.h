@@ -0,0 +1,206 @@
+#ifndef __location_render_h_
+#define __location_render_h_
+
+#include "location_labels.h"
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif /* APIENTRY */
+
+/* Location retained mode renderer class.
+ * Wall lines and point circles are kept in vertex buffers. Cached vertices are updated only if
+ * location changes generation grows: walls are filled again only if their segments are edited,
+ * otherwise lines of changed walls and circles of moved points are refilled in place.
+ * Only changed range of each buffer is uploaded.
+ * All wall lines, current polygon lines and all circles are drawn by one call each.
+ * If vertex buffer objects are not supported, cached vertices are drawn as client arrays.
+ * Points labels are drawn over geometry by labels renderer.
+ */
+class location_render
+{
+private:
+  // Vertex buffer objects functions (OpenGL 1.5)
+  typedef VOID (APIENTRY *gen_buffers)( GLsizei N, GLuint *Buffers );
+  typedef VOID (APIENTRY *delete_buffers)( GLsizei N, const GLuint *Buffers );
+  typedef VOID (APIENTRY *bind_buffer)( GLenum Target, GLuint Buffer );
+  typedef VOID (APIENTRY *buffer_data)( GLenum Target, GLsizeiptr Size, const VOID *Data, GLenum Usage );
+  typedef VOID (APIENTRY *buffer_sub_data)( GLenum Target, GLintptr Offset, GLsizeiptr Size, const VOID *Data );
+
+  static const GLenum ArrayBuffer = 0x8892; // GL_ARRAY_BUFFER
+  static const GLenum DynamicDraw = 0x88E8; // GL_DYNAMIC_DRAW
+  static const INT CircleSegments = 15;     // Lines count in point circle
+
+  gen_buffers GenBuffers = nullptr;
+  delete_buffers DeleteBuffers = nullptr;
+  bind_buffer BindBuffer = nullptr;
+  buffer_data BufferData = nullptr;
+  buffer_sub_data BufferSubData = nullptr;
+  BOOL IsInited = FALSE; // Functions were loaded flag
+
+  /* Vertex buffer with CPU side copy. */
+  struct buffer
+  {
+    GLuint Id = 0;                // Buffer object (0 if client arrays are used)
+    size_t Capacity = 0;          // Buffer object size in floats
+    std::vector<FLT> Data;        // Cached vertices (two floats per vertex)
+    size_t DirtyMin = 0, DirtyMax = 0; // Changed floats range [Min; Max)
+
+    /* Set buffer float function.
+     * ARGUMENTS:
+     *   - index of float:
+     *       size_t Index;
+     *   - value:
+     *       FLT Value;
+     * RETURNS: None.
+     */
+    VOID Set( size_t Index, FLT Value )
+    {
+      if (Index >= Data.size())
+        Data.resize(Index + 1, NAN);
+      if (Data[Index] == Value)
+        return;
+
+      Data[Index] = Value;
+      if (DirtyMin == DirtyMax)
+        DirtyMin = Index, DirtyMax = Index + 1;
+      else
+        DirtyMin = mth::Min(DirtyMin, Index), DirtyMax = mth::Max(DirtyMax, Index + 1);
+    } /* End of 'Set' function */
+  }; /* end of 'buffer' struct */
+
+  buffer Lines;   // Wall lines vertices: walls, then current polygon
+  buffer Circles; // Point circles vertices: walls points, then current polygon points
+  size_t WallsLinesCount = 0, CurrLinesCount = 0;     // Lines vertices counts
+  size_t WallsCirclesCount = 0, CurrCirclesCount = 0; // Circles vertices counts
+  std::vector<size_t> WallsLines;                     // First lines vertex of every wall
+
+  BOOL IsFilled = FALSE;           // Whether cached vertices are filled
+  UINT64 FilledGeneration = 0;     // Location changes generation cached vertices are filled for
+  FLT FilledRadius = 0;            // Point circles radius cached vertices are filled for
+  std::vector<size_t> Changed;     // Changed walls or points indexes
+
+  std::vector<size_t> PointsMarks;   // Fill number of last point circle adding (for deduplication)
+  std::vector<size_t> PointsCircles; // First circles vertex of every point with circle of walls
+  size_t Fill = 0;                   // Current fill number
+  size_t WallsFill = 0;              // Fill number of last walls filling
+  std::vector<FLT> CircleX, CircleY; // Unit circle vertices
+  location_labels Labels;            // Points labels renderer
+
+  /* Load buffer objects functions function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID Init( VOID );
+
+  /* Upload changed buffer range function.
+   * ARGUMENTS:
+   *   - buffer:
+   *       buffer *Buf;
+   * RETURNS: None.
+   */
+  VOID Upload( buffer *Buf );
+
+  /* Fill lines of polygon function.
+   * ARGUMENTS:
+   *   - points pool:
+   *       const points_pool &Pool;
+   *   - polygon:
+   *       const polygon &Polly;
+   *   - first vertex index:
+   *       size_t Start;
+   * RETURNS:
+   *   (size_t) vertices count.
+   */
+  size_t FillLines( const points_pool &Pool, const polygon &Polly, size_t Start );
+
+  /* Fill circle of point function.
+   * ARGUMENTS:
+   *   - point position:
+   *       const vec2 &Pnt;
+   *   - first vertex index:
+   *       size_t Start;
+   *   - circle radius:
+   *       FLT Radius;
+   * RETURNS:
+   *   (size_t) vertices count.
+   */
+  size_t FillCircle( const vec2 &Pnt, size_t Start, FLT Radius );
+
+  /* Fill circles of polygon points function.
+   * ARGUMENTS:
+   *   - points pool:
+   *       const points_pool &Pool;
+   *   - polygon:
+   *       const polygon &Polly;
+   *   - first vertex index:
+   *       size_t Start;
+   *   - circle radius:
+   *       FLT Radius;
+   * RETURNS:
+   *   (size_t) vertices count.
+   */
+  size_t FillCircles( const points_pool &Pool, const polygon &Polly, size_t Start, FLT Radius );
+
+  /* Fill lines and circles of all walls function.
+   * ARGUMENTS:
+   *   - points pool:
+   *       const points_pool &Pool;
+   *   - location walls:
+   *       const std::vector<polygon> &Walls;
+   *   - circle radius:
+   *       FLT Radius;
+   * RETURNS: None.
+   */
+  VOID FillWalls( const points_pool &Pool, const std::vector<polygon> &Walls, FLT Radius );
+
+  /* Update cached vertices by location changes function.
+   * ARGUMENTS:
+   *   - location:
+   *       const location &Loc;
+   *   - current polygon:
+   *       const polygon &CurrPoly;
+   *   - point circles radius:
+   *       FLT Radius;
+   * RETURNS: None.
+   */
+  VOID Update( const location &Loc, const polygon &CurrPoly, FLT Radius );
+
+  /* Draw buffer range function.
+   * ARGUMENTS:
+   *   - buffer:
+   *       const buffer &Buf;
+   *   - first vertex and vertices count:
+   *       size_t First, size_t Count;
+   * RETURNS: None.
+   */
+  VOID DrawRange( const buffer &Buf, size_t First, size_t Count );
+
+public:
+  /* Renderer destructor. */
+  ~location_render( VOID );
+
+  /* Set labels density function.
+   * ARGUMENTS:
+   *   - minimal distance between labels in pixels (0 to show all labels):
+   *       FLT Pixels;
+   * RETURNS: None.
+   */
+  VOID SetLabelsSpacing( FLT Pixels )
+  {
+    Labels.SetMinSpacing(Pixels);
+  } /* End of 'SetLabelsSpacing' function */
+
+  /* Draw location function.
+   * ARGUMENTS:
+   *   - location:
+   *       const location &Loc;
+   *   - current polygon:
+   *       const polygon &CurrPoly;
+   *   - point circles radius:
+   *       FLT Radius;
+   * RETURNS: None.
+   */
+  VOID Draw( const location &Loc, const polygon &CurrPoly, FLT Radius );
+}; /* end of 'location_render' class */
+
+#endif /* __location_render_h_ */
@@ -0,0 +1,526 @@
+#include <algorithm>
+
+#include "location_simd.h"
+#include "location_predicates.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif /* _MSC_VER */
+#endif /* x86 */
+
+// GCC and Clang compile every kernel only for its own instruction set
+#if defined(__GNUC__)
+#define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMD_TARGET_SSE2
+#define SIMD_TARGET_AVX2
+#endif /* __GNUC__ */
+
+std::atomic<INT> simd::Level(-1); // Used instruction set level (-1 if not detected yet)
+
+// Orientation sign is certain if determinant exceeds this part of its terms magnitudes sum
+// (covers FLT rounding, 2^-24 is FLT rounding unit), and this absolute value (covers underflow)
+static const FLT
+  OrientErrBound = 4.0f / 16777216.0f,
+  OrientMin = 1e-30f;
+
+/* Detect best instruction set level supported by processor and OS function.
+ * ARGUMENTS: None.
+ * RETURNS:
+ *   (INT) instruction set level.
+ */
+INT simd::Detect( VOID )
+{
+#if defined(SIMD_X86) && defined(_MSC_VER)
+  INT info[4];
+
+  __cpuid(info, 1);
+  BOOL
+    has_sse2 = (info[3] & (1 << 26)) != 0,
+    has_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+  __cpuid(info, 0);
+  if (has_avx && info[0] >= 7)
+  {
+    __cpuidex(info, 7, 0);
+    if (info[1] & (1 << 5))
+      return LevelAvx2;
+  }
+  return has_sse2 ? LevelSse2 : LevelScalar;
+#elif defined(SIMD_X86) && defined(__GNUC__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return LevelAvx2;
+  return __builtin_cpu_supports("sse2") ? LevelSse2 : LevelScalar;
+#else
+  return LevelScalar;
+#endif /* SIMD_X86 */
+} /* End of 'simd::Detect' function */
+
+/* Take point if it is nearer than current one function.
+ * ARGUMENTS:
+ *   - point squared distance and index:
+ *       FLT Dist2, UINT32 Index;
+ *   - current minimal squared distance and its point index, updated:
+ *       FLT *MinDist2, UINT32 *MinIndex;
+ * RETURNS: None.
+ */
+static inline VOID TakeNearest( FLT Dist2, UINT32 Index, FLT *MinDist2, UINT32 *MinIndex )
+{
+  // Indices are compared signed, so no point (0xFFFFFFFF) is never replaced on equal distance
+  if (Dist2 < *MinDist2 || (Dist2 == *MinDist2 && (INT)Index < (INT)*MinIndex))
+    *MinDist2 = Dist2, *MinIndex = Index;
+} /* End of 'TakeNearest' function */
+
+/* Find nearest point among points array, scalar version, function.
+ * ARGUMENTS: see 'simd::NearestPoint'.
+ * RETURNS: None.
+ */
+static VOID NearestPointScalar( const FLT *X, const FLT *Y, const UINT32 *Indices, size_t Count,
+                                FLT Px, FLT Py, FLT *MinDist2, UINT32 *MinIndex )
+{
+  for (size_t i = 0; i < Count; i++)
+  {
+    FLT dx = Px - X[i], dy = Py - Y[i];
+
+    TakeNearest(dx * dx + dy * dy, Indices[i], MinDist2, MinIndex);
+  }
+} /* End of 'NearestPointScalar' function */
+
+/* Count set bits in lanes mask function.
+ * ARGUMENTS:
+ *   - mask:
+ *       UINT32 Mask;
+ * RETURNS:
+ *   (size_t) count of set bits.
+ */
+static inline size_t CountBits( UINT32 Mask )
+{
+  size_t cnt = 0;
+
+  for (; Mask != 0; Mask &= Mask - 1)
+    cnt++;
+  return cnt;
+} /* End of 'CountBits' function */
+
+/* Intersect query segment with block segment exactly function.
+ * ARGUMENTS:
+ *   - query segment points:
+ *       FLT Ax, FLT Ay, FLT Bx, FLT By;
+ *   - block segment points:
+ *       FLT X0, FLT Y0, FLT X1, FLT Y1;
+ *   - query plays segment (TRUE) or line (FALSE) flag:
+ *       BOOL IsQuerySegment;
+ *   - variable to set intersection point in:
+ *       vec2 *Result;
+ * RETURNS:
+ *   (BOOL) whether segments intersect.
+ */
+static inline BOOL IntersectPair( FLT Ax, FLT Ay, FLT Bx, FLT By, FLT X0, FLT Y0, FLT X1, FLT Y1,
+                                  BOOL IsQuerySegment, vec2 *Result )
+{
+  if (IsQuerySegment)
+    return predicates::Intersect(vec2(Ax, Ay), vec2(Bx, By), vec2(X0, Y0), vec2(X1, Y1), Result);
+  return predicates::Intersect(vec2(X0, Y0), vec2(X1, Y1), vec2(Ax, Ay), vec2(Bx, By), Result);
+} /* End of 'IntersectPair' function */
+
+/* Intersect one segment with block of segments, scalar version, function.
+ * ARGUMENTS: see 'simd::IntersectSegments'.
+ * RETURNS:
+ *   (size_t) count of intersecting pairs.
+ */
+static size_t IntersectSegmentsScalar( FLT Ax, FLT Ay, FLT Bx, FLT By, BOOL IsQuerySegment,
+                                       const FLT *X0, const FLT *Y0, const FLT *X1, const FLT *Y1, size_t Count,
+                                       UINT32 *Hits, FLT *Rx, FLT *Ry )
+{
+  size_t hits = 0;
+
+  for (size_t i = 0; i < Count; i++)
+  {
+    vec2 res;
+
+    if (IntersectPair(Ax, Ay, Bx, By, X0[i], Y0[i], X1[i], Y1[i], IsQuerySegment, &res))
+    {
+      Hits[i / 32] |= 1u << (i % 32), hits++;
+      if (Rx != nullptr)
+        Rx[i] = res[0], Ry[i] = res[1];
+    }
+  }
+  return hits;
+} /* End of 'IntersectSegmentsScalar' function */
+
+/* Resolve pairs, which lanes can not classify, exactly function.
+ * ARGUMENTS: see 'simd::IntersectSegments', and
+ *   - first pair of lanes block and lanes mask of pairs to resolve:
+ *       size_t First, UINT32 Mask;
+ * RETURNS:
+ *   (UINT32) lanes mask of intersecting pairs among resolved ones.
+ */
+static UINT32 ResolvePairs( FLT Ax, FLT Ay, FLT Bx, FLT By, BOOL IsQuerySegment,
+                            const FLT *X0, const FLT *Y0, const FLT *X1, const FLT *Y1,
+                            FLT *Rx, FLT *Ry, size_t First, UINT32 Mask )
+{
+  UINT32 hits = 0;
+
+  for (INT lane = 0; Mask != 0; lane++, Mask >>= 1)
+  {
+    size_t i = First + lane;
+    vec2 res;
+
+    if ((Mask & 1) && IntersectPair(Ax, Ay, Bx, By, X0[i], Y0[i], X1[i], Y1[i], IsQuerySegment, &res))
+    {
+      hits |= 1u << lane;
+      if (Rx != nullptr)
+        Rx[i] = res[0], Ry[i] = res[1];
+    }
+  }
+  return hits;
+} /* End of 'ResolvePairs' function */
+
+#ifdef SIMD_X86
+/* Find nearest point among points array, SSE2 version (4 points per step), function.
+ * ARGUMENTS: see 'simd::NearestPoint'.
+ * RETURNS: None.
+ */
+SIMD_TARGET_SSE2 static VOID NearestPointSse2( const FLT *X, const FLT *Y, const UINT32 *Indices, size_t Count,
+                                               FLT Px, FLT Py, FLT *MinDist2, UINT32 *MinIndex )
+{
+  size_t i = 0;
+
+  if (Count >= 4)
+  {
+    __m128 px = _mm_set1_ps(Px), py = _mm_set1_ps(Py), min_dist2 = _mm_set1_ps(*MinDist2);
+    __m128i min_index = _mm_set1_epi32((INT)*MinIndex);
+
+    for (; i + 4 <= Count; i += 4)
+    {
+      __m128
+        dx = _mm_sub_ps(px, _mm_loadu_ps(X + i)),
+        dy = _mm_sub_ps(py, _mm_loadu_ps(Y + i)),
+        dist2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+      __m128i index = _mm_loadu_si128((const __m128i *)(Indices + i));
+
+      // Lanes, where point is nearer, or as near and has lower index
+      __m128i take = _mm_or_si128(_mm_castps_si128(_mm_cmplt_ps(dist2, min_dist2)),
+                                  _mm_and_si128(_mm_castps_si128(_mm_cmpeq_ps(dist2, min_dist2)),
+                                                _mm_cmplt_epi32(index, min_index)));
+
+      min_dist2 = _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(take), dist2), _mm_andnot_ps(_mm_castsi128_ps(take), min_dist2));
+      min_index = _mm_or_si128(_mm_and_si128(take, index), _mm_andnot_si128(take, min_index));
+    }
+
+    // Horizontal minimum
+    FLT lane_dist2[4];
+    UINT32 lane_index[4];
+    _mm_storeu_ps(lane_dist2, min_dist2);
+    _mm_storeu_si128((__m128i *)lane_index, min_index);
+    for (INT lane = 0; lane < 4; lane++)
+      TakeNearest(lane_dist2[lane], lane_index[lane], MinDist2, MinIndex);
+  }
+  NearestPointScalar(X + i, Y + i, Indices + i, Count - i, Px, Py, MinDist2, MinIndex);
+} /* End of 'NearestPointSse2' function */
+
+/* Find nearest point among points array, AVX2 version (8 points per step), function.
+ * ARGUMENTS: see 'simd::NearestPoint'.
+ * RETURNS: None.
+ */
+SIMD_TARGET_AVX2 static VOID NearestPointAvx2( const FLT *X, const FLT *Y, const UINT32 *Indices, size_t Count,
+                                               FLT Px, FLT Py, FLT *MinDist2, UINT32 *MinIndex )
+{
+  size_t i = 0;
+
+  if (Count >= 8)
+  {
+    __m256 px = _mm256_set1_ps(Px), py = _mm256_set1_ps(Py), min_dist2 = _mm256_set1_ps(*MinDist2);
+    __m256i min_index = _mm256_set1_epi32((INT)*MinIndex);
+
+    for (; i + 8 <= Count; i += 8)
+    {
+      // No FMA: distances have to be rounded as in scalar version
+      __m256
+        dx = _mm256_sub_ps(px, _mm256_loadu_ps(X + i)),
+        dy = _mm256_sub_ps(py, _mm256_loadu_ps(Y + i)),
+        dist2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+      __m256i index = _mm256_loadu_si256((const __m256i *)(Indices + i));
+
+      __m256i take = _mm256_or_si256(_mm256_castps_si256(_mm256_cmp_ps(dist2, min_dist2, _CMP_LT_OQ)),
+                                     _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(dist2, min_dist2, _CMP_EQ_OQ)),
+                                                      _mm256_cmpgt_epi32(min_index, index)));
+
+      min_dist2 = _mm256_blendv_ps(min_dist2, dist2, _mm256_castsi256_ps(take));
+      min_index = _mm256_blendv_epi8(min_index, index, take);
+    }
+
+    FLT lane_dist2[8];
+    UINT32 lane_index[8];
+    _mm256_storeu_ps(lane_dist2, min_dist2);
+    _mm256_storeu_si256((__m256i *)lane_index, min_index);
+    for (INT lane = 0; lane < 8; lane++)
+      TakeNearest(lane_dist2[lane], lane_index[lane], MinDist2, MinIndex);
+  }
+  NearestPointScalar(X + i, Y + i, Indices + i, Count - i, Px, Py, MinDist2, MinIndex);
+} /* End of 'NearestPointAvx2' function */
+
+/* Get certain signs of four orientations, SSE2 version, function.
+ * ARGUMENTS:
+ *   - points (orientation of C relative to line A, B):
+ *       __m128 Ax, __m128 Ay, __m128 Bx, __m128 By, __m128 Cx, __m128 Cy;
+ *   - lanes, where orientation is certainly positive or negative:
+ *       __m128 *Pos, __m128 *Neg;
+ * RETURNS: None.
+ */
+SIMD_TARGET_SSE2 static inline VOID OrientSse2( __m128 Ax, __m128 Ay, __m128 Bx, __m128 By, __m128 Cx, __m128 Cy,
+                                                __m128 *Pos, __m128 *Neg )
+{
+  __m128
+    det_left = _mm_mul_ps(_mm_sub_ps(Ax, Cx), _mm_sub_ps(By, Cy)),
+    det_right = _mm_mul_ps(_mm_sub_ps(Ay, Cy), _mm_sub_ps(Bx, Cx)),
+    det = _mm_sub_ps(det_left, det_right),
+    abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)),
+    err_bound = _mm_max_ps(_mm_mul_ps(_mm_set1_ps(OrientErrBound),
+                                     _mm_add_ps(_mm_and_ps(det_left, abs_mask), _mm_and_ps(det_right, abs_mask))),
+                           _mm_set1_ps(OrientMin));
+
+  *Pos = _mm_cmpgt_ps(det, err_bound);
+  *Neg = _mm_cmplt_ps(det, _mm_sub_ps(_mm_setzero_ps(), err_bound));
+} /* End of 'OrientSse2' function */
+
+/* Intersect one segment with block of segments, SSE2 version (4 pairs per step), function.
+ * ARGUMENTS: see 'simd::IntersectSegments'.
+ * RETURNS:
+ *   (size_t) count of intersecting pairs.
+ */
+template<BOOL IsQuerySegment>
+SIMD_TARGET_SSE2 static size_t IntersectSegmentsSse2( FLT Ax, FLT Ay, FLT Bx, FLT By,
+                                                      const FLT *X0, const FLT *Y0, const FLT *X1, const FLT *Y1, size_t Count,
+                                                      UINT32 *Hits, FLT *Rx, FLT *Ry )
+{
+  size_t i = 0, hits = 0;
+  __m128
+    ax = _mm_set1_ps(Ax), ay = _mm_set1_ps(Ay), bx = _mm_set1_ps(Bx), by = _mm_set1_ps(By),
+    zero = _mm_setzero_ps(), one = _mm_set1_ps(1);
+
+  for (; i + 4 <= Count; i += 4)
+  {
+    __m128
+      x0 = _mm_loadu_ps(X0 + i), y0 = _mm_loadu_ps(Y0 + i), x1 = _mm_loadu_ps(X1 + i), y1 = _mm_loadu_ps(Y1 + i),
+      sx0 = IsQuerySegment ? ax : x0, sy0 = IsQuerySegment ? ay : y0, sx1 = IsQuerySegment ? bx : x1, sy1 = IsQuerySegment ? by : y1,
+      lx0 = IsQuerySegment ? x0 : ax, ly0 = IsQuerySegment ? y0 : ay, lx1 = IsQuerySegment ? x1 : bx, ly1 = IsQuerySegment ? y1 : by,
+      st_pos, st_neg, end_pos, end_neg, p0_pos, p0_neg, p1_pos, p1_neg;
+
+    OrientSse2(lx0, ly0, lx1, ly1, sx0, sy0, &st_pos, &st_neg);
+    OrientSse2(lx0, ly0, lx1, ly1, sx1, sy1, &end_pos, &end_neg);
+    OrientSse2(sx0, sy0, sx1, sy1, lx0, ly0, &p0_pos, &p0_neg);
+    OrientSse2(sx0, sy0, sx1, sy1, lx1, ly1, &p1_pos, &p1_neg);
+
+    // Some segment certainly lies on one side of another, or segments certainly cross
+    __m128
+      is_miss = _mm_or_ps(_mm_or_ps(_mm_and_ps(st_pos, end_pos), _mm_and_ps(st_neg, end_neg)),
+                          _mm_or_ps(_mm_and_ps(p0_pos, p1_pos), _mm_and_ps(p0_neg, p1_neg))),
+      is_cross = _mm_and_ps(_mm_or_ps(_mm_and_ps(st_pos, end_neg), _mm_and_ps(st_neg, end_pos)),
+                            _mm_or_ps(_mm_and_ps(p0_pos, p1_neg), _mm_and_ps(p0_neg, p1_pos)));
+    UINT32
+      hit = (UINT32)_mm_movemask_ps(is_cross),
+      unknown = ((UINT32)_mm_movemask_ps(is_miss) | hit) ^ 0xF;
+
+    // Crossing points are computed as 'predicates::GetCrossing' does
+    if (hit != 0 && Rx != nullptr)
+    {
+      __m128
+        a = _mm_sub_ps(lx0, lx1), b = _mm_sub_ps(sy0, sy1), c = _mm_sub_ps(ly0, ly1), d = _mm_sub_ps(sx0, sx1),
+        e = _mm_sub_ps(lx0, sx0), f = _mm_sub_ps(ly0, sy0),
+        div = _mm_sub_ps(_mm_mul_ps(a, b), _mm_mul_ps(c, d)),
+        t = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(e, b), _mm_mul_ps(f, d)), div);
+
+      t = _mm_min_ps(_mm_max_ps(t, zero), one);
+      _mm_storeu_ps(Rx + i, _mm_add_ps(lx0, _mm_mul_ps(_mm_sub_ps(lx1, lx0), t)));
+      _mm_storeu_ps(Ry + i, _mm_add_ps(ly0, _mm_mul_ps(_mm_sub_ps(ly1, ly0), t)));
+    }
+    if (unknown != 0)
+      hit |= ResolvePairs(Ax, Ay, Bx, By, IsQuerySegment, X0, Y0, X1, Y1, Rx, Ry, i, unknown);
+    if (hit != 0)
+      Hits[i / 32] |= hit << (i % 32), hits += CountBits(hit);
+  }
+
+  // Tail
+  if (i < Count)
+  {
+    UINT32 hit = ResolvePairs(Ax, Ay, Bx, By, IsQuerySegment, X0, Y0, X1, Y1, Rx, Ry, i, (1u << (Count - i)) - 1);
+
+    Hits[i / 32] |= hit << (i % 32), hits += CountBits(hit);
+  }
+  return hits;
+} /* End of 'IntersectSegmentsSse2' function */
+
+/* Get certain signs of four orientations, AVX2 version, function.
+ * ARGUMENTS:
+ *   - points (orientation of C relative to line A, B):
+ *       __m256 Ax, __m256 Ay, __m256 Bx, __m256 By, __m256 Cx, __m256 Cy;
+ *   - lanes, where orientation is certainly positive or negative:
+ *       __m256 *Pos, __m256 *Neg;
+ * RETURNS: None.
+ */
+SIMD_TARGET_AVX2 static inline VOID OrientAvx2( __m256 Ax, __m256 Ay, __m256 Bx, __m256 By, __m256 Cx, __m256 Cy,
+                                                __m256 *Pos, __m256 *Neg )
+{
+  __m256
+    det_left = _mm256_mul_ps(_mm256_sub_ps(Ax, Cx), _mm256_sub_ps(By, Cy)),
+    det_right = _mm256_mul_ps(_mm256_sub_ps(Ay, Cy), _mm256_sub_ps(Bx, Cx)),
+    det = _mm256_sub_ps(det_left, det_right),
+    abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)),
+    err_bound = _mm256_max_ps(_mm256_mul_ps(_mm256_set1_ps(OrientErrBound),
+                                     _mm256_add_ps(_mm256_and_ps(det_left, abs_mask), _mm256_and_ps(det_right, abs_mask))),
+                           _mm256_set1_ps(OrientMin));
+
+  *Pos = _mm256_cmp_ps(det, err_bound, _CMP_GT_OQ);
+  *Neg = _mm256_cmp_ps(det, _mm256_sub_ps(_mm256_setzero_ps(), err_bound), _CMP_LT_OQ);
+} /* End of 'OrientAvx2' function */
+
+/* Intersect one segment with block of segments, AVX2 version (8 pairs per step), function.
+ * ARGUMENTS: see 'simd::IntersectSegments'.
+ * RETURNS:
+ *   (size_t) count of intersecting pairs.
+ */
+template<BOOL IsQuerySegment>
+SIMD_TARGET_AVX2 static size_t IntersectSegmentsAvx2( FLT Ax, FLT Ay, FLT Bx, FLT By,
+                                                      const FLT *X0, const FLT *Y0, const FLT *X1, const FLT *Y1, size_t Count,
+                                                      UINT32 *Hits, FLT *Rx, FLT *Ry )
+{
+  size_t i = 0, hits = 0;
+  __m256
+    ax = _mm256_set1_ps(Ax), ay = _mm256_set1_ps(Ay), bx = _mm256_set1_ps(Bx), by = _mm256_set1_ps(By),
+    zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1);
+
+  for (; i + 8 <= Count; i += 8)
+  {
+    __m256
+      x0 = _mm256_loadu_ps(X0 + i), y0 = _mm256_loadu_ps(Y0 + i), x1 = _mm256_loadu_ps(X1 + i), y1 = _mm256_loadu_ps(Y1 + i),
+      sx0 = IsQuerySegment ? ax : x0, sy0 = IsQuerySegment ? ay : y0, sx1 = IsQuerySegment ? bx : x1, sy1 = IsQuerySegment ? by : y1,
+      lx0 = IsQuerySegment ? x0 : ax, ly0 = IsQuerySegment ? y0 : ay, lx1 = IsQuerySegment ? x1 : bx, ly1 = IsQuerySegment ? y1 : by,
+      st_pos, st_neg, end_pos, end_neg, p0_pos, p0_neg, p1_pos, p1_neg;
+
+    OrientAvx2(lx0, ly0, lx1, ly1, sx0, sy0, &st_pos, &st_neg);
+    OrientAvx2(lx0, ly0, lx1, ly1, sx1, sy1, &end_pos, &end_neg);
+    OrientAvx2(sx0, sy0, sx1, sy1, lx0, ly0, &p0_pos, &p0_neg);
+    OrientAvx2(sx0, sy0, sx1, sy1, lx1, ly1, &p1_pos, &p1_neg);
+
+    // Some segment certainly lies on one side of another, or segments certainly cross
+    __m256
+      is_miss = _mm256_or_ps(_mm256_or_ps(_mm256_and_ps(st_pos, end_pos), _mm256_and_ps(st_neg, end_neg)),
+                          _mm256_or_ps(_mm256_and_ps(p0_pos, p1_pos), _mm256_and_ps(p0_neg, p1_neg))),
+      is_cross = _mm256_and_ps(_mm256_or_ps(_mm256_and_ps(st_pos, end_neg), _mm256_and_ps(st_neg, end_pos)),
+                            _mm256_or_ps(_mm256_and_ps(p0_pos, p1_neg), _mm256_and_ps(p0_neg, p1_pos)));
+    UINT32
+      hit = (UINT32)_mm256_movemask_ps(is_cross),
+      unknown = ((UINT32)_mm256_movemask_ps(is_miss) | hit) ^ 0xFF;
+
+    // Crossing points are computed as 'predicates::GetCrossing' does
+    if (hit != 0 && Rx != nullptr)
+    {
+      __m256
+        a = _mm256_sub_ps(lx0, lx1), b = _mm256_sub_ps(sy0, sy1), c = _mm256_sub_ps(ly0, ly1), d = _mm256_sub_ps(sx0, sx1),
+        e = _mm256_sub_ps(lx0, sx0), f = _mm256_sub_ps(ly0, sy0),
+        div = _mm256_sub_ps(_mm256_mul_ps(a, b), _mm256_mul_ps(c, d)),
+        t = _mm256_div_ps(_mm256_sub_ps(_mm256_mul_ps(e, b), _mm256_mul_ps(f, d)), div);
+
+      t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+      _mm256_storeu_ps(Rx + i, _mm256_add_ps(lx0, _mm256_mul_ps(_mm256_sub_ps(lx1, lx0), t)));
+      _mm256_storeu_ps(Ry + i, _mm256_add_ps(ly0, _mm256_mul_ps(_mm256_sub_ps(ly1, ly0), t)));
+    }
+    if (unknown != 0)
+      hit |= ResolvePairs(Ax, Ay, Bx, By, IsQuerySegment, X0, Y0, X1, Y1, Rx, Ry, i, unknown);
+    if (hit != 0)
+      Hits[i / 32] |= hit << (i % 32), hits += CountBits(hit);
+  }
+
+  // Tail
+  if (i < Count)
+  {
+    UINT32 hit = ResolvePairs(Ax, Ay, Bx, By, IsQuerySegment, X0, Y0, X1, Y1, Rx, Ry, i, (1u << (Count - i)) - 1);
+
+    Hits[i / 32] |= hit << (i % 32), hits += CountBits(hit);
+  }
+  return hits;
+} /* End of 'IntersectSegmentsAvx2' function */
+#endif /* SIMD_X86 */
+
+/* Find nearest point among points array function.
+ * Squared distances are computed in FLT. Point is taken if its distance is less than current
+ * minimum, or equal to it and point index is less than current index.
+ * ARGUMENTS:
+ *   - points coordinates:
+ *       const FLT *X, const FLT *Y;
+ *   - points indices (less than 2^31):
+ *       const UINT32 *Indices;
+ *   - points count:
+ *       size_t Count;
+ *   - point to find nearest to:
+ *       FLT Px, FLT Py;
+ *   - current minimal squared distance and its point index (0xFFFFFFFF if none), updated:
+ *       FLT *MinDist2, UINT32 *MinIndex;
+ * RETURNS: None.
+ */
+VOID simd::NearestPoint( const FLT *X, const FLT *Y, const UINT32 *Indices, size_t Count,
+                         FLT Px, FLT Py, FLT *MinDist2, UINT32 *MinIndex )
+{
+#ifdef SIMD_X86
+  switch (GetLevel())
+  {
+  case LevelAvx2:
+    NearestPointAvx2(X, Y, Indices, Count, Px, Py, MinDist2, MinIndex);
+    return;
+  case LevelSse2:
+    NearestPointSse2(X, Y, Indices, Count, Px, Py, MinDist2, MinIndex);
+    return;
+  }
+#endif /* SIMD_X86 */
+  NearestPointScalar(X, Y, Indices, Count, Px, Py, MinDist2, MinIndex);
+} /* End of 'simd::NearestPoint' function */
+
+/* Intersect one segment with block of segments function.
+ * Every pair is checked as 'predicates::Intersect' does: one segment of pair plays segment
+ * (St, End), another plays line segment (P0, P1). Lanes classify pairs by orientation signs
+ * with FLT error bounds, only pairs they can not classify are checked exactly,
+ * so results are equal to 'predicates::Intersect' ones.
+ * ARGUMENTS:
+ *   - query segment points:
+ *       FLT Ax, FLT Ay, FLT Bx, FLT By;
+ *   - query plays segment (TRUE) or line (FALSE) flag:
+ *       BOOL IsQuerySegment;
+ *   - block segments points (structure of arrays):
+ *       const FLT *X0, const FLT *Y0, const FLT *X1, const FLT *Y1;
+ *   - block segments count:
+ *       size_t Count;
+ *   - hits bitmask, bit i of word i / 32 is set if pair intersects ((Count + 31) / 32 words):
+ *       UINT32 *Hits;
+ *   - intersection points, set for intersecting pairs only (may be nullptr):
+ *       FLT *Rx, FLT *Ry;
+ * RETURNS:
+ *   (size_t) count of intersecting pairs.
+ */
+size_t simd::IntersectSegments( FLT Ax, FLT Ay, FLT Bx, FLT By, BOOL IsQuerySegment,
+                                const FLT *X0, const FLT *Y0, const FLT *X1, const FLT *Y1, size_t Count,
+                                UINT32 *Hits, FLT *Rx, FLT *Ry )
+{
+  std::fill(Hits, Hits + (Count + 31) / 32, 0);
+  if (Rx == nullptr || Ry == nullptr)
+    Rx = Ry = nullptr;
+
+#ifdef SIMD_X86
+  switch (GetLevel())
+  {
+  case LevelAvx2:
+    return IsQuerySegment ?
+      IntersectSegmentsAvx2<TRUE>(Ax, Ay, Bx, By, X0, Y0, X1, Y1, Count, Hits, Rx, Ry) :
+      IntersectSegmentsAvx2<FALSE>(Ax, Ay, Bx, By, X0, Y0, X1, Y1, Count, Hits, Rx, Ry);
+  case LevelSse2:
+    return IsQuerySegment ?
+      IntersectSegmentsSse2<TRUE>(Ax, Ay, Bx, By, X0, Y0, X1, Y1, Count, Hits, Rx, Ry) :
+      IntersectSegmentsSse2<FALSE>(Ax, Ay, Bx, By, X0, Y0, X1, Y1, Count, Hits, Rx, Ry);
+  }
+#endif /* SIMD_X86 */
+  return IntersectSegmentsScalar(Ax, Ay, Bx, By, IsQuerySegment, X0, Y0, X1, Y1, Count, Hits, Rx, Ry);
+} /* End of 'simd::IntersectSegments' function */
@@ -0,0 +1,100 @@
+#ifndef __location_simd_h_
+#define __location_simd_h_
+
+#include <atomic>
+
+#include "../def.h"
+
+/* Vectorized location kernels class.
+ * Every kernel has scalar, SSE2 and AVX2 versions, the widest one supported by processor
+ * is chosen at runtime. All versions give equal results.
+ */
+class simd
+{
+public:
+  // Instruction set levels
+  static const INT LevelScalar = 0, LevelSse2 = 1, LevelAvx2 = 2;
+
+private:
+  static std::atomic<INT> Level; // Used instruction set level (-1 if not detected yet), kernels run from many threads
+
+  /* Detect best instruction set level supported by processor and OS function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (INT) instruction set level.
+   */
+  static INT Detect( VOID );
+
+public:
+  /* Get used instruction set level function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (INT) instruction set level.
+   */
+  static INT GetLevel( VOID )
+  {
+    INT level = Level.load(std::memory_order_relaxed);
+
+    // Detection gives the same level in every thread
+    if (level < 0)
+      Level.store(level = Detect(), std::memory_order_relaxed);
+    return level;
+  } /* End of 'GetLevel' function */
+
+  /* Limit used instruction set level function (for tests and benchmarks).
+   * ARGUMENTS:
+   *   - level to use, clamped to supported one:
+   *       INT NewLevel;
+   * RETURNS: None.
+   */
+  static VOID SetLevel( INT NewLevel )
+  {
+    Level = mth::Clamp(NewLevel, LevelScalar, Detect());
+  } /* End of 'SetLevel' function */
+
+  /* Find nearest point among points array function.
+   * Squared distances are computed in FLT. Point is taken if its distance is less than current
+   * minimum, or equal to it and point index is less than current index.
+   * ARGUMENTS:
+   *   - points coordinates:
+   *       const FLT *X, const FLT *Y;
+   *   - points indices (less than 2^31):
+   *       const UINT32 *Indices;
+   *   - points count:
+   *       size_t Count;
+   *   - point to find nearest to:
+   *       FLT Px, FLT Py;
+   *   - current minimal squared distance and its point index (0xFFFFFFFF if none), updated:
+   *       FLT *MinDist2, UINT32 *MinIndex;
+   * RETURNS: None.
+   */
+  static VOID NearestPoint( const FLT *X, const FLT *Y, const UINT32 *Indices, size_t Count,
+                            FLT Px, FLT Py, FLT *MinDist2, UINT32 *MinIndex );
+
+  /* Intersect one segment with block of segments function.
+   * Every pair is checked as 'predicates::Intersect' does: one segment of pair plays segment
+   * (St, End), another plays line segment (P0, P1). Lanes classify pairs by orientation signs
+   * with FLT error bounds, only pairs they can not classify are checked exactly,
+   * so results are equal to 'predicates::Intersect' ones.
+   * ARGUMENTS:
+   *   - query segment points:
+   *       FLT Ax, FLT Ay, FLT Bx, FLT By;
+   *   - query plays segment (TRUE) or line (FALSE) flag:
+   *       BOOL IsQuerySegment;
+   *   - block segments points (structure of arrays):
+   *       const FLT *X0, const FLT *Y0, const FLT *X1, const FLT *Y1;
+   *   - block segments count:
+   *       size_t Count;
+   *   - hits bitmask, bit i of word i / 32 is set if pair intersects ((Count + 31) / 32 words):
+   *       UINT32 *Hits;
+   *   - intersection points, set for intersecting pairs only (may be nullptr):
+   *       FLT *Rx, FLT *Ry;
+   * RETURNS:
+   *   (size_t) count of intersecting pairs.
+   */
+  static size_t IntersectSegments( FLT Ax, FLT Ay, FLT Bx, FLT By, BOOL IsQuerySegment,
+                                   const FLT *X0, const FLT *Y0, const FLT *X1, const FLT *Y1, size_t Count,
+                                   UINT32 *Hits, FLT *Rx = nullptr, FLT *Ry = nullptr );
+}; /* end of 'simd' class */
+
+#endif /* __location_simd_h_ */
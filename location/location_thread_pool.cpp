@@ -0,0 +1,300 @@
+#include "location_thread_pool.h"
+
+// Pool and deque slot of current thread (pool is nullptr outside of pools)
+static thread_local thread_pool *CurrentPool = nullptr;
+static thread_local size_t CurrentSlot = 0;
+
+/* Graph run state structure. */
+struct thread_pool::run
+{
+  const task_graph &Graph;                        // Running graph
+  std::unique_ptr<std::atomic<size_t>[]> Pending; // Not done dependencies count of every task
+  std::atomic<size_t> Remaining;                  // Not done tasks count
+
+  /* Graph run state constructor.
+   * ARGUMENTS:
+   *   - graph to run:
+   *       const task_graph &Graph;
+   */
+  run( const task_graph &Graph ) :
+    Graph(Graph), Pending(new std::atomic<size_t>[Graph.Tasks.size()]), Remaining(Graph.Tasks.size())
+  {
+    for (size_t i = 0; i < Graph.Tasks.size(); i++)
+      Pending[i] = Graph.Tasks[i].DepsCount;
+  } /* End of 'run' function */
+}; /* end of 'run' struct */
+
+/* Add task function.
+ * ARGUMENTS:
+ *   - task function:
+ *       const std::function<VOID( VOID )> &Func;
+ *   - indexes of (already added) tasks to run after:
+ *       const std::vector<size_t> &Deps;
+ * RETURNS:
+ *   (size_t) index of added task.
+ */
+size_t task_graph::Add( const std::function<VOID( VOID )> &Func, const std::vector<size_t> &Deps )
+{
+  size_t index = Tasks.size();
+
+  Tasks.push_back(task());
+  Tasks.back().Func = Func;
+  for (size_t dep : Deps)
+    Depend(index, dep);
+  return index;
+} /* End of 'task_graph::Add' function */
+
+/* Add dependency between tasks function.
+ * ARGUMENTS:
+ *   - index of task to run after another:
+ *       size_t Task;
+ *   - index of task to run before (graph should stay acyclic):
+ *       size_t Dep;
+ * RETURNS: None.
+ */
+VOID task_graph::Depend( size_t Task, size_t Dep )
+{
+  Tasks[Dep].Next.push_back(Task);
+  Tasks[Task].DepsCount++;
+} /* End of 'task_graph::Depend' function */
+
+/* Threads pool constructor.
+ * ARGUMENTS:
+ *   - threads count (calling thread included, 0 - hardware threads count):
+ *       size_t ThreadsCount;
+ */
+thread_pool::thread_pool( size_t ThreadsCount ) :
+  ThreadsCount(ThreadsCount != 0 ? ThreadsCount : mth::Max<size_t>(std::thread::hardware_concurrency(), 1)),
+  Queues(new worker_queue[this->ThreadsCount])
+{
+} /* End of 'thread_pool::thread_pool' function */
+
+/* Threads pool destructor. */
+thread_pool::~thread_pool( VOID )
+{
+  {
+    std::lock_guard<std::mutex> lock(SleepMutex);
+    IsStopping = TRUE;
+  }
+  Wake.notify_all();
+  for (std::thread &worker : Workers)
+    worker.join();
+} /* End of 'thread_pool::~thread_pool' function */
+
+/* Push ready task to thread deque function.
+ * ARGUMENTS:
+ *   - thread slot:
+ *       size_t Slot;
+ *   - task to push:
+ *       const job &Job;
+ * RETURNS: None.
+ */
+VOID thread_pool::Push( size_t Slot, const job &Job )
+{
+  {
+    std::lock_guard<std::mutex> lock(Queues[Slot].Mutex);
+    Queues[Slot].Jobs.push_back(Job);
+    Queued++;
+  }
+
+  // Sleeping threads count is increased before checking queued tasks count, so signal is not lost
+  if (Sleeping > 0)
+  {
+    std::lock_guard<std::mutex> lock(SleepMutex);
+    Wake.notify_one();
+  }
+} /* End of 'thread_pool::Push' function */
+
+/* Take ready task function.
+ * Own deque back is taken first, then other deques fronts are stolen.
+ * ARGUMENTS:
+ *   - thread slot:
+ *       size_t Slot;
+ *   - variable to set taken task in:
+ *       job *Job;
+ * RETURNS:
+ *   (BOOL) whether task taken.
+ */
+BOOL thread_pool::Pop( size_t Slot, job *Job )
+{
+  for (size_t i = 0; i < ThreadsCount && Queued > 0; i++)
+  {
+    worker_queue &queue = Queues[(Slot + i) % ThreadsCount];
+    std::lock_guard<std::mutex> lock(queue.Mutex);
+
+    if (queue.Jobs.empty())
+      continue;
+    if (i == 0)
+      *Job = queue.Jobs.back(), queue.Jobs.pop_back();
+    else
+      *Job = queue.Jobs.front(), queue.Jobs.pop_front();
+    Queued--;
+    return TRUE;
+  }
+  return FALSE;
+} /* End of 'thread_pool::Pop' function */
+
+/* Run task and push tasks made ready by it function.
+ * ARGUMENTS:
+ *   - thread slot:
+ *       size_t Slot;
+ *   - task to run:
+ *       const job &Job;
+ * RETURNS: None.
+ */
+VOID thread_pool::Execute( size_t Slot, const job &Job )
+{
+  const task_graph::task &task = Job.Run->Graph.Tasks[Job.Task];
+
+  task.Func();
+  for (size_t next : task.Next)
+    if (--Job.Run->Pending[next] == 0)
+      Push(Slot, {Job.Run, next});
+
+  // Run state may be destroyed by waiting thread right after last task is counted
+  if (--Job.Run->Remaining == 0)
+  {
+    std::lock_guard<std::mutex> lock(SleepMutex);
+    Wake.notify_all();
+  }
+} /* End of 'thread_pool::Execute' function */
+
+/* Worker thread function.
+ * ARGUMENTS:
+ *   - worker slot:
+ *       size_t Slot;
+ * RETURNS: None.
+ */
+VOID thread_pool::Work( size_t Slot )
+{
+  CurrentPool = this;
+  CurrentSlot = Slot;
+
+  for (;;)
+  {
+    job taken;
+
+    if (Pop(Slot, &taken))
+    {
+      Execute(Slot, taken);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(SleepMutex);
+    Sleeping++;
+    Wake.wait(lock, [&]( VOID ){ return IsStopping || Queued > 0; });
+    Sleeping--;
+    if (IsStopping)
+      return;
+  }
+} /* End of 'thread_pool::Work' function */
+
+/* Run tasks graph function.
+ * Function returns after all tasks are done, it may be called by several threads at once.
+ * ARGUMENTS:
+ *   - graph to run:
+ *       const task_graph &Graph;
+ * RETURNS: None.
+ */
+VOID thread_pool::Run( const task_graph &Graph )
+{
+  size_t count = Graph.Tasks.size();
+
+  if (count == 0)
+    return;
+
+  // Single thread or task of another pool: tasks run in calling thread in dependencies order
+  if (ThreadsCount == 1 || (CurrentPool != nullptr && CurrentPool != this))
+  {
+    std::vector<size_t> pending(count), ready;
+
+    for (size_t i = count; i > 0; i--)
+      if ((pending[i - 1] = Graph.Tasks[i - 1].DepsCount) == 0)
+        ready.push_back(i - 1);
+    while (!ready.empty())
+    {
+      const task_graph::task &task = Graph.Tasks[ready.back()];
+
+      ready.pop_back();
+      task.Func();
+      for (size_t next : task.Next)
+        if (--pending[next] == 0)
+          ready.push_back(next);
+    }
+    return;
+  }
+
+  // Threads outside pool take their shared slot, workers are started on first run.
+  // Waiting thread runs tasks of any graph, so several outside threads help each other
+  BOOL is_outside = CurrentPool == nullptr;
+
+  if (is_outside)
+  {
+    std::call_once(WorkersStart, [this]( VOID )
+      {
+        for (size_t i = 1; i < ThreadsCount; i++)
+          Workers.emplace_back(&thread_pool::Work, this, i);
+      });
+    CurrentPool = this;
+    CurrentSlot = 0;
+  }
+
+  size_t slot = CurrentSlot;
+  run state(Graph);
+
+  for (size_t i = 0; i < count; i++)
+    if (Graph.Tasks[i].DepsCount == 0)
+      Push(slot, {&state, i});
+
+  // Waiting thread runs tasks (of any graph) while there are some
+  while (state.Remaining > 0)
+  {
+    job taken;
+
+    if (Pop(slot, &taken))
+    {
+      Execute(slot, taken);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(SleepMutex);
+    Sleeping++;
+    Wake.wait(lock, [&]( VOID ){ return state.Remaining == 0 || Queued > 0; });
+    Sleeping--;
+  }
+
+  if (is_outside)
+    CurrentPool = nullptr;
+} /* End of 'thread_pool::Run' function */
+
+/* Run parallel loop function.
+ * Loop is run as graph of independent tasks (one per thread), taking items one by one,
+ * so items of different cost are balanced.
+ * Function returns after all items are done.
+ * ARGUMENTS:
+ *   - items count:
+ *       size_t Count;
+ *   - item function (called with item index, concurrently for different items):
+ *       const std::function<VOID( size_t )> &Func;
+ * RETURNS: None.
+ */
+VOID thread_pool::For( size_t Count, const std::function<VOID( size_t )> &Func )
+{
+  if (Count <= 1 || ThreadsCount == 1)
+  {
+    for (size_t i = 0; i < Count; i++)
+      Func(i);
+    return;
+  }
+
+  std::atomic<size_t> next {0};
+  task_graph graph;
+
+  for (size_t i = 0, cnt = mth::Min(Count, ThreadsCount); i < cnt; i++)
+    graph.Add([&]( VOID )
+      {
+        for (size_t item = next++; item < Count; item = next++)
+          Func(item);
+      });
+  Run(graph);
+} /* End of 'thread_pool::For' function */
@@ -0,0 +1,203 @@
+#ifndef __location_thread_pool_h_
+#define __location_thread_pool_h_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "../def.h"
+
+/* Tasks graph class.
+ * Every task runs after all tasks it depends on are done,
+ * tasks without dependencies between them may run concurrently.
+ * Graph is built once and may be run by threads pool many times.
+ */
+class task_graph
+{
+private:
+  friend class thread_pool;
+
+  /* Task structure. */
+  struct task
+  {
+    std::function<VOID( VOID )> Func; // Task function
+    std::vector<size_t> Next;         // Tasks depending on this one
+    size_t DepsCount = 0;             // Count of tasks this one depends on
+  }; /* end of 'task' struct */
+
+  std::vector<task> Tasks; // Graph tasks
+
+public:
+  /* Add task function.
+   * ARGUMENTS:
+   *   - task function:
+   *       const std::function<VOID( VOID )> &Func;
+   *   - indexes of (already added) tasks to run after:
+   *       const std::vector<size_t> &Deps;
+   * RETURNS:
+   *   (size_t) index of added task.
+   */
+  size_t Add( const std::function<VOID( VOID )> &Func, const std::vector<size_t> &Deps = {} );
+
+  /* Add dependency between tasks function.
+   * ARGUMENTS:
+   *   - index of task to run after another:
+   *       size_t Task;
+   *   - index of task to run before (graph should stay acyclic):
+   *       size_t Dep;
+   * RETURNS: None.
+   */
+  VOID Depend( size_t Task, size_t Dep );
+
+  /* Get tasks count function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (size_t) tasks count.
+   */
+  size_t Size( VOID ) const
+  {
+    return Tasks.size();
+  } /* End of 'Size' function */
+
+  /* Clear graph function.
+   * ARGUMENTS: None.
+   * RETURNS: None.
+   */
+  VOID Clear( VOID )
+  {
+    Tasks.clear();
+  } /* End of 'Clear' function */
+}; /* end of 'task_graph' class */
+
+/* Work-stealing threads pool class.
+ * Every thread has own tasks deque: ready tasks are pushed to deque of thread which made them ready
+ * and are taken from its back, so dependent tasks run on the same thread while its data is in cache.
+ * Threads without tasks steal them from front of other threads deques.
+ * Workers are started on first run, thread waiting for graph end runs tasks too.
+ * Threads outside pool may run graphs concurrently, they share one deque slot.
+ * Graphs started from tasks of the same pool run by all its threads, graphs started from tasks
+ * of another pool run in calling thread.
+ */
+class thread_pool
+{
+private:
+  struct run; // Graph run state
+
+  /* Ready task structure. */
+  struct job
+  {
+    run *Run;    // Run task belongs to
+    size_t Task; // Task index in run graph
+  }; /* end of 'job' struct */
+
+  /* Thread tasks deque structure. */
+  struct worker_queue
+  {
+    std::mutex Mutex;     // Deque guard
+    std::deque<job> Jobs; // Ready tasks
+  }; /* end of 'worker_queue' struct */
+
+  size_t ThreadsCount;                    // Threads count (calling thread included)
+  std::vector<std::thread> Workers;       // Worker threads
+  std::unique_ptr<worker_queue[]> Queues; // Threads deques (0 - threads outside pool, others - workers)
+
+  std::once_flag WorkersStart;            // Workers are started once by first run
+  std::mutex SleepMutex;                  // Sleeping guard
+  std::condition_variable Wake;           // Signals sleeping threads about new tasks, run end or stopping
+  std::atomic<size_t> Queued {0};         // Tasks in all deques
+  std::atomic<size_t> Sleeping {0};       // Threads waiting for signal
+  BOOL IsStopping = FALSE;                // Whether pool is destroying (guarded by 'SleepMutex')
+
+  /* Push ready task to thread deque function.
+   * ARGUMENTS:
+   *   - thread slot:
+   *       size_t Slot;
+   *   - task to push:
+   *       const job &Job;
+   * RETURNS: None.
+   */
+  VOID Push( size_t Slot, const job &Job );
+
+  /* Take ready task function.
+   * Own deque back is taken first, then other deques fronts are stolen.
+   * ARGUMENTS:
+   *   - thread slot:
+   *       size_t Slot;
+   *   - variable to set taken task in:
+   *       job *Job;
+   * RETURNS:
+   *   (BOOL) whether task taken.
+   */
+  BOOL Pop( size_t Slot, job *Job );
+
+  /* Run task and push tasks made ready by it function.
+   * ARGUMENTS:
+   *   - thread slot:
+   *       size_t Slot;
+   *   - task to run:
+   *       const job &Job;
+   * RETURNS: None.
+   */
+  VOID Execute( size_t Slot, const job &Job );
+
+  /* Worker thread function.
+   * ARGUMENTS:
+   *   - worker slot:
+   *       size_t Slot;
+   * RETURNS: None.
+   */
+  VOID Work( size_t Slot );
+
+public:
+  /* Threads pool constructor.
+   * ARGUMENTS:
+   *   - threads count (calling thread included, 0 - hardware threads count):
+   *       size_t ThreadsCount;
+   */
+  thread_pool( size_t ThreadsCount = 0 );
+
+  /* Threads pool copying is not allowed (threads are owned). */
+  thread_pool( const thread_pool & ) = delete;
+  thread_pool &operator=( const thread_pool & ) = delete;
+
+  /* Threads pool destructor. */
+  ~thread_pool( VOID );
+
+  /* Get threads count function.
+   * ARGUMENTS: None.
+   * RETURNS:
+   *   (size_t) threads count (calling thread included).
+   */
+  size_t GetThreadsCount( VOID ) const
+  {
+    return ThreadsCount;
+  } /* End of 'GetThreadsCount' function */
+
+  /* Run tasks graph function.
+   * Function returns after all tasks are done, it may be called by several threads at once.
+   * ARGUMENTS:
+   *   - graph to run:
+   *       const task_graph &Graph;
+   * RETURNS: None.
+   */
+  VOID Run( const task_graph &Graph );
+
+  /* Run parallel loop function.
+   * Loop is run as graph of independent tasks (one per thread), taking items one by one,
+   * so items of different cost are balanced.
+   * Function returns after all items are done.
+   * ARGUMENTS:
+   *   - items count:
+   *       size_t Count;
+   *   - item function (called with item index, concurrently for different items):
+   *       const std::function<VOID( size_t )> &Func;
+   * RETURNS: None.
+   */
+  VOID For( size_t Count, const std::function<VOID( size_t )> &Func );
+}; /* end of 'thread_pool' class */
+
+#endif /* __location_thread_pool_h_ */
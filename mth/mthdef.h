@@ -8,7 +8,25 @@
 #define __mthdef_h_
 
 #include <cmath>
+
+#ifdef _WIN32
 #include <Windows.h>
+#else /* _WIN32 */
+#include <cstdint>
+
+// Windows base types for other platforms
+#define VOID void
+typedef int INT;
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef unsigned int UINT;
+typedef uint32_t UINT32;
+typedef int64_t INT64;
+typedef uint64_t UINT64;
+
+#define TRUE 1
+#define FALSE 0
+#endif /* _WIN32 */
 
 typedef double DBL;
 typedef float FLT;